@@ -0,0 +1,534 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file Archive.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Archive of the database of past seasons
+*
+* A wipe moves the database file to a timestamped archive and starts with a fresh file, so the wipe does
+* not depend on the size of the table. The archives get compacted and compressed by a background thread.
+* The compression of the file system is used, so an archive stays readable by sqlite without unpacking.
+* Other systems than Windows keep the archives uncompressed.
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "Archive.h"
+#include "SlotCooldown.h"
+#include "Shutdown.h"
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+#include <sqlite3.h>
+#include <algorithm>
+#include <condition_variable>
+#include <ctime>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
+
+namespace Archive
+{
+    /* ========================================== [local defines] =============================================== */
+
+    /** \brief max time to wait for a lock of an archive in milliseconds */
+    #define BUSY_TIMEOUT_MS 100
+
+    /** \brief number of virtual machine instructions between two checks of the shutdown deadline */
+    #define PROGRESS_INTERVAL 10000
+
+    /** \brief first schema version that stores the slot cooldowns as 64 bit unix times */
+    #define ARCHIVE_SLOTS_EXPIRY_VERSION 4
+
+    /** \brief part of the file name between the name of the database and the timestamp, backups use an other one */
+    #define ARCHIVE_FILE_TAG "_Archive_"
+
+
+    /* =============================================== [local data] =============================================== */
+
+    /** \brief path of the database */
+    static std::filesystem::path DatabaseFile;
+
+    /** \brief directory of the archives */
+    static std::filesystem::path ArchiveDirectory;
+
+    /** \brief true if the archive thread is running */
+    static bool IsRunning = false;
+
+    /** \brief true if the archive thread has to stop */
+    static bool StopArchive = false;
+
+    /** \brief archives waiting for the compaction */
+    static std::deque<std::filesystem::path> PendingArchives;
+
+    /** \brief protects the queue of the archive thread */
+    static std::mutex ArchiveMutex;
+
+    /** \brief wakes up the archive thread */
+    static std::condition_variable ArchiveCondition;
+
+    /** \brief thread that compacts the archives */
+    static std::thread ArchiveThread;
+
+
+    /* ===================================== [prototype of local functions] ======================================= */
+
+    static std::string GetTimestamp(void);
+    static bool IsArchiveFile(const std::filesystem::path& File);
+    static bool IsCompressed(const std::filesystem::path& File);
+    static int ProgressHandler(void* Context);
+    static bool CompactArchive(const std::filesystem::path& File);
+    static bool CompressArchive(const std::filesystem::path& File);
+    static void QueueArchive(const std::filesystem::path& File);
+    static void ArchiveLoop(void);
+
+
+    /* ===================================== [definition of local functions] ====================================== */
+
+    /**
+    * \brief Gets a timestamp for the name of an archive
+    *
+    * The time is in UTC, the timestamps sort in the order of creation
+    *
+    * \return std::string the timestamp
+    */
+    static std::string GetTimestamp(void)
+    {
+        char buffer[32] = { 0 };
+        std::time_t now = std::time(nullptr);
+
+        std::strftime(buffer, sizeof(buffer), "%Y%m%dT%H%M%SZ", std::gmtime(&now));
+
+        return buffer;
+    }
+
+
+    /**
+    * \brief Checks if a file is an archive of the database
+    *
+    * \param[in] File the file to check
+    * \return bool true if the file is an archive
+    */
+    static bool IsArchiveFile(const std::filesystem::path& File)
+    {
+        const std::string prefix = DatabaseFile.stem().u8string() + ARCHIVE_FILE_TAG;
+
+        return (0 == File.filename().u8string().rfind(prefix, 0)) && (File.extension() == DatabaseFile.extension());
+    }
+
+
+    /**
+    * \brief Checks if a file is compressed by the file system
+    *
+    * \param[in] File the file to check
+    * \return bool true if the file is compressed
+    */
+    static bool IsCompressed(const std::filesystem::path& File)
+    {
+#ifdef _WIN32
+        DWORD attributes = GetFileAttributesW(File.wstring().c_str());
+
+        return (INVALID_FILE_ATTRIBUTES != attributes) && (0 != (attributes & FILE_ATTRIBUTE_COMPRESSED));
+#else
+        (void)File;
+
+        return false;
+#endif
+    }
+
+
+    /**
+    * \brief Progress handler of the compaction
+    *
+    * \param[in] Context variable is not used
+    * \return int non zero to interrupt the compaction at the deadline of the shutdown
+    */
+    static int ProgressHandler(void*)
+    {
+        return (true == Shutdown::IsDeadlineExceeded()) ? 1 : 0;
+    }
+
+
+    /**
+    * \brief Compacts an archive
+    *
+    * This function rebuilds the archive without free pages and switches it to a rollback journal, so it 
+    * is a single file without WAL
+    *
+    * \param[in] File the archive
+    * \return bool true if the archive was compacted
+    */
+    static bool CompactArchive(const std::filesystem::path& File)
+    {
+        bool result = false;
+        sqlite3* archive = nullptr;
+        char* error = nullptr;
+
+        if (SQLITE_OK == sqlite3_open_v2(File.u8string().c_str(), &archive, SQLITE_OPEN_READWRITE, nullptr))
+        {
+            sqlite3_busy_timeout(archive, BUSY_TIMEOUT_MS);
+            sqlite3_progress_handler(archive, PROGRESS_INTERVAL, &ProgressHandler, nullptr);
+            result = (SQLITE_OK == sqlite3_exec(archive, "PRAGMA journal_mode=DELETE; VACUUM;", nullptr, nullptr, &error));
+        }
+
+        if ((false == result) && (true == Shutdown::IsDeadlineExceeded()))
+        {
+            Shutdown::ReportPending("Archive", 1, "running compaction");
+        }
+        else if (false == result)
+        {
+            Log::GetLog()->error("Archive {} could not be compacted: {}", File.filename().u8string(),
+                (nullptr != error) ? error : ((nullptr != archive) ? sqlite3_errmsg(archive) : ""));
+        }
+
+        sqlite3_free(error);
+        sqlite3_close(archive);
+
+        return result;
+    }
+
+
+    /**
+    * \brief Compresses an archive
+    *
+    * This function enables the compression of the file system for the archive, other systems than Windows 
+    * skip it
+    *
+    * \param[in] File the archive
+    * \return bool true if the archive is compressed
+    */
+    static bool CompressArchive(const std::filesystem::path& File)
+    {
+#ifdef _WIN32
+        BOOL result = FALSE;
+        USHORT format = COMPRESSION_FORMAT_DEFAULT;
+        DWORD returned = 0;
+        HANDLE file = CreateFileW(File.wstring().c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, 0, nullptr);
+
+        if (INVALID_HANDLE_VALUE != file)
+        {
+            result = DeviceIoControl(file, FSCTL_SET_COMPRESSION, &format, sizeof(format), nullptr, 0, &returned, nullptr);
+            CloseHandle(file);
+        }
+
+        if (FALSE == result)
+        {
+            Log::GetLog()->warn("Archive {} could not be compressed: error {}", File.filename().u8string(), GetLastError());
+        }
+
+        return (FALSE != result);
+#else
+        (void)File;
+
+        return true;
+#endif
+    }
+
+
+    /**
+    * \brief Queues an archive for the compaction
+    *
+    * \param[in] File the archive
+    * \return void
+    */
+    static void QueueArchive(const std::filesystem::path& File)
+    {
+        {
+            std::lock_guard<std::mutex> lock(ArchiveMutex);
+            PendingArchives.push_back(File);
+        }
+        ArchiveCondition.notify_one();
+    }
+
+
+    /**
+    * \brief Main loop of the archive thread
+    *
+    * This function compacts and compresses the queued archives until the thread gets stopped
+    *
+    * \return void
+    */
+    static void ArchiveLoop(void)
+    {
+        std::unique_lock<std::mutex> lock(ArchiveMutex);
+
+        while (false == StopArchive)
+        {
+            ArchiveCondition.wait(lock, [] { return (true == StopArchive) || (false == PendingArchives.empty()); });
+
+            if (false == StopArchive)
+            {
+                std::filesystem::path file = PendingArchives.front();
+                PendingArchives.pop_front();
+                lock.unlock();
+
+                if ((true == CompactArchive(file)) && (true == CompressArchive(file)))
+                {
+                    Log::GetLog()->info("Archive {} compacted", file.filename().u8string());
+                }
+
+                lock.lock();
+            }
+        }
+
+        if (false == PendingArchives.empty())
+        {
+            Log::GetLog()->info("Archive: {} archives get compacted with the next start", PendingArchives.size());
+        }
+    }
+
+
+    /* ===================================== [definition of global functions] ===================================== */
+
+    /**
+    * \brief Initialisation of the archive
+    *
+    * Archives that were not compacted before the last shutdown get queued again
+    *
+    * \param[in] Enabled true if a wipe archives the database, otherwise the rows get deleted
+    * \param[in] DatabasePath path of the database
+    * \param[in] Directory directory of the archives, if empty an Archives directory next to the database is used
+    * \return void
+    */
+    void InitArchive(bool Enabled, const std::string& DatabasePath, const std::string& Directory)
+    {
+        std::error_code error;
+
+        if ((false == Enabled) || (true == IsRunning))
+        {
+            return;
+        }
+
+        DatabaseFile = std::filesystem::u8path(DatabasePath);
+        ArchiveDirectory = (true == Directory.empty()) ? (DatabaseFile.parent_path() / "Archives") : std::filesystem::u8path(Directory);
+
+        StopArchive = false;
+        PendingArchives.clear();
+
+        for (const auto& entry : std::filesystem::directory_iterator(ArchiveDirectory, error))
+        {
+            if ((true == entry.is_regular_file(error)) && (true == IsArchiveFile(entry.path())) && (false == IsCompressed(entry.path())))
+            {
+                PendingArchives.push_back(entry.path());
+            }
+        }
+
+        ArchiveThread = std::thread(&ArchiveLoop);
+        IsRunning = true;
+    }
+
+
+    /**
+    * \brief Remove of the archive
+    *
+    * This function stops the archive thread after the running compaction, queued archives are compacted with 
+    * the next start
+    *
+    * \return void
+    */
+    void RemoveArchive(void)
+    {
+        if (false == IsRunning)
+        {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(ArchiveMutex);
+            StopArchive = true;
+        }
+        ArchiveCondition.notify_one();
+
+        ArchiveThread.join();
+        IsRunning = false;
+    }
+
+
+    /**
+    * \brief Archives the database
+    *
+    * This function moves the database to a timestamped archive and continues with an empty database. The 
+    * archive gets compacted in the background.
+    *
+    * \return bool true if the database was archived, false if the archive is disabled or not possible
+    */
+    bool ArchiveDatabase(void)
+    {
+        std::error_code error;
+        std::filesystem::path target;
+
+        if ((false == IsRunning) || (nullptr == SlotCooldown::database))
+        {
+            return false;
+        }
+
+        target = ArchiveDirectory / 
+            std::filesystem::u8path(DatabaseFile.stem().u8string() + ARCHIVE_FILE_TAG + GetTimestamp() + DatabaseFile.extension().u8string());
+
+        std::filesystem::create_directories(ArchiveDirectory, error);
+
+        if ((true == std::filesystem::exists(target, error)) || (false == SlotCooldown::database->ArchiveDatabase(target.u8string())))
+        {
+            return false;
+        }
+
+        Log::GetLog()->info("Database archived to {}", target.u8string());
+        QueueArchive(target);
+
+        return true;
+    }
+
+
+    /**
+    * \brief Lists the archives
+    *
+    * \param[out] Archives the archives sorted by age, the oldest first
+    * \return void
+    */
+    void ListArchives(std::vector<ArchiveInfo_t>* Archives)
+    {
+        std::error_code error;
+
+        if ((nullptr == Archives) || (false == IsRunning))
+        {
+            return;
+        }
+
+        Archives->clear();
+
+        for (const auto& entry : std::filesystem::directory_iterator(ArchiveDirectory, error))
+        {
+            if ((true == entry.is_regular_file(error)) && (true == IsArchiveFile(entry.path())))
+            {
+                Archives->push_back({ entry.path().filename().u8string(), (uint64_t)entry.file_size(error), IsCompressed(entry.path()) });
+            }
+        }
+
+        std::sort(Archives->begin(), Archives->end(), [](const ArchiveInfo_t& a, const ArchiveInfo_t& b) { return a.name < b.name; });
+    }
+
+
+    /**
+    * \brief Queries the slot cooldowns of a tribe in an archive
+    *
+    * The archive is opened read only. Only names returned by ListArchives are accepted.
+    *
+    * \param[in] Name file name of the archive
+    * \param[in] TribeId the tribe to look for
+    * \param[out] SlotsTimer the stored slot cooldowns of the tribe
+    * \return QueryResult_t QueryOk on success, otherwise the error
+    */
+    QueryResult_t QueryArchive(const std::string& Name, int TribeId, std::vector<int64_t>* SlotsTimer)
+    {
+        std::vector<ArchiveInfo_t> archives;
+        QueryResult_t result = QueryTribeNotFound;
+
+        ListArchives(&archives);
+
+        if ((nullptr == SlotsTimer) || 
+            (archives.end() == std::find_if(archives.begin(), archives.end(), [&](const ArchiveInfo_t& a) { return a.name == Name; })))
+        {
+            return QueryArchiveNotFound;
+        }
+
+        try
+        {
+            sqlite::sqlite_config config;
+            config.flags = sqlite::OpenFlags::READONLY;
+
+            sqlite::database archive((ArchiveDirectory / std::filesystem::u8path(Name)).u8string(), config);
+            sqlite3_busy_timeout(archive.connection().get(), BUSY_TIMEOUT_MS);
+
+            int schemaVersion = 0;
+
+            archive << "PRAGMA user_version;" >> schemaVersion;
+
+            /* archives taken before schema version 4 only have the 32 bit slot cooldowns */
+            if (ARCHIVE_SLOTS_EXPIRY_VERSION > schemaVersion)
+            {
+                archive << "SELECT 1, SlotsTimer, NULL FROM TribeSlots WHERE TribeId = ?;" << TribeId
+                    >> [&](int IsLegacy, std::vector<int> LegacySlots, std::vector<int64_t> SlotsExpiry)
+                {
+                    DBHandler::DecodeSlots(IsLegacy, LegacySlots, &SlotsExpiry);
+                    *SlotsTimer = std::move(SlotsExpiry);
+                    result = QueryOk;
+                };
+            }
+            else
+            {
+                archive << "SELECT " DB_SLOTS_COLUMNS " FROM TribeSlots WHERE TribeId = ?;" << TribeId
+                    >> [&](int IsLegacy, std::vector<int> LegacySlots, std::vector<int64_t> SlotsExpiry)
+                {
+                    DBHandler::DecodeSlots(IsLegacy, LegacySlots, &SlotsExpiry);
+                    *SlotsTimer = std::move(SlotsExpiry);
+                    result = QueryOk;
+                };
+            }
+        }
+        catch (const sqlite::sqlite_exception& exception)
+        {
+            Log::GetLog()->error("({} {}) Unexpected DB error {}", __FILE__, __FUNCTION__, exception.what());
+            result = QueryFailed;
+        }
+
+        return result;
+    }
+
+
+    /**
+    * \brief Gets the name of a query result
+    *
+    * \param[in] Result the query result
+    * \return const char* the name of the result
+    */
+    const char* GetQueryResultName(QueryResult_t Result)
+    {
+        const char* name;
+
+        switch (Result)
+        {
+        case QueryOk:
+            name = "Ok";
+            break;
+        case QueryArchiveNotFound:
+            name = "ArchiveNotFound";
+            break;
+        case QueryTribeNotFound:
+            name = "TribeNotFound";
+            break;
+        case QueryFailed:
+            name = "QueryFailed";
+            break;
+        default:
+            name = "UndefinedError";
+            break;
+        }
+
+        return name;
+    }
+}
+
+/* =================================================[end of file]================================================= */
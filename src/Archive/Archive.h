@@ -0,0 +1,80 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file Archive.h
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Archive of the database of past seasons
+*
+*/
+
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+/* ================================================[includes]================================================ */
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace Archive
+{
+    /* ================================================[declaration of public types]============================= */
+
+    /**
+    *  \brief archived database of a past season
+    */
+    typedef struct
+    {
+        std::string name;       /**< \brief file name of the archive */
+        uint64_t size;          /**< \brief size of the file in bytes */
+        bool isCompacted;       /**< \brief true if the archive is compacted and compressed */
+
+    }ArchiveInfo_t;
+
+
+    /**
+    *  \brief result of a query of an archive
+    */
+    typedef enum
+    {
+        QueryOk = 0,            /**< \brief tribe found in the archive */
+        QueryArchiveNotFound,   /**< \brief archive does not exist */
+        QueryTribeNotFound,     /**< \brief tribe does not exist in the archive */
+        QueryFailed             /**< \brief archive could not be read */
+
+    }QueryResult_t;
+
+
+    /* ================================================[declaration of public functions]========================= */
+
+    extern void InitArchive(bool Enabled, const std::string& DatabasePath, const std::string& Directory);
+    extern void RemoveArchive();
+    extern bool ArchiveDatabase();
+    extern void ListArchives(std::vector<ArchiveInfo_t>* Archives);
+    extern QueryResult_t QueryArchive(const std::string& Name, int TribeId, std::vector<int64_t>* SlotsTimer);
+    extern const char* GetQueryResultName(QueryResult_t Result);
+}
+
+
+#endif /* ARCHIVE_H */
+
+/* =================================================[end of file]================================================= */
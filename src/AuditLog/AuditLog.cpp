@@ -0,0 +1,405 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file AuditLog.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Append-only log of the tribe slot decisions
+*
+* The game thread writes the records into a lock-free single producer single consumer ring buffer. 
+* A background thread flushes the buffer to segment files and starts a new segment when the current one
+* exceeds the configured size. If the buffer is full the record gets dropped, the game thread never waits.
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "AuditLog.h"
+#include "Shutdown.h"
+#include "API/ARK/Ark.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace AuditLog
+{
+    /* ========================================== [local defines] =============================================== */
+
+    /** \brief number of records in the ring buffer, has to be a power of two */
+    #define RING_BUFFER_SIZE 8192
+
+    /** \brief interval in which the ring buffer gets flushed in milliseconds */
+    #define FLUSH_INTERVAL_MS 500
+
+
+    /* =============================================== [local data] =============================================== */
+
+    /** \brief ring buffer with the records */
+    static AuditRecord_t RingBuffer[RING_BUFFER_SIZE];
+
+    /** \brief number of written records, only written by the game thread */
+    static std::atomic<size_t> RingHead(0);
+
+    /** \brief number of flushed records, only written by the flush thread */
+    static std::atomic<size_t> RingTail(0);
+
+    /** \brief number of dropped records because the ring buffer was full */
+    static std::atomic<uint64_t> DroppedRecords(0);
+
+    /** \brief time of the last record, keeps the records in ascending order if the clock is adjusted */
+    static int64_t LastRecordTime = 0;
+
+    /** \brief true if the audit log is running */
+    static bool IsRunning = false;
+
+    /** \brief directory of the segments */
+    static std::filesystem::path SegmentDirectory;
+
+    /** \brief max size of a segment in bytes */
+    static size_t MaxSegmentSize = 0;
+
+    /** \brief number of kept segments, 0 keeps all */
+    static int MaxNumOfSegments = 0;
+
+    /** \brief current segment */
+    static std::ofstream Segment;
+
+    /** \brief size of the current segment in bytes */
+    static size_t SegmentSize = 0;
+
+    /** \brief true if the flush thread has to stop */
+    static bool StopFlush = false;
+
+    /** \brief protects StopFlush */
+    static std::mutex FlushMutex;
+
+    /** \brief wakes up the flush thread */
+    static std::condition_variable FlushCondition;
+
+    /** \brief thread that flushes the ring buffer */
+    static std::thread FlushThread;
+
+
+    /* ===================================== [prototype of local functions] ======================================= */
+
+    static bool OpenSegment(int64_t FirstRecordTime);
+    static void CloseSegment(void);
+    static void RemoveOldSegments(void);
+    static void WriteRecord(const AuditRecord_t& Record);
+    static void FlushRingBuffer(void);
+    static void FlushLoop(void);
+
+
+    /* ===================================== [definition of local functions] ====================================== */
+
+    /**
+    * \brief Opens a new segment
+    *
+    * A segment with the same name can only contain records of the same millisecond, so it is continued
+    * without breaking the time order.
+    *
+    * \param[in] FirstRecordTime time of the first record of the segment
+    * \return bool true on success
+    */
+    static bool OpenSegment(int64_t FirstRecordTime)
+    {
+        const AuditSegmentHeader_t header = { AUDIT_SEGMENT_MAGIC, AUDIT_SEGMENT_VERSION, sizeof(AuditRecord_t) };
+        const std::filesystem::path path = SegmentDirectory / GetSegmentName(FirstRecordTime);
+        std::error_code error;
+
+        std::filesystem::create_directories(SegmentDirectory, error);
+        SegmentSize = (size_t)std::filesystem::file_size(path, error);
+        if (error)
+        {
+            SegmentSize = 0;
+        }
+
+        Segment.open(path, std::ios::binary | std::ios::app);
+
+        if (false == Segment.is_open())
+        {
+            Log::GetLog()->error("AuditLog: could not open segment in {}", SegmentDirectory.u8string());
+            return false;
+        }
+
+        if (0 == SegmentSize)
+        {
+            Segment.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            SegmentSize = sizeof(header);
+        }
+
+        return true;
+    }
+
+
+    /**
+    * \brief Closes the current segment
+    *
+    * \return void
+    */
+    static void CloseSegment(void)
+    {
+        if (true == Segment.is_open())
+        {
+            Segment.close();
+            RemoveOldSegments();
+        }
+    }
+
+
+    /**
+    * \brief Removes old segments
+    *
+    * This function removes the oldest segments exceeding the configured number of segments
+    *
+    * \return void
+    */
+    static void RemoveOldSegments(void)
+    {
+        std::vector<std::filesystem::path> segments;
+        std::error_code error;
+        int64_t firstRecordTime;
+
+        if (0 >= MaxNumOfSegments)
+        {
+            return;
+        }
+
+        for (const auto& entry : std::filesystem::directory_iterator(SegmentDirectory, error))
+        {
+            if (true == ParseSegmentName(entry.path().filename().u8string(), &firstRecordTime))
+            {
+                segments.push_back(entry.path());
+            }
+        }
+
+        if (segments.size() > (size_t)MaxNumOfSegments)
+        {
+            std::sort(segments.begin(), segments.end());
+
+            for (size_t i = 0; i < (segments.size() - (size_t)MaxNumOfSegments); i++)
+            {
+                std::filesystem::remove(segments[i], error);
+            }
+        }
+    }
+
+
+    /**
+    * \brief Writes a record to the current segment
+    *
+    * This function starts a new segment if the current one is full
+    *
+    * \param[in] Record the record
+    * \return void
+    */
+    static void WriteRecord(const AuditRecord_t& Record)
+    {
+        if ((true == Segment.is_open()) && ((SegmentSize + sizeof(Record)) > MaxSegmentSize))
+        {
+            CloseSegment();
+        }
+
+        if ((true == Segment.is_open()) || (true == OpenSegment(Record.time)))
+        {
+            Segment.write(reinterpret_cast<const char*>(&Record), sizeof(Record));
+            SegmentSize += sizeof(Record);
+        }
+    }
+
+
+    /**
+    * \brief Flushes the ring buffer to the segments
+    *
+    * The records left at the deadline of the shutdown get dropped
+    *
+    * \return void
+    */
+    static void FlushRingBuffer(void)
+    {
+        static uint64_t reportedDroppedRecords = 0;
+        size_t tail = RingTail.load(std::memory_order_relaxed);
+        const size_t head = RingHead.load(std::memory_order_acquire);
+        const uint64_t droppedRecords = DroppedRecords.load(std::memory_order_relaxed);
+
+        if (tail != head)
+        {
+            for (; (tail != head) && (false == Shutdown::IsDeadlineExceeded()); tail++)
+            {
+                WriteRecord(RingBuffer[tail & (RING_BUFFER_SIZE - 1)]);
+            }
+
+            if (tail != head)
+            {
+                Shutdown::ReportPending("AuditLog", head - tail, "records");
+                tail = head;
+            }
+
+            RingTail.store(tail, std::memory_order_release);
+            Segment.flush();
+        }
+
+        if (droppedRecords != reportedDroppedRecords)
+        {
+            Log::GetLog()->warn("AuditLog: {} records dropped, the buffer was full", droppedRecords - reportedDroppedRecords);
+            reportedDroppedRecords = droppedRecords;
+        }
+    }
+
+
+    /**
+    * \brief Main loop of the flush thread
+    *
+    * \return void
+    */
+    static void FlushLoop(void)
+    {
+        std::unique_lock<std::mutex> lock(FlushMutex);
+
+        while (false == StopFlush)
+        {
+            FlushCondition.wait_for(lock, std::chrono::milliseconds(FLUSH_INTERVAL_MS), [] { return StopFlush; });
+
+            lock.unlock();
+            FlushRingBuffer();
+            lock.lock();
+        }
+
+        /* records of the last interval, the loop is skipped if the audit log is removed right after the start */
+        lock.unlock();
+        FlushRingBuffer();
+        CloseSegment();
+    }
+
+
+    /* ===================================== [definition of global functions] ===================================== */
+
+    /**
+    * \brief Initialisation of the audit log
+    *
+    * \param[in] Enabled true if the decisions get recorded
+    * \param[in] Directory directory of the segments, if empty the AuditLog directory of the plugin is used
+    * \param[in] SegmentSizeKB max size of a segment in kilobytes
+    * \param[in] MaxSegments number of kept segments, 0 keeps all
+    * \return void
+    */
+    void InitAuditLog(bool Enabled, const std::string& Directory, int SegmentSizeKB, int MaxSegments)
+    {
+        if ((false == Enabled) || (true == IsRunning))
+        {
+            return;
+        }
+
+        SegmentDirectory = std::filesystem::u8path((true == Directory.empty()) ? 
+            ArkApi::Tools::GetCurrentDir() + "/ArkApi/Plugins/TribeSlotCooldown/AuditLog" : Directory);
+        MaxSegmentSize = sizeof(AuditSegmentHeader_t) + (std::max)((size_t)(std::max)(SegmentSizeKB, 0) * 1024, sizeof(AuditRecord_t));
+        MaxNumOfSegments = MaxSegments;
+        StopFlush = false;
+
+        FlushThread = std::thread(&FlushLoop);
+        IsRunning = true;
+    }
+
+
+    /**
+    * \brief Remove of the audit log
+    *
+    * This function flushes the remaining records and stops the flush thread
+    *
+    * \return void
+    */
+    void RemoveAuditLog(void)
+    {
+        if (false == IsRunning)
+        {
+            return;
+        }
+
+        IsRunning = false;
+
+        {
+            std::lock_guard<std::mutex> lock(FlushMutex);
+            StopFlush = true;
+        }
+        FlushCondition.notify_one();
+
+        FlushThread.join();
+    }
+
+
+    /**
+    * \brief Records a decision
+    *
+    * This function has to be called from the game thread only
+    *
+    * \param[in] Type kind of the decision
+    * \param[in] Decision outcome of the decision
+    * \param[in] SteamId steam id of the player
+    * \param[in] TribeId id of the tribe
+    * \param[in] OtherTribeId id of the merged tribe for AuditMerge, otherwise 0
+    * \param[in] PlayersInTribe number of players in the tribe(s)
+    * \param[in] SlotsOnCooldown number of slots on cooldown of the tribe(s)
+    * \return void
+    */
+    void Record(AuditType_t Type, AuditDecision_t Decision, uint64_t SteamId, int TribeId, int OtherTribeId, 
+        int PlayersInTribe, int SlotsOnCooldown)
+    {
+        if (false == IsRunning)
+        {
+            return;
+        }
+
+        const size_t head = RingHead.load(std::memory_order_relaxed);
+
+        if ((head - RingTail.load(std::memory_order_acquire)) >= RING_BUFFER_SIZE)
+        {
+            DroppedRecords.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        LastRecordTime = (std::max)(now, LastRecordTime);
+
+        AuditRecord_t& record = RingBuffer[head & (RING_BUFFER_SIZE - 1)];
+        record.time = LastRecordTime;
+        record.steamId = SteamId;
+        record.tribeId = TribeId;
+        record.otherTribeId = OtherTribeId;
+        record.type = (uint8_t)Type;
+        record.decision = (uint8_t)Decision;
+        record.playersInTribe = (uint16_t)(std::min)((std::max)(PlayersInTribe, 0), (int)UINT16_MAX);
+        record.slotsOnCooldown = (uint16_t)(std::min)((std::max)(SlotsOnCooldown, 0), (int)UINT16_MAX);
+        record.reserved = 0;
+
+        RingHead.store(head + 1, std::memory_order_release);
+    }
+}
+
+/* =================================================[end of file]================================================= */
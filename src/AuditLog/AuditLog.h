@@ -0,0 +1,49 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file AuditLog.h
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Append-only log of the tribe slot decisions
+*
+*/
+
+#ifndef AUDITLOG_H
+#define AUDITLOG_H
+
+/* ================================================[includes]================================================ */
+#include "AuditRecord.h"
+
+
+namespace AuditLog
+{
+    /* ================================================[declaration of public functions]========================= */
+
+    extern void InitAuditLog(bool Enabled, const std::string& Directory, int SegmentSizeKB, int MaxSegments);
+    extern void RemoveAuditLog();
+    extern void Record(AuditType_t Type, AuditDecision_t Decision, uint64_t SteamId, int TribeId, int OtherTribeId, 
+        int PlayersInTribe, int SlotsOnCooldown);
+}
+
+
+#endif /* AUDITLOG_H */
+
+/* =================================================[end of file]================================================= */
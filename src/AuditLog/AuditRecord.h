@@ -0,0 +1,260 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file AuditRecord.h
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief File format of the audit log
+*
+* This header is shared by the plugin and the offline reader, it must not depend on the Ark Server API.
+*
+* The audit log is a directory of segment files. Every segment starts with a AuditSegmentHeader_t 
+* followed by fixed-size AuditRecord_t records in ascending time order. The name of a segment contains 
+* the time of its first record, so the segments sort by time as well.
+*
+*/
+
+#ifndef AUDITRECORD_H
+#define AUDITRECORD_H
+
+/* ================================================[includes]================================================ */
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+
+namespace AuditLog
+{
+    /* ================================================[declaration of public defines]=========================== */
+
+    /** \brief magic number at the start of every segment */
+    #define AUDIT_SEGMENT_MAGIC 0x5449445541435354ULL /* "TSCAUDIT" in little endian */
+
+    /** \brief version of the segment format */
+    #define AUDIT_SEGMENT_VERSION 1
+
+    /** \brief prefix of the segment names */
+    #define AUDIT_SEGMENT_PREFIX "Audit_"
+
+    /** \brief extension of the segment names */
+    #define AUDIT_SEGMENT_EXTENSION ".bin"
+
+
+    /* ================================================[declaration of public types]============================= */
+
+    /**
+    *  \brief kind of an audited decision
+    */
+    typedef enum
+    {
+        AuditJoin = 0,      /**< \brief player tried to join a tribe */
+        AuditMerge,         /**< \brief player tried to merge his tribe into an other tribe */
+        AuditLeave,         /**< \brief player left or got kicked from a tribe */
+
+        NumOfAuditTypes     /**< \brief number of types, has to be the last entry */
+
+    }AuditType_t;
+
+
+    /**
+    *  \brief outcome of an audited decision
+    */
+    typedef enum
+    {
+        AuditAllowed = 0,           /**< \brief join or merge allowed */
+        AuditRejected,              /**< \brief join or merge rejected because of slots on cooldown */
+        AuditRejectedRemembered,    /**< \brief join rejected by a remembered rejection */
+        AuditSlotBlocked,           /**< \brief slot of the tribe set on cooldown */
+        AuditSlotNotBlocked,        /**< \brief no cooldown because the player is an admin or the cooldown is not active yet */
+        AuditFallbackAllowed,       /**< \brief join allowed by the fallback policy, the tribe could not be read in time */
+        AuditFallbackRejected,      /**< \brief join rejected by the fallback policy, the tribe could not be read in time */
+        AuditFallbackDeferred,      /**< \brief join deferred by the fallback policy, the player has to retry */
+
+        NumOfAuditDecisions         /**< \brief number of decisions, has to be the last entry */
+
+    }AuditDecision_t;
+
+
+#pragma pack(push, 1)
+
+    /**
+    *  \brief header of a segment
+    */
+    typedef struct
+    {
+        uint64_t magic;             /**< \brief AUDIT_SEGMENT_MAGIC */
+        uint32_t version;           /**< \brief AUDIT_SEGMENT_VERSION */
+        uint32_t recordSize;        /**< \brief size of one record in bytes */
+    }AuditSegmentHeader_t;
+
+
+    /**
+    *  \brief one audited decision
+    */
+    typedef struct
+    {
+        int64_t time;               /**< \brief time of the decision in milliseconds since epoch */
+        uint64_t steamId;           /**< \brief steam id of the player */
+        int32_t tribeId;            /**< \brief id of the tribe */
+        int32_t otherTribeId;       /**< \brief id of the merged tribe for AuditMerge */
+        uint8_t type;               /**< \brief AuditType_t */
+        uint8_t decision;           /**< \brief AuditDecision_t */
+        uint16_t playersInTribe;    /**< \brief number of players in the tribe(s) */
+        uint16_t slotsOnCooldown;   /**< \brief number of slots on cooldown of the tribe(s) */
+        uint16_t reserved;          /**< \brief always 0 */
+    }AuditRecord_t;
+
+#pragma pack(pop)
+
+    static_assert(16 == sizeof(AuditSegmentHeader_t), "the segment header must not change without a new version");
+    static_assert(32 == sizeof(AuditRecord_t), "the record format must not change without a new version");
+
+
+    /* ================================================[definition of public functions]========================== */
+
+    /**
+    * \brief Gets the name of a segment
+    *
+    * \param[in] FirstRecordTime time of the first record of the segment in milliseconds since epoch
+    * \return std::string name of the segment
+    */
+    inline std::string GetSegmentName(int64_t FirstRecordTime)
+    {
+        char buffer[64] = { 0 };
+
+        std::snprintf(buffer, sizeof(buffer), AUDIT_SEGMENT_PREFIX "%016lld" AUDIT_SEGMENT_EXTENSION, (long long)FirstRecordTime);
+
+        return buffer;
+    }
+
+
+    /**
+    * \brief Parses the name of a segment
+    *
+    * \param[in] Name name of the segment
+    * \param[out] FirstRecordTime time of the first record of the segment in milliseconds since epoch
+    * \return bool true if the name is a segment name
+    */
+    inline bool ParseSegmentName(const std::string& Name, int64_t* FirstRecordTime)
+    {
+        long long time = 0;
+        char extension[8] = { 0 };
+
+        if ((2 == std::sscanf(Name.c_str(), AUDIT_SEGMENT_PREFIX "%16lld%7s", &time, extension)) && 
+            (std::string(AUDIT_SEGMENT_EXTENSION) == extension))
+        {
+            *FirstRecordTime = time;
+            return true;
+        }
+
+        return false;
+    }
+
+
+    /**
+    * \brief Gets the name of a type
+    *
+    * \param[in] Type the type
+    * \return const char* name of the type
+    */
+    inline const char* GetTypeName(uint8_t Type)
+    {
+        static const char* names[NumOfAuditTypes] = { "Join", "Merge", "Leave" };
+
+        return (NumOfAuditTypes > Type) ? names[Type] : "Unknown";
+    }
+
+
+    /**
+    * \brief Gets the name of a decision
+    *
+    * \param[in] Decision the decision
+    * \return const char* name of the decision
+    */
+    inline const char* GetDecisionName(uint8_t Decision)
+    {
+        static const char* names[NumOfAuditDecisions] = { "Allowed", "Rejected", "RejectedRemembered", "SlotBlocked", "SlotNotBlocked",
+            "FallbackAllowed", "FallbackRejected", "FallbackDeferred" };
+
+        return (NumOfAuditDecisions > Decision) ? names[Decision] : "Unknown";
+    }
+
+
+    /**
+    * \brief Reads a record of a segment
+    *
+    * The offset is 64 bit, segments larger than 2 GB are read on all platforms
+    *
+    * \param[in] File the segment
+    * \param[in] Index index of the record
+    * \param[out] Record the record
+    * \return bool true on success
+    */
+    inline bool ReadRecord(std::FILE* File, long long Index, AuditRecord_t* Record)
+    {
+        long long offset = (long long)sizeof(AuditSegmentHeader_t) + (Index * (long long)sizeof(AuditRecord_t));
+
+#ifdef _WIN32
+        int result = _fseeki64(File, offset, SEEK_SET);
+#else
+        int result = fseeko(File, (off_t)offset, SEEK_SET);
+#endif
+
+        return (0 == result) && (1 == std::fread(Record, sizeof(*Record), 1, File));
+    }
+
+
+    /**
+    * \brief Finds the first record of a segment not older than a given time
+    *
+    * \param[in] File the segment
+    * \param[in] NumOfRecords number of records in the segment
+    * \param[in] From the time in milliseconds since epoch
+    * \return long long index of the record, NumOfRecords if all records are older
+    */
+    inline long long FindFirstRecord(std::FILE* File, long long NumOfRecords, int64_t From)
+    {
+        long long low = 0;
+        long long high = NumOfRecords;
+        AuditRecord_t record;
+
+        while (low < high)
+        {
+            long long mid = low + ((high - low) / 2);
+
+            if ((true == ReadRecord(File, mid, &record)) && (record.time < From))
+            {
+                low = mid + 1;
+            }
+            else
+            {
+                high = mid;
+            }
+        }
+
+        return low;
+    }
+}
+
+
+#endif /* AUDITRECORD_H */
+
+/* =================================================[end of file]================================================= */
@@ -0,0 +1,456 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file Backup.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Online backup of the database
+*
+* The database gets copied with the sqlite backup api in a background thread. The backup reads from a 
+* snapshot of its own connection, in WAL mode this never blocks the writers of the game thread. The copy
+* is done in small page batches with a short pause between them to keep the disk load low.
+*
+* Every backup is written to a temporary file first and renamed to a timestamped file when it is 
+* complete, so a backup file is never torn. The timestamp has milliseconds and a counter is added if the
+* name is taken anyway, so a backup never replaces an other one. Only the newest backups are kept.
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "Backup.h"
+#include "Shutdown.h"
+#include "API/ARK/Ark.h"
+#include <sqlite3.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace Backup
+{
+    /* ========================================== [local defines] =============================================== */
+
+    /** \brief pause between two page batches in milliseconds */
+    #define STEP_PAUSE_MS 2
+
+    /** \brief max time to wait for a lock of the source database in milliseconds */
+    #define BUSY_TIMEOUT_MS 100
+
+    /** \brief extension of unfinished backups */
+    #define TEMPORARY_EXTENSION ".tmp"
+
+    /** \brief part of the file name between the name of the database and the timestamp, archives use an other one */
+    #define BACKUP_FILE_TAG "_Backup_"
+
+
+    /* =============================================== [local data] =============================================== */
+
+    /** \brief path of the database */
+    static std::filesystem::path DatabaseFile;
+
+    /** \brief directory of the backups */
+    static std::filesystem::path BackupDirectory;
+
+    /** \brief interval of the scheduled backups in minutes, 0 disables the schedule */
+    static int BackupInterval = 0;
+
+    /** \brief number of kept backups, 0 keeps all */
+    static int BackupRetentionCount = 0;
+
+    /** \brief number of pages copied per step */
+    static int BackupPagesPerStep = 0;
+
+    /** \brief true if the backup thread is running */
+    static bool IsRunning = false;
+
+    /** \brief true if a backup was requested */
+    static bool IsBackupRequested = false;
+
+    /** \brief true while a backup is written */
+    static bool IsBackupActive = false;
+
+    /** \brief true if the backup thread has to stop, also aborts a running backup */
+    static std::atomic<bool> StopBackup(false);
+
+    /** \brief protects the flags of the backup thread */
+    static std::mutex BackupMutex;
+
+    /** \brief wakes up the backup thread */
+    static std::condition_variable BackupCondition;
+
+    /** \brief thread that writes the backups */
+    static std::thread BackupThread;
+
+
+    /* ===================================== [prototype of local functions] ======================================= */
+
+    static std::string GetTimestamp(void);
+    static std::filesystem::path GetBackupFile(void);
+    static bool IsBackupAborted(void);
+    static bool CopyDatabase(const std::filesystem::path& Target);
+    static void RemoveOldBackups(void);
+    static void RunBackup(void);
+    static void BackupLoop(void);
+
+
+    /* ===================================== [definition of local functions] ====================================== */
+
+    /**
+    * \brief Gets a timestamp for the name of a backup
+    *
+    * The time is in UTC with milliseconds, the timestamps sort in the order of creation
+    *
+    * \return std::string the timestamp
+    */
+    static std::string GetTimestamp(void)
+    {
+        char buffer[32] = { 0 };
+        const auto now = std::chrono::system_clock::now();
+        const std::time_t seconds = std::chrono::system_clock::to_time_t(now);
+        const int milliseconds = (int)(std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() % 1000);
+        const size_t length = std::strftime(buffer, sizeof(buffer), "%Y%m%dT%H%M%S", std::gmtime(&seconds));
+
+        std::snprintf(buffer + length, sizeof(buffer) - length, "%03dZ", milliseconds);
+
+        return buffer;
+    }
+
+
+    /**
+    * \brief Gets the file of a new backup
+    *
+    * A counter is added to the timestamp if a backup of the same name exists, the rename of the finished 
+    * backup would replace it otherwise
+    *
+    * \return std::filesystem::path the file of the backup
+    */
+    static std::filesystem::path GetBackupFile(void)
+    {
+        const std::string name = DatabaseFile.stem().u8string() + BACKUP_FILE_TAG + GetTimestamp();
+        const std::string extension = DatabaseFile.extension().u8string();
+        std::filesystem::path target = BackupDirectory / std::filesystem::u8path(name + extension);
+        std::error_code error;
+        char counter[16] = { 0 };
+
+        for (int i = 1; true == std::filesystem::exists(target, error); i++)
+        {
+            std::snprintf(counter, sizeof(counter), "_%03d", i);
+            target = BackupDirectory / std::filesystem::u8path(name + counter + extension);
+        }
+
+        return target;
+    }
+
+
+    /**
+    * \brief Checks if the running backup has to be aborted
+    *
+    * A stop aborts the backup at once, on a shutdown the backup may finish until the deadline
+    *
+    * \return bool true if the backup has to be aborted
+    */
+    static bool IsBackupAborted(void)
+    {
+        return (true == StopBackup) && ((false == Shutdown::IsShuttingDown()) || (true == Shutdown::IsDeadlineExceeded()));
+    }
+
+
+    /**
+    * \brief Copies the database
+    *
+    * This function copies the database page batch by page batch. The read transaction on the source keeps
+    * the snapshot stable, so the backup does not restart if the game thread writes in between.
+    *
+    * \param[in] Target the file to write
+    * \return bool true if the database was copied completely
+    */
+    static bool CopyDatabase(const std::filesystem::path& Target)
+    {
+        bool result = false;
+        sqlite3* source = nullptr;
+        sqlite3* destination = nullptr;
+        int rc = SQLITE_ERROR;
+
+        if ((SQLITE_OK == sqlite3_open_v2(DatabaseFile.u8string().c_str(), &source, SQLITE_OPEN_READONLY, nullptr)) &&
+            (SQLITE_OK == sqlite3_open_v2(Target.u8string().c_str(), &destination, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr)))
+        {
+            sqlite3_busy_timeout(source, BUSY_TIMEOUT_MS);
+
+            if (SQLITE_OK == sqlite3_exec(source, "BEGIN; SELECT count(*) FROM sqlite_master;", nullptr, nullptr, nullptr))
+            {
+                sqlite3_backup* backup = sqlite3_backup_init(destination, "main", source, "main");
+
+                if (nullptr != backup)
+                {
+                    do
+                    {
+                        rc = sqlite3_backup_step(backup, BackupPagesPerStep);
+
+                        if ((SQLITE_OK == rc) || (SQLITE_BUSY == rc) || (SQLITE_LOCKED == rc))
+                        {
+                            std::this_thread::sleep_for(std::chrono::milliseconds(STEP_PAUSE_MS));
+                        }
+                    } while (((SQLITE_OK == rc) || (SQLITE_BUSY == rc) || (SQLITE_LOCKED == rc)) && (false == IsBackupAborted()));
+
+                    if ((SQLITE_DONE != rc) && (true == Shutdown::IsDeadlineExceeded()))
+                    {
+                        Shutdown::ReportPending("Backup", (size_t)sqlite3_backup_remaining(backup), "pages of the running backup");
+                    }
+
+                    sqlite3_backup_finish(backup);
+                }
+
+                sqlite3_exec(source, "COMMIT;", nullptr, nullptr, nullptr);
+            }
+
+            result = (SQLITE_DONE == rc);
+        }
+
+        if (false == result)
+        {
+            Log::GetLog()->error("Backup of the database failed: {}", 
+                (nullptr != destination) ? sqlite3_errmsg(destination) : sqlite3_errstr(rc));
+        }
+
+        sqlite3_close(destination);
+        sqlite3_close(source);
+
+        return result;
+    }
+
+
+    /**
+    * \brief Removes old backups
+    *
+    * This function removes the oldest backups exceeding the retention count
+    *
+    * \return void
+    */
+    static void RemoveOldBackups(void)
+    {
+        std::vector<std::filesystem::path> backups;
+        const std::string prefix = DatabaseFile.stem().u8string() + BACKUP_FILE_TAG;
+        std::error_code error;
+
+        if (0 >= BackupRetentionCount)
+        {
+            return;
+        }
+
+        for (const auto& entry : std::filesystem::directory_iterator(BackupDirectory, error))
+        {
+            const std::string name = entry.path().filename().u8string();
+
+            if ((true == entry.is_regular_file(error)) && (0 == name.rfind(prefix, 0)) && 
+                (entry.path().extension() == DatabaseFile.extension()))
+            {
+                backups.push_back(entry.path());
+            }
+        }
+
+        if (backups.size() > (size_t)BackupRetentionCount)
+        {
+            std::sort(backups.begin(), backups.end());
+
+            for (size_t i = 0; i < (backups.size() - (size_t)BackupRetentionCount); i++)
+            {
+                std::filesystem::remove(backups[i], error);
+            }
+        }
+    }
+
+
+    /**
+    * \brief Writes one backup
+    *
+    * \return void
+    */
+    static void RunBackup(void)
+    {
+        std::error_code error;
+        std::filesystem::path target;
+        std::filesystem::path temporary;
+
+        std::filesystem::create_directories(BackupDirectory, error);
+
+        target = GetBackupFile();
+        temporary = target;
+        temporary += TEMPORARY_EXTENSION;
+        std::filesystem::remove(temporary, error);
+
+        if (true == CopyDatabase(temporary))
+        {
+            std::filesystem::rename(temporary, target, error);
+
+            if (error)
+            {
+                Log::GetLog()->error("Backup of the database could not be renamed: {}", error.message());
+            }
+            else
+            {
+                Log::GetLog()->info("Backup of the database written to {}", target.u8string());
+                RemoveOldBackups();
+            }
+        }
+
+        std::filesystem::remove(temporary, error);
+    }
+
+
+    /**
+    * \brief Main loop of the backup thread
+    *
+    * This function writes a backup on every request and after every interval until the thread gets stopped
+    *
+    * \return void
+    */
+    static void BackupLoop(void)
+    {
+        std::unique_lock<std::mutex> lock(BackupMutex);
+        auto wakeUp = [] { return (true == StopBackup) || (true == IsBackupRequested); };
+
+        while (false == StopBackup)
+        {
+            if (0 < BackupInterval)
+            {
+                BackupCondition.wait_for(lock, std::chrono::minutes(BackupInterval), wakeUp);
+            }
+            else
+            {
+                BackupCondition.wait(lock, wakeUp);
+            }
+
+            if (false == StopBackup)
+            {
+                IsBackupRequested = false;
+                IsBackupActive = true;
+                lock.unlock();
+
+                RunBackup();
+
+                lock.lock();
+                IsBackupActive = false;
+            }
+        }
+    }
+
+
+    /* ===================================== [definition of global functions] ===================================== */
+
+    /**
+    * \brief Initialisation of the backups
+    *
+    * \param[in] DatabasePath path of the database
+    * \param[in] Directory directory of the backups, if empty a Backups directory next to the database is used
+    * \param[in] IntervalMinutes interval of the scheduled backups in minutes, 0 disables the schedule
+    * \param[in] RetentionCount number of kept backups, 0 keeps all
+    * \param[in] PagesPerStep number of pages copied at once
+    * \return void
+    */
+    void InitBackup(const std::string& DatabasePath, const std::string& Directory, int IntervalMinutes, int RetentionCount, int PagesPerStep)
+    {
+        if (true == IsRunning)
+        {
+            return;
+        }
+
+        DatabaseFile = std::filesystem::u8path(DatabasePath);
+        BackupDirectory = (true == Directory.empty()) ? (DatabaseFile.parent_path() / "Backups") : std::filesystem::u8path(Directory);
+        BackupInterval = IntervalMinutes;
+        BackupRetentionCount = RetentionCount;
+        BackupPagesPerStep = (0 < PagesPerStep) ? PagesPerStep : 1;
+
+        StopBackup = false;
+        IsBackupRequested = false;
+        IsBackupActive = false;
+
+        BackupThread = std::thread(&BackupLoop);
+        IsRunning = true;
+    }
+
+
+    /**
+    * \brief Remove of the backups
+    *
+    * This function stops the backup thread, a running backup gets aborted. During the shutdown a running 
+    * backup may finish until the deadline.
+    *
+    * \return void
+    */
+    void RemoveBackup(void)
+    {
+        if (false == IsRunning)
+        {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(BackupMutex);
+            StopBackup = true;
+        }
+        BackupCondition.notify_one();
+
+        BackupThread.join();
+        IsRunning = false;
+    }
+
+
+    /**
+    * \brief Requests a backup
+    *
+    * The backup is written in the background
+    *
+    * \return bool true if the backup was started, false if a backup is already running
+    */
+    bool RequestBackup(void)
+    {
+        bool result = false;
+
+        if (true == IsRunning)
+        {
+            std::lock_guard<std::mutex> lock(BackupMutex);
+
+            if ((false == IsBackupRequested) && (false == IsBackupActive))
+            {
+                IsBackupRequested = true;
+                result = true;
+            }
+        }
+
+        if (true == result)
+        {
+            BackupCondition.notify_one();
+        }
+
+        return result;
+    }
+}
+
+/* =================================================[end of file]================================================= */
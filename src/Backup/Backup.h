@@ -0,0 +1,48 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file Backup.h
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Online backup of the database
+*
+*/
+
+#ifndef BACKUP_H
+#define BACKUP_H
+
+/* ================================================[includes]================================================ */
+#include <string>
+
+
+namespace Backup
+{
+    /* ================================================[declaration of public functions]========================= */
+
+    extern void InitBackup(const std::string& DatabasePath, const std::string& Directory, int IntervalMinutes, int RetentionCount, int PagesPerStep);
+    extern void RemoveBackup();
+    extern bool RequestBackup();
+}
+
+
+#endif /* BACKUP_H */
+
+/* =================================================[end of file]================================================= */
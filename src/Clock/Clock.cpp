@@ -0,0 +1,249 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file Clock.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Clock of the plugin
+*
+* Slot cooldowns are stored as unix time, so they survive restarts of the server. The world time of the
+* game is only used to detect a new world. Both times are read once per tick and cached, the hot paths
+* only read the cached values. The sources of both times can be replaced by a virtual clock.
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "Clock.h"
+#include "API/ARK/Ark.h"
+#include <algorithm>
+#include <ctime>
+
+
+namespace Clock
+{
+    /* ========================================== [local defines] =============================================== */
+
+    /** \brief id of the tick callback */
+    #define CLOCK_TICK_ID "TribeSlotCooldown.Clock"
+
+
+    /* =============================================== [local data] =============================================== */
+
+    /** \brief source of the unix time */
+    static TimeSource_t CurrentTimeSource = nullptr;
+
+    /** \brief source of the world time */
+    static WorldTimeSource_t CurrentWorldTimeSource = nullptr;
+
+    /** \brief cached unix time */
+    static int64_t CachedTime = 0;
+
+    /** \brief cached world time */
+    static double CachedWorldTime = 0.0;
+
+    /** \brief true if the world time was read from an existing world */
+    static bool IsCachedWorldTimeValid = false;
+
+    /** \brief max remaining cooldown of a converted legacy slot in seconds */
+    static int MaxRemainingLegacyCooldown = 0;
+
+
+    /* ===================================== [prototype of local functions] ======================================= */
+
+    static int64_t GetSystemTime(void);
+    static double GetGameWorldTime(void);
+    static void OnTick(float DeltaSeconds);
+
+
+    /* ===================================== [definition of local functions] ====================================== */
+
+    /**
+    * \brief Gets the unix time of the system
+    *
+    * \return int64_t seconds since epoch
+    */
+    static int64_t GetSystemTime(void)
+    {
+        return (int64_t)std::time(nullptr);
+    }
+
+
+    /**
+    * \brief Gets the world time of the game
+    *
+    * \return double world time in seconds, negative if there is no world yet
+    */
+    static double GetGameWorldTime(void)
+    {
+        UWorld* world = ArkApi::GetApiUtils().GetWorld();
+
+        return (nullptr != world) ? (double)world->TimeSecondsField() : -1.0;
+    }
+
+
+    /**
+    * \brief Tick callback
+    *
+    * \param[in] DeltaSeconds variable is not used
+    * \return void
+    */
+    static void OnTick(float)
+    {
+        Update();
+    }
+
+
+    /* ===================================== [definition of global functions] ===================================== */
+
+    /**
+    * \brief Initialisation of the clock
+    *
+    * \param[in] MaxLegacyCooldown max remaining cooldown of a converted legacy slot in seconds
+    * \return void
+    */
+    void InitClock(int MaxLegacyCooldown)
+    {
+        MaxRemainingLegacyCooldown = MaxLegacyCooldown;
+
+        if (nullptr == CurrentTimeSource)
+        {
+            SetTimeSource(&GetSystemTime, &GetGameWorldTime);
+        }
+
+        ArkApi::GetCommands().AddOnTickCallback(CLOCK_TICK_ID, &OnTick);
+    }
+
+
+    /**
+    * \brief Remove of the clock
+    *
+    * \return void
+    */
+    void RemoveClock(void)
+    {
+        ArkApi::GetCommands().RemoveOnTickCallback(CLOCK_TICK_ID);
+    }
+
+
+    /**
+    * \brief Replaces the sources of the clock
+    *
+    * This function is used to run the plugin on a virtual clock, nullptr restores the real sources
+    *
+    * \param[in] TimeSource source of the unix time
+    * \param[in] WorldTimeSource source of the world time
+    * \return void
+    */
+    void SetTimeSource(TimeSource_t TimeSource, WorldTimeSource_t WorldTimeSource)
+    {
+        CurrentTimeSource = (nullptr != TimeSource) ? TimeSource : &GetSystemTime;
+        CurrentWorldTimeSource = (nullptr != WorldTimeSource) ? WorldTimeSource : &GetGameWorldTime;
+
+        Update();
+    }
+
+
+    /**
+    * \brief Reads the sources of the clock
+    *
+    * This function gets called once per tick
+    *
+    * \return void
+    */
+    void Update(void)
+    {
+        double worldTime = CurrentWorldTimeSource();
+
+        CachedTime = CurrentTimeSource();
+
+        if (0.0 <= worldTime)
+        {
+            CachedWorldTime = worldTime;
+            IsCachedWorldTimeValid = true;
+        }
+    }
+
+
+    /**
+    * \brief Gets the current time
+    *
+    * \return int64_t unix time in seconds, cached at the start of the tick
+    */
+    int64_t Now(void)
+    {
+        return CachedTime;
+    }
+
+
+    /**
+    * \brief Gets the world time
+    *
+    * The world time starts at zero with a new world
+    *
+    * \return double world time in seconds, cached at the start of the tick
+    */
+    double GetWorldTime(void)
+    {
+        return CachedWorldTime;
+    }
+
+
+    /**
+    * \brief Checks if the world time is known
+    *
+    * \return bool true if the world time was read from an existing world
+    */
+    bool IsWorldTimeValid(void)
+    {
+        return IsCachedWorldTimeValid;
+    }
+
+
+    /**
+    * \brief Converts legacy slot cooldowns
+    *
+    * Older versions stored the world time a slot cooldown expires. Such cooldowns are converted to unix 
+    * time by their remaining time, which is limited to the configured cooldown. Expired cooldowns become 0.
+    * The cooldowns stay unchanged as long as the world time is unknown.
+    *
+    * \param[in,out] Slots the slot cooldowns
+    * \return void
+    */
+    void ConvertLegacySlots(std::vector<int64_t>* Slots)
+    {
+        if ((nullptr != Slots) && (true == IsCachedWorldTimeValid))
+        {
+            for (int64_t& slot : *Slots)
+            {
+                if ((0 < slot) && (CLOCK_LEGACY_TIME_LIMIT > slot))
+                {
+                    double remaining = (std::min)((double)slot - CachedWorldTime, (double)MaxRemainingLegacyCooldown);
+
+                    slot = (0.0 < remaining) ? (CachedTime + (int64_t)remaining) : 0;
+                }
+            }
+        }
+    }
+}
+
+/* =================================================[end of file]================================================= */
@@ -0,0 +1,69 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file Clock.h
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Clock of the plugin
+*
+*/
+
+#ifndef CLOCK_H
+#define CLOCK_H
+
+/* ================================================[includes]================================================ */
+#include <cstdint>
+#include <vector>
+
+
+namespace Clock
+{
+    /* ================================================[declaration of public defines]=========================== */
+
+    /** \brief stored slot cooldowns below this value are legacy server runtimes instead of unix times */
+    #define CLOCK_LEGACY_TIME_LIMIT 1000000000
+
+
+    /* ================================================[declaration of public types]============================= */
+
+    /** \brief source of the unix time in seconds */
+    typedef int64_t(*TimeSource_t)(void);
+
+    /** \brief source of the world time in seconds */
+    typedef double(*WorldTimeSource_t)(void);
+
+
+    /* ================================================[declaration of public functions]========================= */
+
+    extern void InitClock(int MaxLegacyCooldown);
+    extern void RemoveClock();
+    extern void SetTimeSource(TimeSource_t TimeSource, WorldTimeSource_t WorldTimeSource);
+    extern void Update();
+    extern int64_t Now();
+    extern double GetWorldTime();
+    extern bool IsWorldTimeValid();
+    extern void ConvertLegacySlots(std::vector<int64_t>* Slots);
+}
+
+
+#endif /* CLOCK_H */
+
+/* =================================================[end of file]================================================= */
@@ -0,0 +1,152 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file ClusterSync.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Synchronisation of server processes sharing one database
+*
+* Several server processes of a cluster can share one database. The local caches of a process are only
+* valid as long as no other process changed the database. The data version of sqlite only changes on 
+* commits of other connections, so it is polled and all caches get invalidated on a change.
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "ClusterSync.h"
+#include "SlotCooldown.h"
+#include "Statistics.h"
+
+
+namespace ClusterSync
+{
+    /* ========================================== [local defines] =============================================== */
+
+    /** \brief id of the timer callback */
+    #define CLUSTER_SYNC_TIMER_ID "TribeSlotCooldown.ClusterSync"
+
+
+    /* =============================================== [local data] =============================================== */
+
+    /** \brief poll interval of the data version in seconds */
+    static int DataVersionPollInterval = 0;
+
+    /** \brief seconds since the last poll */
+    static int SecondsSinceLastPoll = 0;
+
+    /** \brief last known data version */
+    static int LastDataVersion = 0;
+
+    /** \brief true if the last known data version is valid */
+    static bool IsDataVersionValid = false;
+
+
+    /* ===================================== [prototype of local functions] ======================================= */
+
+    static void OnTimer(void);
+
+
+    /* ===================================== [definition of local functions] ====================================== */
+
+    /**
+    * \brief Timer callback
+    *
+    * This function gets called every second and polls the data version in the configured interval
+    *
+    * \return void
+    */
+    static void OnTimer(void)
+    {
+        SecondsSinceLastPoll++;
+
+        if (SecondsSinceLastPoll >= DataVersionPollInterval)
+        {
+            SecondsSinceLastPoll = 0;
+            CheckForExternalChanges();
+        }
+    }
+
+
+    /* ===================================== [definition of global functions] ===================================== */
+
+    /**
+    * \brief Initialisation of the cluster synchronisation
+    *
+    * \param[in] PollInterval poll interval of the data version in seconds, 0 disables the polling
+    * \return void
+    */
+    void InitClusterSync(int PollInterval)
+    {
+        DataVersionPollInterval = PollInterval;
+        SecondsSinceLastPoll = 0;
+        IsDataVersionValid = false;
+
+        if (0 < DataVersionPollInterval)
+        {
+            CheckForExternalChanges();
+            ArkApi::GetCommands().AddOnTimerCallback(CLUSTER_SYNC_TIMER_ID, &OnTimer);
+        }
+    }
+
+
+    /**
+    * \brief Remove of the cluster synchronisation
+    *
+    * \return void
+    */
+    void RemoveClusterSync(void)
+    {
+        if (0 < DataVersionPollInterval)
+        {
+            ArkApi::GetCommands().RemoveOnTimerCallback(CLUSTER_SYNC_TIMER_ID);
+            DataVersionPollInterval = 0;
+        }
+    }
+
+
+    /**
+    * \brief Checks for changes of other processes
+    *
+    * This function invalidates all caches if an other process changed the database since the last check
+    *
+    * \return void
+    */
+    void CheckForExternalChanges(void)
+    {
+        int dataVersion;
+
+        if ((nullptr != SlotCooldown::database) && (true == SlotCooldown::database->GetDataVersion(&dataVersion)))
+        {
+            if ((true == IsDataVersionValid) && (dataVersion != LastDataVersion))
+            {
+                Statistics::Increment(Statistics::ExternalDatabaseChange);
+                SlotCooldown::InvalidateAllCaches();
+            }
+
+            LastDataVersion = dataVersion;
+            IsDataVersionValid = true;
+        }
+    }
+}
+
+/* =================================================[end of file]================================================= */
@@ -0,0 +1,348 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file CommandParser.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Allocation free parsing of command arguments
+*
+* Arguments are returned as views into the command string and numbers are parsed without exceptions,
+* in the manner of std::from_chars. The whole token has to be a number, 64 bit steam ids are supported.
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "CommandParser.h"
+#include <climits>
+
+
+namespace CommandParser
+{
+    /* ===================================== [prototype of local functions] ======================================= */
+
+    static bool IsSeparator(wchar_t Character);
+
+
+    /* ===================================== [definition of local functions] ====================================== */
+
+    /**
+    * \brief Checks for a separator
+    *
+    * \param[in] Character the character to check
+    * \return true if the character separates two arguments, otherwise false
+    */
+    static bool IsSeparator(wchar_t Character)
+    {
+        return ((L' ' == Character) || (L'\t' == Character) || (L'\r' == Character) || (L'\n' == Character));
+    }
+
+
+    /* ===================================== [definition of global functions] ===================================== */
+
+    /**
+    * \brief Initialisation of a tokenizer
+    *
+    * \param[out] Tokenizer the tokenizer to initialize
+    * \param[in] Command the null terminated command, has to outlive the tokenizer
+    * \return void
+    */
+    void InitTokenizer(Tokenizer_t* Tokenizer, const wchar_t* Command)
+    {
+        if (nullptr != Tokenizer)
+        {
+            Tokenizer->position = Command;
+            Tokenizer->end = Command;
+
+            if (nullptr != Command)
+            {
+                while (L'\0' != *Tokenizer->end)
+                {
+                    Tokenizer->end++;
+                }
+            }
+        }
+    }
+
+
+    /**
+    * \brief Gets the next token
+    *
+    * \param[in/out] Tokenizer the tokenizer
+    * \param[out] Token view of the next token
+    * \return true if there was a further token, otherwise false
+    */
+    bool NextToken(Tokenizer_t* Tokenizer, std::wstring_view* Token)
+    {
+        bool result = false;
+
+        if ((nullptr != Tokenizer) && (nullptr != Token) && (nullptr != Tokenizer->position))
+        {
+            while ((Tokenizer->position != Tokenizer->end) && (true == IsSeparator(*Tokenizer->position)))
+            {
+                Tokenizer->position++;
+            }
+
+            const wchar_t* begin = Tokenizer->position;
+
+            while ((Tokenizer->position != Tokenizer->end) && (false == IsSeparator(*Tokenizer->position)))
+            {
+                Tokenizer->position++;
+            }
+
+            if (begin != Tokenizer->position)
+            {
+                *Token = std::wstring_view(begin, (size_t)(Tokenizer->position - begin));
+                result = true;
+            }
+        }
+
+        return result;
+    }
+
+
+    /**
+    * \brief Gets a token by index
+    *
+    * \param[in] Command the null terminated command
+    * \param[in] Index index of the token, 0 is the command name
+    * \param[out] Token view of the token
+    * \return true if the token exists, otherwise false
+    */
+    bool GetToken(const wchar_t* Command, int Index, std::wstring_view* Token)
+    {
+        bool result = false;
+        Tokenizer_t tokenizer;
+
+        InitTokenizer(&tokenizer, Command);
+
+        for (int i = 0; (i <= Index) && (true == NextToken(&tokenizer, Token)); i++)
+        {
+            if (i == Index)
+            {
+                result = true;
+            }
+        }
+
+        return result;
+    }
+
+
+    /**
+    * \brief Parses an unsigned 64 bit number
+    *
+    * \param[in] Text the text to parse, it must only contain decimal digits
+    * \param[out] Value the parsed number, unchanged on error
+    * \return ParseResult_t ParseOk on success, otherwise the error
+    */
+    ParseResult_t ParseUInt64(std::wstring_view Text, uint64_t* Value)
+    {
+        ParseResult_t result = ParseOk;
+        bool overflow = false;
+        uint64_t number = 0;
+
+        if ((nullptr == Value) || (true == Text.empty()))
+        {
+            result = ParseInvalidArgument;
+        }
+
+        for (size_t i = 0; (ParseOk == result) && (i < Text.size()); i++)
+        {
+            wchar_t character = Text[i];
+
+            if ((character < L'0') || (character > L'9'))
+            {
+                result = ParseInvalidArgument;
+            }
+            else if (false == overflow)
+            {
+                uint64_t digit = (uint64_t)(character - L'0');
+
+                if (number > ((UINT64_MAX - digit) / 10))
+                {
+                    /* keep on checking, invalid characters take precedence */
+                    overflow = true;
+                }
+                else
+                {
+                    number = (number * 10) + digit;
+                }
+            }
+        }
+
+        if ((ParseOk == result) && (true == overflow))
+        {
+            result = ParseOutOfRange;
+        }
+
+        if (ParseOk == result)
+        {
+            *Value = number;
+        }
+
+        return result;
+    }
+
+
+    /**
+    * \brief Parses a non negative int
+    *
+    * \param[in] Text the text to parse, it must only contain decimal digits
+    * \param[out] Value the parsed number, unchanged on error
+    * \return ParseResult_t ParseOk on success, otherwise the error
+    */
+    ParseResult_t ParseInt(std::wstring_view Text, int* Value)
+    {
+        uint64_t number = 0;
+        ParseResult_t result = ParseUInt64(Text, &number);
+
+        if (nullptr == Value)
+        {
+            result = ParseInvalidArgument;
+        }
+        else if (ParseOk == result)
+        {
+            if (number > (uint64_t)INT_MAX)
+            {
+                result = ParseOutOfRange;
+            }
+            else
+            {
+                *Value = (int)number;
+            }
+        }
+
+        return result;
+    }
+
+
+    /**
+    * \brief Parses an unsigned 64 bit argument of a command
+    *
+    * \param[in] Command the null terminated command
+    * \param[in] Index index of the argument, 0 is the command name
+    * \param[out] Value the parsed number
+    * \return ParseResult_t ParseOk on success, otherwise the error
+    */
+    ParseResult_t ParseUInt64Argument(const wchar_t* Command, int Index, uint64_t* Value)
+    {
+        ParseResult_t result = ParseMissingArgument;
+        std::wstring_view token;
+
+        if (true == GetToken(Command, Index, &token))
+        {
+            result = ParseUInt64(token, Value);
+        }
+
+        return result;
+    }
+
+
+    /**
+    * \brief Parses a non negative int argument of a command
+    *
+    * \param[in] Command the null terminated command
+    * \param[in] Index index of the argument, 0 is the command name
+    * \param[out] Value the parsed number
+    * \return ParseResult_t ParseOk on success, otherwise the error
+    */
+    ParseResult_t ParseIntArgument(const wchar_t* Command, int Index, int* Value)
+    {
+        ParseResult_t result = ParseMissingArgument;
+        std::wstring_view token;
+
+        if (true == GetToken(Command, Index, &token))
+        {
+            result = ParseInt(token, Value);
+        }
+
+        return result;
+    }
+
+
+    /**
+    * \brief Gets the error message of a parse result
+    *
+    * \param[in] Result the parse result
+    * \return const char* the reply for the caller of the command
+    */
+    const char* GetParseErrorMessage(ParseResult_t Result)
+    {
+        const char* message;
+
+        switch (Result)
+        {
+        case ParseOk:
+            message = "No Error!\n";
+            break;
+        case ParseMissingArgument:
+            message = "Missing command arguments!\n";
+            break;
+        case ParseInvalidArgument:
+            message = "Invalid command arguments!\n";
+            break;
+        case ParseOutOfRange:
+            message = "Out of Range command arguments!\n";
+            break;
+        default:
+            message = "Undefined error command arguments!\n";
+            break;
+        }
+
+        return message;
+    }
+
+
+    /**
+    * \brief Gets the name of a parse result
+    *
+    * \param[in] Result the parse result
+    * \return const char* machine readable name of the result
+    */
+    const char* GetParseErrorName(ParseResult_t Result)
+    {
+        const char* name;
+
+        switch (Result)
+        {
+        case ParseOk:
+            name = "Ok";
+            break;
+        case ParseMissingArgument:
+            name = "MissingArgument";
+            break;
+        case ParseInvalidArgument:
+            name = "InvalidArgument";
+            break;
+        case ParseOutOfRange:
+            name = "OutOfRange";
+            break;
+        default:
+            name = "UndefinedError";
+            break;
+        }
+
+        return name;
+    }
+}
+
+/* =================================================[end of file]================================================= */
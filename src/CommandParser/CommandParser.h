@@ -0,0 +1,83 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file CommandParser.h
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Allocation free parsing of command arguments
+*
+*/
+
+#ifndef COMMANDPARSER_H
+#define COMMANDPARSER_H
+
+/* ================================================[includes]================================================ */
+#include <cstdint>
+#include <string_view>
+
+
+namespace CommandParser
+{
+    /* ================================================[type definitions]======================================== */
+
+    /**
+    *  \brief result of a parse operation
+    */
+    typedef enum
+    {
+        ParseOk = 0,            /**< \brief argument parsed */
+        ParseMissingArgument,   /**< \brief argument does not exist */
+        ParseInvalidArgument,   /**< \brief argument is not a number */
+        ParseOutOfRange         /**< \brief number does not fit into the target type */
+
+    }ParseResult_t;
+
+
+    /**
+    *  \brief tokenizer over the words of a command, it does not own the command
+    */
+    typedef struct
+    {
+        const wchar_t* position;    /**< \brief current position in the command */
+        const wchar_t* end;         /**< \brief end of the command */
+
+    }Tokenizer_t;
+
+
+    /* ================================================[declaration of public functions]========================= */
+
+    extern void InitTokenizer(Tokenizer_t* Tokenizer, const wchar_t* Command);
+    extern bool NextToken(Tokenizer_t* Tokenizer, std::wstring_view* Token);
+    extern bool GetToken(const wchar_t* Command, int Index, std::wstring_view* Token);
+
+    extern ParseResult_t ParseUInt64(std::wstring_view Text, uint64_t* Value);
+    extern ParseResult_t ParseInt(std::wstring_view Text, int* Value);
+    extern ParseResult_t ParseUInt64Argument(const wchar_t* Command, int Index, uint64_t* Value);
+    extern ParseResult_t ParseIntArgument(const wchar_t* Command, int Index, int* Value);
+
+    extern const char* GetParseErrorMessage(ParseResult_t Result);
+    extern const char* GetParseErrorName(ParseResult_t Result);
+}
+
+
+#endif /* COMMANDPARSER_H */
+
+/* =================================================[end of file]================================================= */
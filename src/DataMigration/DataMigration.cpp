@@ -0,0 +1,142 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file DataMigration.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Incremental migration of the database rows
+*
+* Schema migrations run at startup, the existing rows are migrated afterwards. The migration is not a 
+* background thread, it runs as a maintenance task on the game thread within the time slices of the 
+* scheduler, each chunk of rows in its own short transaction, so neither the startup nor a tick gets blocked
+* for long.
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "DataMigration.h"
+#include "SlotCooldown.h"
+#include "Clock.h"
+#include "Scheduler.h"
+
+
+namespace DataMigration
+{
+    /* ========================================== [local defines] =============================================== */
+
+    /** \brief name of the maintenance task */
+    #define DATA_MIGRATION_TASK "DataMigration"
+
+    /** \brief seconds between two attempts if the migration can not continue */
+    #define DATA_MIGRATION_RETRY_INTERVAL 1
+
+
+    /* =============================================== [local data] =============================================== */
+
+    /** \brief max number of rows migrated at once */
+    static int MigrationChunkSize = 0;
+
+    /** \brief number of migrated rows */
+    static int NumOfMigratedRows = 0;
+
+
+    /* ===================================== [prototype of local functions] ======================================= */
+
+    static Scheduler::StepResult_t MigrationStep(std::chrono::steady_clock::time_point Deadline);
+
+
+    /* ===================================== [definition of local functions] ====================================== */
+
+    /**
+    * \brief Step of the migration task
+    *
+    * This function migrates chunks of rows until the deadline. A failed chunk is retried after a second.
+    *
+    * \param[in] Deadline end of the time slice
+    * \return Scheduler::StepResult_t StepFinished once all rows are migrated
+    */
+    static Scheduler::StepResult_t MigrationStep(std::chrono::steady_clock::time_point Deadline)
+    {
+        /* legacy cooldowns can only be converted once the world time is known */
+        if ((nullptr == SlotCooldown::database) || (false == Clock::IsWorldTimeValid()))
+        {
+            return Scheduler::StepDone;
+        }
+
+        while (std::chrono::steady_clock::now() < Deadline)
+        {
+            int migratedRows = SlotCooldown::database->MigrateDataChunk(MigrationChunkSize);
+
+            if (0 > migratedRows)
+            {
+                return Scheduler::StepDone;
+            }
+
+            if (0 == migratedRows)
+            {
+                if (0 < NumOfMigratedRows)
+                {
+                    Log::GetLog()->info("Database rows migrated: {}", NumOfMigratedRows);
+                }
+
+                return Scheduler::StepFinished;
+            }
+
+            NumOfMigratedRows += migratedRows;
+        }
+
+        return Scheduler::StepPending;
+    }
+
+
+    /* ===================================== [definition of global functions] ===================================== */
+
+    /**
+    * \brief Initialisation of the data migration
+    *
+    * \param[in] ChunkSize max number of rows migrated at once
+    * \return void
+    */
+    void InitDataMigration(int ChunkSize)
+    {
+        MigrationChunkSize = (0 < ChunkSize) ? ChunkSize : 1;
+        NumOfMigratedRows = 0;
+
+        Scheduler::AddTask(DATA_MIGRATION_TASK, DATA_MIGRATION_RETRY_INTERVAL, &MigrationStep);
+    }
+
+
+    /**
+    * \brief Remove of the data migration
+    *
+    * A pending migration continues with the next start of the plugin
+    *
+    * \return void
+    */
+    void RemoveDataMigration(void)
+    {
+        Scheduler::RemoveTask(DATA_MIGRATION_TASK);
+    }
+}
+
+/* =================================================[end of file]================================================= */
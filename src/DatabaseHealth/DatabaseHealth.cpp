@@ -0,0 +1,137 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file DatabaseHealth.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Recovery of the database after failures
+*
+* The database handler stops to access the database after too many failures in a row and keeps the changes 
+* in a journal. This module probes the database periodically, writes the journal and drops the caches once 
+* the database recovered.
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "DatabaseHealth.h"
+#include "SlotCooldown.h"
+
+
+namespace DatabaseHealth
+{
+    /* ========================================== [local defines] =============================================== */
+
+    /** \brief id of the timer callback */
+    #define DATABASE_HEALTH_TIMER_ID "TribeSlotCooldown.DatabaseHealth"
+
+
+    /* =============================================== [local data] =============================================== */
+
+    /** \brief probe interval in seconds */
+    static int ProbeInterval = 0;
+
+    /** \brief seconds since the last probe */
+    static int SecondsSinceLastProbe = 0;
+
+
+    /* ===================================== [prototype of local functions] ======================================= */
+
+    static void OnTimer(void);
+
+
+    /* ===================================== [definition of local functions] ====================================== */
+
+    /**
+    * \brief Timer callback
+    *
+    * This function gets called every second and probes the database in the configured interval. The caches 
+    * are dropped after a recovery, other processes may have changed the database in the meantime.
+    *
+    * \return void
+    */
+    static void OnTimer(void)
+    {
+        SecondsSinceLastProbe++;
+
+        if ((SecondsSinceLastProbe >= ProbeInterval) && (nullptr != SlotCooldown::database))
+        {
+            const bool wasCircuitOpen = SlotCooldown::database->IsCircuitOpen();
+
+            SecondsSinceLastProbe = 0;
+
+            if ((true == SlotCooldown::database->ProbeCircuit()) && (true == wasCircuitOpen))
+            {
+                SlotCooldown::InvalidateAllCaches();
+            }
+        }
+    }
+
+
+    /* ===================================== [definition of global functions] ===================================== */
+
+    /**
+    * \brief Initialisation of the database recovery
+    *
+    * \param[in] Interval probe interval in seconds, 0 disables the recovery
+    * \return void
+    */
+    void InitDatabaseHealth(int Interval)
+    {
+        ProbeInterval = Interval;
+        SecondsSinceLastProbe = 0;
+
+        if (0 < ProbeInterval)
+        {
+            ArkApi::GetCommands().AddOnTimerCallback(DATABASE_HEALTH_TIMER_ID, &OnTimer);
+        }
+    }
+
+
+    /**
+    * \brief Remove of the database recovery
+    *
+    * A journal that is left is written a last time
+    *
+    * \return void
+    */
+    void RemoveDatabaseHealth(void)
+    {
+        if (0 < ProbeInterval)
+        {
+            ArkApi::GetCommands().RemoveOnTimerCallback(DATABASE_HEALTH_TIMER_ID);
+            ProbeInterval = 0;
+        }
+
+        if ((nullptr != SlotCooldown::database) && (0 != SlotCooldown::database->GetJournalSize()))
+        {
+            SlotCooldown::database->ProbeCircuit();
+
+            if (0 != SlotCooldown::database->GetJournalSize())
+            {
+                Log::GetLog()->error("Database not accessible, the changes of {} tribes are lost", SlotCooldown::database->GetJournalSize());
+            }
+        }
+    }
+}
+
+/* =================================================[end of file]================================================= */
@@ -0,0 +1,388 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file EventBus.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Propagation of slot cooldown changes between the servers of a cluster
+*
+* Every server of a cluster sends its events to its peers through a transport, the named pipes of EventPipe
+* on Windows. Events are compact binary records with a sequence number per sender, see EventFormat.h. A 
+* received event invalidates the cached slot cooldowns of the affected tribes, the data itself is read from 
+* the shared database again.
+* A gap in the sequence numbers of a sender means events got lost, in that case all caches are dropped.
+*
+* Sending and receiving happens in background threads, received events are applied on the game thread.
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "EventBus.h"
+#include "EventFormat.h"
+#include "SlotCooldown.h"
+#include "Statistics.h"
+#include "Shutdown.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+
+namespace EventBus
+{
+    /* ========================================== [local defines] =============================================== */
+
+    /** \brief id of the tick callback */
+    #define EVENT_BUS_TICK_ID "TribeSlotCooldown.EventBus"
+
+
+    /* =============================================== [local data] =============================================== */
+
+    /** \brief true if the event bus is running */
+    static bool IsRunning = false;
+
+    /** \brief id of this server */
+    static uint16_t LocalServerId = 0;
+
+    /** \brief transport of the events to the peers */
+    static std::unique_ptr<EventTransport> Transport;
+
+    /** \brief sequence number of the last published event */
+    static uint32_t LastSequence = 0;
+
+    /** \brief events waiting to be sent */
+    static std::vector<Event_t> SendQueue;
+
+    /** \brief true if the sender thread has to stop */
+    static bool StopSending = false;
+
+    /** \brief protects SendQueue and StopSending */
+    static std::mutex SendMutex;
+
+    /** \brief wakes up the sender thread */
+    static std::condition_variable SendCondition;
+
+    /** \brief events received but not yet applied */
+    static std::vector<Event_t> ReceiveQueue;
+
+    /** \brief events applied in the current tick, kept to reuse its memory */
+    static std::vector<Event_t> ApplyQueue;
+
+    /** \brief protects ReceiveQueue */
+    static std::mutex ReceiveMutex;
+
+    /** \brief sequence number of the last applied event of each peer */
+    static std::unordered_map<uint16_t, uint32_t> LastSequenceOfPeer;
+
+    /** \brief thread that sends the events */
+    static std::thread SenderThread;
+
+
+    /* ===================================== [prototype of local functions] ======================================= */
+
+    static int64_t GetTimeInMicroseconds(void);
+    static void SendLoop(void);
+    static void QueueReceivedEvents(const void* Message, size_t Size);
+    static void ApplyEvent(const Event_t& Event, int64_t Now);
+    static void OnTick(float DeltaSeconds);
+
+
+    /* ===================================== [definition of local functions] ====================================== */
+
+    /**
+    * \brief Gets the current time
+    *
+    * The system clock is used since the time has to be comparable between processes
+    *
+    * \return int64_t microseconds since epoch
+    */
+    static int64_t GetTimeInMicroseconds(void)
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+
+    /**
+    * \brief Main loop of the sender thread
+    *
+    * This function sends the queued events to all peers until the event bus gets stopped. Events queued 
+    * before the stop are still sent until the deadline of the shutdown.
+    *
+    * \return void
+    */
+    static void SendLoop(void)
+    {
+        std::vector<Event_t> events;
+        std::unique_lock<std::mutex> lock(SendMutex);
+
+        while ((false == StopSending) || (false == SendQueue.empty()))
+        {
+            SendCondition.wait(lock, [] { return (true == StopSending) || (false == SendQueue.empty()); });
+
+            events.swap(SendQueue);
+            lock.unlock();
+
+            for (size_t offset = 0; offset < events.size(); offset += MAX_EVENTS_PER_MESSAGE)
+            {
+                size_t numOfEvents = (std::min)(events.size() - offset, (size_t)MAX_EVENTS_PER_MESSAGE);
+
+                if (true == Shutdown::IsDeadlineExceeded())
+                {
+                    Shutdown::ReportPending("EventBus", events.size() - offset, "events");
+                    break;
+                }
+
+                Transport->Send(&events[offset], numOfEvents * sizeof(Event_t));
+            }
+
+            events.clear();
+            lock.lock();
+        }
+    }
+
+
+    /**
+    * \brief Queues received events
+    *
+    * This function is called by the transport for every message of a peer. It drops messages that are no 
+    * sequence of events and events of an unknown version or type.
+    *
+    * \param[in] Message the received message
+    * \param[in] Size size of the message in bytes
+    * \return void
+    */
+    static void QueueReceivedEvents(const void* Message, size_t Size)
+    {
+        const uint8_t* data = static_cast<const uint8_t*>(Message);
+        Event_t event;
+
+        if (0 != (Size % sizeof(Event_t)))
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(ReceiveMutex);
+
+        for (size_t offset = 0; offset < Size; offset += sizeof(Event_t))
+        {
+            std::memcpy(&event, data + offset, sizeof(Event_t));
+
+            if ((EVENT_VERSION == event.version) && (NumOfEventTypes > event.type))
+            {
+                ReceiveQueue.push_back(event);
+            }
+        }
+    }
+
+
+    /**
+    * \brief Applies an event of a peer
+    *
+    * \param[in] Event the event
+    * \param[in] Now the current time in microseconds since epoch
+    * \return void
+    */
+    static void ApplyEvent(const Event_t& Event, int64_t Now)
+    {
+        auto lastSequence = LastSequenceOfPeer.find(Event.serverId);
+
+        if (LocalServerId == Event.serverId)
+        {
+            return;
+        }
+
+        /* events got lost or the peer restarted, the caches can not be trusted anymore */
+        if ((LastSequenceOfPeer.end() != lastSequence) && ((lastSequence->second + 1) != Event.sequence))
+        {
+            Statistics::Increment(Statistics::EventBusResync);
+            SlotCooldown::InvalidateAllCaches();
+        }
+        LastSequenceOfPeer[Event.serverId] = Event.sequence;
+
+        switch (Event.type)
+        {
+        case EventSlotAdded:
+        case EventSlotsRemoved:
+            SlotCooldown::InvalidateTribeCaches(Event.tribeId);
+            break;
+        case EventTribesMerged:
+            SlotCooldown::InvalidateTribeCaches(Event.tribeId);
+            SlotCooldown::InvalidateTribeCaches(Event.otherTribeId);
+            break;
+        default:
+            SlotCooldown::InvalidateAllCaches();
+            break;
+        }
+
+        Statistics::Increment(Statistics::EventBusReceived);
+
+        if (Now > Event.publishTime)
+        {
+            Statistics::Add(Statistics::EventBusLatencySum, (uint64_t)(Now - Event.publishTime));
+        }
+    }
+
+
+    /**
+    * \brief Tick callback
+    *
+    * This function applies the received events on the game thread
+    *
+    * \param[in] DeltaSeconds variable is not used
+    * \return void
+    */
+    static void OnTick(float)
+    {
+        {
+            std::lock_guard<std::mutex> lock(ReceiveMutex);
+            ApplyQueue.swap(ReceiveQueue);
+        }
+
+        if (false == ApplyQueue.empty())
+        {
+            int64_t now = GetTimeInMicroseconds();
+
+            for (const Event_t& event : ApplyQueue)
+            {
+                ApplyEvent(event, now);
+            }
+
+            ApplyQueue.clear();
+        }
+    }
+
+
+    /* ===================================== [definition of global functions] ===================================== */
+
+    /**
+    * \brief Initialisation of the event bus
+    *
+    * \param[in] Enabled true if the event bus is used
+    * \param[in] Channel name of the cluster channel, has to be the same on all servers of the cluster
+    * \param[in] ServerId id of this server, unique within the cluster
+    * \param[in] PeerIds ids of the other servers of the cluster
+    * \param[in] NewTransport transport of the events to the peers
+    * \return void
+    */
+    void InitEventBus(bool Enabled, const std::string& Channel, int ServerId, const std::vector<int>& PeerIds, std::unique_ptr<EventTransport> NewTransport)
+    {
+        if ((false == Enabled) || (true == IsRunning))
+        {
+            return;
+        }
+
+        if ((0 > ServerId) || (UINT16_MAX < ServerId))
+        {
+            Log::GetLog()->error("EventBus: invalid ServerId {}", ServerId);
+            return;
+        }
+
+        LocalServerId = (uint16_t)ServerId;
+        LastSequence = 0;
+        LastSequenceOfPeer.clear();
+        StopSending = false;
+
+        Transport = std::move(NewTransport);
+        if ((nullptr == Transport) || (false == Transport->Open(Channel, ServerId, PeerIds, &QueueReceivedEvents)))
+        {
+            Log::GetLog()->error("EventBus: could not open the transport of channel {}", Channel);
+            Transport.reset();
+            return;
+        }
+
+        SenderThread = std::thread(&SendLoop);
+        ArkApi::GetCommands().AddOnTickCallback(EVENT_BUS_TICK_ID, &OnTick);
+
+        IsRunning = true;
+    }
+
+
+    /**
+    * \brief Remove of the event bus
+    *
+    * This function sends the pending events, stops the sender thread and closes the transport
+    *
+    * \return void
+    */
+    void RemoveEventBus(void)
+    {
+        if (false == IsRunning)
+        {
+            return;
+        }
+
+        ArkApi::GetCommands().RemoveOnTickCallback(EVENT_BUS_TICK_ID);
+
+        {
+            std::lock_guard<std::mutex> lock(SendMutex);
+            StopSending = true;
+        }
+        SendCondition.notify_one();
+        SenderThread.join();
+
+        Transport->Close();
+        Transport.reset();
+        ReceiveQueue.clear();
+
+        IsRunning = false;
+    }
+
+
+    /**
+    * \brief Publishes a slot cooldown change to the other servers of the cluster
+    *
+    * \param[in] Type kind of the change
+    * \param[in] TribeId id of the changed tribe
+    * \param[in] OtherTribeId id of the merged tribe for EventTribesMerged
+    * \return void
+    */
+    void Publish(EventType_t Type, int TribeId, int OtherTribeId)
+    {
+        if (true == IsRunning)
+        {
+            Event_t event;
+
+            event.version = EVENT_VERSION;
+            event.type = (uint8_t)Type;
+            event.serverId = LocalServerId;
+            event.sequence = ++LastSequence;
+            event.tribeId = TribeId;
+            event.otherTribeId = OtherTribeId;
+            event.publishTime = GetTimeInMicroseconds();
+
+            {
+                std::lock_guard<std::mutex> lock(SendMutex);
+                SendQueue.push_back(event);
+            }
+            SendCondition.notify_one();
+
+            Statistics::Increment(Statistics::EventBusPublished);
+        }
+    }
+}
+
+/* =================================================[end of file]================================================= */
@@ -0,0 +1,69 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file EventBus.h
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Propagation of slot cooldown changes between the servers of a cluster
+*
+*/
+
+#ifndef EVENTBUS_H
+#define EVENTBUS_H
+
+/* ================================================[includes]================================================ */
+#include "EventTransport.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace EventBus
+{
+    /* ================================================[declaration of public types]============================= */
+
+    /**
+    *  \brief kind of a slot cooldown change
+    */
+    typedef enum
+    {
+        EventSlotAdded = 0,     /**< \brief slot of a tribe set on cooldown */
+        EventSlotsRemoved,      /**< \brief slot cooldowns of a tribe removed */
+        EventTribesMerged,      /**< \brief slot cooldowns of a tribe inherited by an other tribe */
+        EventCooldownsReset,    /**< \brief slot cooldowns of many tribes changed */
+
+        NumOfEventTypes         /**< \brief number of event types, has to be the last entry */
+
+    }EventType_t;
+
+
+    /* ================================================[declaration of public functions]========================= */
+
+    extern void InitEventBus(bool Enabled, const std::string& Channel, int ServerId, const std::vector<int>& PeerIds, 
+        std::unique_ptr<EventTransport> NewTransport);
+    extern void RemoveEventBus();
+    extern void Publish(EventType_t Type, int TribeId, int OtherTribeId = 0);
+}
+
+
+#endif /* EVENTBUS_H */
+
+/* =================================================[end of file]================================================= */
@@ -0,0 +1,79 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file EventFormat.h
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 19 October 2026
+* \brief Binary format of the events of the event bus
+*
+* A message of the transport is a sequence of Event_t records, at most MAX_EVENTS_PER_MESSAGE of them. The
+* records are sent as they are in memory, all servers of a cluster run on the same machine.
+*
+*/
+
+#ifndef EVENTFORMAT_H
+#define EVENTFORMAT_H
+
+/* ================================================[includes]================================================ */
+#include <cstdint>
+
+
+namespace EventBus
+{
+    /* ================================================[declaration of public defines]=========================== */
+
+    /** \brief version of the event format */
+    #define EVENT_VERSION 1
+
+    /** \brief max number of events in one message */
+    #define MAX_EVENTS_PER_MESSAGE 64
+
+
+    /* ================================================[declaration of public types]============================= */
+
+#pragma pack(push, 1)
+
+    /**
+    *  \brief event as it is transferred between the servers
+    */
+    typedef struct
+    {
+        uint8_t version;            /**< \brief version of the event format */
+        uint8_t type;               /**< \brief kind of the change, see EventType_t */
+        uint16_t serverId;          /**< \brief id of the publishing server */
+        uint32_t sequence;          /**< \brief sequence number of the publishing server, starts with 1 */
+        int32_t tribeId;            /**< \brief id of the changed tribe */
+        int32_t otherTribeId;       /**< \brief id of the merged tribe for EventTribesMerged */
+        int64_t publishTime;        /**< \brief time of the publishing in microseconds since epoch */
+    }Event_t;
+
+#pragma pack(pop)
+
+    static_assert(24 == sizeof(Event_t), "the event format must not change without a new EVENT_VERSION");
+
+    /** \brief max size of a message in bytes */
+    #define MAX_MESSAGE_SIZE (MAX_EVENTS_PER_MESSAGE * sizeof(EventBus::Event_t))
+}
+
+
+#endif /* EVENTFORMAT_H */
+
+/* =================================================[end of file]================================================= */
@@ -0,0 +1,616 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file EventPipe.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 19 October 2026
+* \brief Named pipes of the event bus, the transport of the event bus on Windows
+*
+* The servers of a cluster run on the same machine under the same account. The pipes only accept local 
+* clients of that account, and a client only allows the server to identify it, not to act on its behalf.
+*
+* Every server listens on its own pipe and writes its messages to the pipes of its peers. All connections of 
+* the peers are served by a single receiver thread with overlapped operations.
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "EventPipe.h"
+#include "EventFormat.h"
+#include "API/ARK/Ark.h"
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+
+namespace EventPipe
+{
+    /* ========================================== [local defines] =============================================== */
+
+    /** \brief size of the pipe buffers in bytes */
+    #define PIPE_BUFFER_SIZE (16 * MAX_MESSAGE_SIZE)
+
+    /** \brief max time to wait for a peer to take a message */
+    #define WRITE_TIMEOUT_MS 100
+
+    /** \brief max number of connected peers, one wait handle is needed for the stop event and the listener each */
+    #define MAX_CONNECTIONS (MAXIMUM_WAIT_OBJECTS - 2)
+
+
+    /* ========================================== [local types] ================================================= */
+
+    /**
+    *  \brief pipe with a pending overlapped operation
+    */
+    typedef struct
+    {
+        HANDLE pipe;                                /**< \brief handle of the pipe */
+        OVERLAPPED overlapped;                      /**< \brief state of the pending operation */
+        bool isPending;                             /**< \brief true if the operation did not complete immediately */
+        uint8_t buffer[MAX_MESSAGE_SIZE];           /**< \brief buffer for received messages */
+    }Connection_t;
+
+
+    /**
+    *  \brief peer the messages get sent to
+    */
+    typedef struct
+    {
+        std::wstring pipeName;      /**< \brief name of the pipe of the peer */
+        HANDLE pipe;                /**< \brief handle of the pipe, INVALID_HANDLE_VALUE if not connected */
+    }Peer_t;
+
+
+    /*!
+    * transport of the event bus over named pipes
+    */
+    class PipeTransport : public EventBus::EventTransport
+    {
+    private:
+        /*! name of the pipe of this server */
+        std::wstring localPipeName;
+
+        /*! peers of this server, only used by the sender thread while open */
+        std::vector<Peer_t> peers;
+
+        /*! manual reset event that stops the receiver thread, NULL if closed */
+        HANDLE stopEvent = NULL;
+
+        /*! thread that receives the messages */
+        std::thread receiverThread;
+
+        /*! receiver of the messages */
+        EventBus::ReceiveCallback_t onReceive;
+
+        void ReceiveLoop();
+
+    public:
+        ~PipeTransport();
+
+        /*!
+        * transport interfaces; see implementation for further information
+        */
+        bool Open(const std::string& Channel, int ServerId, const std::vector<int>& PeerIds, const EventBus::ReceiveCallback_t& OnReceive) override;
+        void Send(const void* Message, size_t Size) override;
+        void Close() override;
+    };
+
+
+    /* ===================================== [prototype of local functions] ======================================= */
+
+    static bool GetProcessUser(std::vector<uint8_t>* User);
+    static std::wstring GetPipeName(const std::string& Channel, int ServerId);
+    static bool WritePeer(Peer_t* Peer, const void* Message, size_t Size);
+    static std::unique_ptr<Connection_t> CreateConnection(const std::wstring& Name, bool IsFirstInstance);
+    static void CloseConnection(Connection_t* Connection);
+    static bool StartListen(Connection_t* Connection);
+    static bool StartRead(Connection_t* Connection);
+
+
+    /* ===================================== [definition of local functions] ====================================== */
+
+    /**
+    * \brief Gets the account the server runs under
+    *
+    * \param[out] User buffer that receives the TOKEN_USER
+    * \return bool true on success
+    */
+    static bool GetProcessUser(std::vector<uint8_t>* User)
+    {
+        HANDLE token;
+        DWORD size = 0;
+        bool result = false;
+
+        if (FALSE == OpenProcessToken(GetCurrentProcess(), TOKEN_QUERY, &token))
+        {
+            return false;
+        }
+
+        GetTokenInformation(token, TokenUser, NULL, 0, &size);
+
+        if (0 != size)
+        {
+            User->resize(size);
+            result = (TRUE == GetTokenInformation(token, TokenUser, User->data(), size, &size));
+        }
+
+        CloseHandle(token);
+
+        return result;
+    }
+
+
+    /**
+    * \brief Gets the pipe name of a server
+    *
+    * \param[in] Channel name of the cluster channel
+    * \param[in] ServerId id of the server
+    * \return std::wstring name of the pipe
+    */
+    static std::wstring GetPipeName(const std::string& Channel, int ServerId)
+    {
+        return L"\\\\.\\pipe\\" + ArkApi::Tools::Utf8Decode(Channel) + L"." + std::to_wstring(ServerId);
+    }
+
+
+    /**
+    * \brief Writes a message to a peer
+    *
+    * This function connects to the peer if necessary. A peer that does not take a message in time gets
+    * disconnected, it detects the lost events by the gap in the sequence numbers.
+    *
+    * \param[in] Peer the peer
+    * \param[in] Message the message
+    * \param[in] Size size of the message in bytes, at most MAX_MESSAGE_SIZE
+    * \return bool true if the message was written
+    */
+    static bool WritePeer(Peer_t* Peer, const void* Message, size_t Size)
+    {
+        bool result = false;
+        OVERLAPPED overlapped = { 0 };
+        DWORD written = 0;
+
+        if (INVALID_HANDLE_VALUE == Peer->pipe)
+        {
+            Peer->pipe = OpenClientPipe(Peer->pipeName);
+        }
+
+        if (INVALID_HANDLE_VALUE != Peer->pipe)
+        {
+            overlapped.hEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+
+            if (NULL != overlapped.hEvent)
+            {
+                if ((TRUE == WriteFile(Peer->pipe, Message, (DWORD)Size, NULL, &overlapped)) ||
+                    (ERROR_IO_PENDING == GetLastError()))
+                {
+                    if (WAIT_OBJECT_0 != WaitForSingleObject(overlapped.hEvent, WRITE_TIMEOUT_MS))
+                    {
+                        CancelIo(Peer->pipe);
+                    }
+
+                    result = (TRUE == GetOverlappedResult(Peer->pipe, &overlapped, &written, TRUE));
+                }
+
+                CloseHandle(overlapped.hEvent);
+            }
+
+            if (false == result)
+            {
+                CloseHandle(Peer->pipe);
+                Peer->pipe = INVALID_HANDLE_VALUE;
+            }
+        }
+
+        return result;
+    }
+
+
+    /**
+    * \brief Creates a new connection
+    *
+    * \param[in] Name name of the pipe of this server
+    * \param[in] IsFirstInstance true if no other connection of this server exists
+    * \return std::unique_ptr<Connection_t> the connection, nullptr on error
+    */
+    static std::unique_ptr<Connection_t> CreateConnection(const std::wstring& Name, bool IsFirstInstance)
+    {
+        std::unique_ptr<Connection_t> connection = std::make_unique<Connection_t>();
+
+        connection->pipe = CreateServerPipe(Name, PIPE_BUFFER_SIZE, IsFirstInstance);
+        connection->overlapped = { 0 };
+        connection->isPending = false;
+
+        if (INVALID_HANDLE_VALUE == connection->pipe)
+        {
+            Log::GetLog()->error("EventBus: could not create pipe, error {}", GetLastError());
+            return nullptr;
+        }
+
+        connection->overlapped.hEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+
+        if (NULL == connection->overlapped.hEvent)
+        {
+            CloseHandle(connection->pipe);
+            return nullptr;
+        }
+
+        return connection;
+    }
+
+
+    /**
+    * \brief Closes a connection
+    *
+    * \param[in] Connection the connection, a pending operation gets cancelled
+    * \return void
+    */
+    static void CloseConnection(Connection_t* Connection)
+    {
+        DWORD transferred;
+
+        if (true == Connection->isPending)
+        {
+            CancelIo(Connection->pipe);
+            GetOverlappedResult(Connection->pipe, &Connection->overlapped, &transferred, TRUE);
+        }
+
+        CloseHandle(Connection->overlapped.hEvent);
+        CloseHandle(Connection->pipe);
+    }
+
+
+    /**
+    * \brief Starts to wait for a peer on a connection
+    *
+    * \param[in] Connection the connection, its event gets signaled when a peer connected
+    * \return bool true on success
+    */
+    static bool StartListen(Connection_t* Connection)
+    {
+        bool result = true;
+
+        ResetEvent(Connection->overlapped.hEvent);
+        Connection->isPending = false;
+
+        if (FALSE == ConnectNamedPipe(Connection->pipe, &Connection->overlapped))
+        {
+            switch (GetLastError())
+            {
+            case ERROR_IO_PENDING:
+                Connection->isPending = true;
+                break;
+            case ERROR_PIPE_CONNECTED:
+                SetEvent(Connection->overlapped.hEvent);
+                break;
+            default:
+                result = false;
+                break;
+            }
+        }
+
+        return result;
+    }
+
+
+    /**
+    * \brief Starts to read the next message of a connection
+    *
+    * \param[in] Connection the connection, its event gets signaled when the message was read
+    * \return bool true on success
+    */
+    static bool StartRead(Connection_t* Connection)
+    {
+        bool result = true;
+
+        ResetEvent(Connection->overlapped.hEvent);
+        Connection->isPending = true;
+
+        if ((FALSE == ReadFile(Connection->pipe, Connection->buffer, sizeof(Connection->buffer), NULL, &Connection->overlapped)) &&
+            (ERROR_IO_PENDING != GetLastError()))
+        {
+            Connection->isPending = false;
+            result = false;
+        }
+
+        return result;
+    }
+
+
+    /* ===================================== [definition of global functions] ===================================== */
+
+    /**
+    * \brief Creates an instance of the pipe of this server
+    *
+    * The DACL of the pipe grants access to the account of the server only and remote clients are rejected. 
+    * The first instance fails if an other process already owns the name, so the events can not be taken over
+    * by a pipe that was created before.
+    *
+    * \param[in] Name name of the pipe
+    * \param[in] InBufferSize size of the input buffer in bytes
+    * \param[in] IsFirstInstance true if no other instance of this server exists
+    * \return HANDLE the pipe, INVALID_HANDLE_VALUE on error, see GetLastError
+    */
+    HANDLE CreateServerPipe(const std::wstring& Name, DWORD InBufferSize, bool IsFirstInstance)
+    {
+        std::vector<uint8_t> user;
+        std::vector<uint8_t> acl;
+        SECURITY_DESCRIPTOR descriptor;
+        SECURITY_ATTRIBUTES attributes;
+        PSID sid;
+
+        if (false == GetProcessUser(&user))
+        {
+            return INVALID_HANDLE_VALUE;
+        }
+
+        sid = reinterpret_cast<TOKEN_USER*>(user.data())->User.Sid;
+        acl.resize(sizeof(ACL) + sizeof(ACCESS_ALLOWED_ACE) - sizeof(DWORD) + GetLengthSid(sid));
+
+        if ((FALSE == InitializeAcl(reinterpret_cast<PACL>(acl.data()), (DWORD)acl.size(), ACL_REVISION)) ||
+            (FALSE == AddAccessAllowedAce(reinterpret_cast<PACL>(acl.data()), ACL_REVISION, FILE_ALL_ACCESS, sid)) ||
+            (FALSE == InitializeSecurityDescriptor(&descriptor, SECURITY_DESCRIPTOR_REVISION)) ||
+            (FALSE == SetSecurityDescriptorDacl(&descriptor, TRUE, reinterpret_cast<PACL>(acl.data()), FALSE)))
+        {
+            return INVALID_HANDLE_VALUE;
+        }
+
+        attributes.nLength = sizeof(attributes);
+        attributes.lpSecurityDescriptor = &descriptor;
+        attributes.bInheritHandle = FALSE;
+
+        return CreateNamedPipeW(Name.c_str(), PIPE_ACCESS_INBOUND | FILE_FLAG_OVERLAPPED | ((true == IsFirstInstance) ? FILE_FLAG_FIRST_PIPE_INSTANCE : 0),
+            PIPE_TYPE_MESSAGE | PIPE_READMODE_MESSAGE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS, PIPE_UNLIMITED_INSTANCES, 0, InBufferSize, 0, &attributes);
+    }
+
+
+    /**
+    * \brief Opens the pipe of a peer
+    *
+    * The peer can identify this server but not impersonate it.
+    *
+    * \param[in] Name name of the pipe
+    * \return HANDLE the pipe, INVALID_HANDLE_VALUE on error, see GetLastError
+    */
+    HANDLE OpenClientPipe(const std::wstring& Name)
+    {
+        return CreateFileW(Name.c_str(), GENERIC_WRITE, 0, NULL, OPEN_EXISTING, 
+            FILE_FLAG_OVERLAPPED | SECURITY_SQOS_PRESENT | SECURITY_IDENTIFICATION, NULL);
+    }
+
+
+    /**
+    * \brief Creates the transport of the event bus over named pipes
+    *
+    * \return std::unique_ptr<EventBus::EventTransport> the transport
+    */
+    std::unique_ptr<EventBus::EventTransport> CreatePipeTransport(void)
+    {
+        return std::make_unique<PipeTransport>();
+    }
+
+
+    /* =====================================[class PipeTransport implementation]================================== */
+
+    /**
+    * \brief Destructor, closes the transport
+    */
+    PipeTransport::~PipeTransport()
+    {
+        Close();
+    }
+
+
+    /**
+    * \brief Main loop of the receiver thread
+    *
+    * This function serves all connections of the peers and one listening connection in a single thread 
+    * until the stop event gets signaled.
+    *
+    * \return void
+    */
+    void PipeTransport::ReceiveLoop()
+    {
+        std::vector<std::unique_ptr<Connection_t>> connections;
+        std::unique_ptr<Connection_t> listener;
+        HANDLE waitHandles[MAXIMUM_WAIT_OBJECTS];
+        bool isRunning = true;
+
+        while (true == isRunning)
+        {
+            DWORD numOfHandles = 0;
+            DWORD firstConnection;
+            DWORD transferred = 0;
+            DWORD waitResult;
+            DWORD index;
+
+            if ((nullptr == listener) && (MAX_CONNECTIONS > connections.size()))
+            {
+                listener = CreateConnection(localPipeName, connections.empty());
+
+                if ((nullptr != listener) && (false == StartListen(listener.get())))
+                {
+                    CloseConnection(listener.get());
+                    listener.reset();
+                }
+            }
+
+            waitHandles[numOfHandles++] = stopEvent;
+            if (nullptr != listener)
+            {
+                waitHandles[numOfHandles++] = listener->overlapped.hEvent;
+            }
+            firstConnection = numOfHandles;
+            for (const auto& connection : connections)
+            {
+                waitHandles[numOfHandles++] = connection->overlapped.hEvent;
+            }
+
+            /* retry to create the listener from time to time if it failed */
+            waitResult = WaitForMultipleObjects(numOfHandles, waitHandles, FALSE, (nullptr == listener) ? 1000 : INFINITE);
+
+            if (WAIT_TIMEOUT == waitResult)
+            {
+                continue;
+            }
+
+            index = waitResult - WAIT_OBJECT_0;
+
+            if ((0 == index) || (numOfHandles <= index))
+            {
+                isRunning = false;
+            }
+            else if (firstConnection > index)
+            {
+                /* a peer connected */
+                if ((false == listener->isPending) || (TRUE == GetOverlappedResult(listener->pipe, &listener->overlapped, &transferred, FALSE)))
+                {
+                    if (true == StartRead(listener.get()))
+                    {
+                        connections.push_back(std::move(listener));
+                    }
+                }
+
+                if (nullptr != listener)
+                {
+                    listener->isPending = false;
+                    CloseConnection(listener.get());
+                }
+                listener.reset();
+            }
+            else
+            {
+                /* a peer sent a message or disconnected */
+                Connection_t* connection = connections[index - firstConnection].get();
+
+                connection->isPending = false;
+
+                if (TRUE == GetOverlappedResult(connection->pipe, &connection->overlapped, &transferred, FALSE))
+                {
+                    onReceive(connection->buffer, transferred);
+
+                    if (true == StartRead(connection))
+                    {
+                        continue;
+                    }
+                }
+
+                CloseConnection(connection);
+                connections.erase(connections.begin() + (index - firstConnection));
+            }
+        }
+
+        if (nullptr != listener)
+        {
+            CloseConnection(listener.get());
+        }
+
+        for (const auto& connection : connections)
+        {
+            CloseConnection(connection.get());
+        }
+    }
+
+
+    /**
+    * \brief Opens the pipe of this server and starts the receiver thread
+    *
+    * \param[in] Channel name of the cluster channel
+    * \param[in] ServerId id of this server
+    * \param[in] PeerIds ids of the other servers of the cluster
+    * \param[in] OnReceive receiver of the messages, called by the receiver thread
+    * \return bool true on success
+    */
+    bool PipeTransport::Open(const std::string& Channel, int ServerId, const std::vector<int>& PeerIds, const EventBus::ReceiveCallback_t& OnReceive)
+    {
+        stopEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+        if (NULL == stopEvent)
+        {
+            Log::GetLog()->error("EventBus: could not create stop event, error {}", GetLastError());
+            return false;
+        }
+
+        localPipeName = GetPipeName(Channel, ServerId);
+        onReceive = OnReceive;
+
+        peers.clear();
+        for (int peerId : PeerIds)
+        {
+            if (ServerId != peerId)
+            {
+                peers.push_back({ GetPipeName(Channel, peerId), INVALID_HANDLE_VALUE });
+            }
+        }
+
+        receiverThread = std::thread(&PipeTransport::ReceiveLoop, this);
+
+        return true;
+    }
+
+
+    /**
+    * \brief Sends a message to all peers
+    *
+    * \param[in] Message the message
+    * \param[in] Size size of the message in bytes, at most MAX_MESSAGE_SIZE
+    * \return void
+    */
+    void PipeTransport::Send(const void* Message, size_t Size)
+    {
+        for (Peer_t& peer : peers)
+        {
+            WritePeer(&peer, Message, Size);
+        }
+    }
+
+
+    /**
+    * \brief Stops the receiver thread and closes all pipes
+    *
+    * \return void
+    */
+    void PipeTransport::Close()
+    {
+        if (NULL == stopEvent)
+        {
+            return;
+        }
+
+        SetEvent(stopEvent);
+        receiverThread.join();
+
+        for (Peer_t& peer : peers)
+        {
+            if (INVALID_HANDLE_VALUE != peer.pipe)
+            {
+                CloseHandle(peer.pipe);
+                peer.pipe = INVALID_HANDLE_VALUE;
+            }
+        }
+
+        CloseHandle(stopEvent);
+        stopEvent = NULL;
+    }
+}
+
+/* =================================================[end of file]================================================= */
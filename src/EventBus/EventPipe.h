@@ -0,0 +1,51 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file EventPipe.h
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 19 October 2026
+* \brief Named pipes of the event bus, the transport of the event bus on Windows
+*
+*/
+
+#ifndef EVENTPIPE_H
+#define EVENTPIPE_H
+
+/* ================================================[includes]================================================ */
+#include "EventTransport.h"
+#include <Windows.h>
+#include <memory>
+#include <string>
+
+
+namespace EventPipe
+{
+    /* ================================================[declaration of public functions]========================= */
+
+    extern HANDLE CreateServerPipe(const std::wstring& Name, DWORD InBufferSize, bool IsFirstInstance);
+    extern HANDLE OpenClientPipe(const std::wstring& Name);
+    extern std::unique_ptr<EventBus::EventTransport> CreatePipeTransport();
+}
+
+
+#endif /* EVENTPIPE_H */
+
+/* =================================================[end of file]================================================= */
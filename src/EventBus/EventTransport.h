@@ -0,0 +1,68 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file EventTransport.h
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 19 October 2026
+* \brief Transport of the messages of the event bus between the servers of a cluster
+*
+*/
+
+#ifndef EVENTTRANSPORT_H
+#define EVENTTRANSPORT_H
+
+/* ================================================[includes]================================================ */
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+
+namespace EventBus
+{
+    /* ================================================[declaration of public types]============================= */
+
+    /** \brief receiver of the messages of the peers, called by a thread of the transport */
+    typedef std::function<void(const void* Message, size_t Size)> ReceiveCallback_t;
+
+
+    /*!
+    * Transport of the messages between the servers of a cluster. Send is only called by the sender thread of 
+    * the event bus, the receive callback may be called by any thread between Open and Close.
+    */
+    class EventTransport
+    {
+    public:
+        virtual ~EventTransport() = default;
+
+        /*!
+        * transport interfaces; see implementations for further information
+        */
+        virtual bool Open(const std::string& Channel, int ServerId, const std::vector<int>& PeerIds, const ReceiveCallback_t& OnReceive) = 0;
+        virtual void Send(const void* Message, size_t Size) = 0;
+        virtual void Close() = 0;
+    };
+}
+
+
+#endif /* EVENTTRANSPORT_H */
+
+/* =================================================[end of file]================================================= */
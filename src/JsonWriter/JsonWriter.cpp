@@ -0,0 +1,291 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file JsonWriter.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Compact json serialization into a buffer
+*
+*/
+
+
+/* ================================================[includes]================================================ */
+
+#include "JsonWriter.h"
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+
+
+/* =====================================[class JsonWriter implementation]===================================== */
+
+/**
+* \brief Begins a value
+*
+* Writes the separator between two values of an array or two members of an object
+*
+* \return void
+*/
+void JsonWriter::BeginValue()
+{
+    if (true == needsSeparator)
+    {
+        buffer += ',';
+    }
+    needsSeparator = true;
+}
+
+
+/**
+* \brief Begins an object
+*
+* \return void
+*/
+void JsonWriter::BeginObject()
+{
+    BeginValue();
+    buffer += '{';
+    needsSeparator = false;
+}
+
+
+/**
+* \brief Ends an object
+*
+* \return void
+*/
+void JsonWriter::EndObject()
+{
+    buffer += '}';
+    needsSeparator = true;
+}
+
+
+/**
+* \brief Begins an array
+*
+* \return void
+*/
+void JsonWriter::BeginArray()
+{
+    BeginValue();
+    buffer += '[';
+    needsSeparator = false;
+}
+
+
+/**
+* \brief Ends an array
+*
+* \return void
+*/
+void JsonWriter::EndArray()
+{
+    buffer += ']';
+    needsSeparator = true;
+}
+
+
+/**
+* \brief Writes the key of an object member
+*
+* \param[in] Name the key, it is written without escaping
+* \return void
+*/
+void JsonWriter::Key(const char* Name)
+{
+    BeginValue();
+    buffer += '"';
+    buffer += Name;
+    buffer += "\":";
+    needsSeparator = false;
+}
+
+
+/**
+* \brief Writes a signed number
+*
+* \param[in] Value the number
+* \return void
+*/
+void JsonWriter::Int(int64_t Value)
+{
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), Value);
+
+    BeginValue();
+    buffer.append(digits, result.ptr);
+}
+
+
+/**
+* \brief Writes an unsigned number
+*
+* \param[in] Value the number
+* \return void
+*/
+void JsonWriter::UInt(uint64_t Value)
+{
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), Value);
+
+    BeginValue();
+    buffer.append(digits, result.ptr);
+}
+
+
+/**
+* \brief Writes a floating point number
+*
+* Json has no infinity and no NaN, they are written as null
+*
+* \param[in] Value the number
+* \return void
+*/
+void JsonWriter::Double(double Value)
+{
+    /* the largest double has 309 digits before the decimal point */
+    char digits[320];
+    int length = snprintf(digits, sizeof(digits), "%.3f", Value);
+
+    BeginValue();
+    if (false == std::isfinite(Value))
+    {
+        buffer += "null";
+    }
+    else if ((0 < length) && ((size_t)length < sizeof(digits)))
+    {
+        buffer.append(digits, (size_t)length);
+    }
+}
+
+
+/**
+* \brief Writes a boolean
+*
+* \param[in] Value the boolean
+* \return void
+*/
+void JsonWriter::Bool(bool Value)
+{
+    BeginValue();
+    buffer += (true == Value) ? "true" : "false";
+}
+
+
+/**
+* \brief Writes a string
+*
+* \param[in] Value the utf8 string, quotes, backslashes and control characters get escaped
+* \return void
+*/
+void JsonWriter::String(const char* Value)
+{
+    BeginValue();
+    buffer += '"';
+
+    for (const char* character = Value; (nullptr != character) && ('\0' != *character); character++)
+    {
+        if (('"' == *character) || ('\\' == *character))
+        {
+            buffer += '\\';
+            buffer += *character;
+        }
+        else if ((unsigned char)*character < 0x20)
+        {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned int)(unsigned char)*character);
+            buffer += escaped;
+        }
+        else
+        {
+            buffer += *character;
+        }
+    }
+
+    buffer += '"';
+}
+
+
+/**
+* \brief Clears the document
+*
+* The memory of the buffer is kept for the next document
+*
+* \return void
+*/
+void JsonWriter::Clear()
+{
+    buffer.clear();
+    needsSeparator = false;
+}
+
+
+/**
+* \brief Gets the serialized document
+*
+* \return const std::string& the document
+*/
+const std::string& JsonWriter::GetBuffer() const
+{
+    return buffer;
+}
+
+
+/**
+* \brief Gets the length of a part of the document
+*
+* Long documents are sent in parts, a part never ends within a multi-byte utf-8 character. Only invalid utf-8 
+* without a lead byte in the whole part is cut at MaxLength.
+*
+* \param[in] Position start of the part in the document
+* \param[in] MaxLength maximum length of the part in bytes
+* \return size_t length of the part in bytes, 0 at the end of the document
+*/
+size_t JsonWriter::GetPartLength(size_t Position, size_t MaxLength) const
+{
+    size_t length = 0;
+
+    if (Position < buffer.size())
+    {
+        length = buffer.size() - Position;
+
+        if (length > MaxLength)
+        {
+            length = MaxLength;
+
+            /* the part ends before the lead byte of the character at the cut, continuation bytes are 10xxxxxx */
+            while ((0 < length) && (0x80 == ((unsigned char)buffer[Position + length] & 0xC0)))
+            {
+                length--;
+            }
+
+            if (0 == length)
+            {
+                length = MaxLength;
+            }
+        }
+    }
+
+    return length;
+}
+
+/* =================================================[end of file]================================================= */
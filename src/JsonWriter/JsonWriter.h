@@ -0,0 +1,73 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file JsonWriter.h
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Compact json serialization into a buffer
+*
+*/
+
+#ifndef JSONWRITER_H
+#define JSONWRITER_H
+
+/* ================================================[includes]================================================ */
+#include <cstdint>
+#include <string>
+
+
+/*!
+* Writer for compact json, the document is appended directly to a string buffer
+*/
+class JsonWriter
+{
+private:
+    /*! the serialized document */
+    std::string buffer;
+
+    /*! true if the next value needs a separating comma */
+    bool needsSeparator = false;
+
+    void BeginValue();
+
+public:
+    /*!
+    * json interfaces; see implementation for further information
+    */
+    void BeginObject();
+    void EndObject();
+    void BeginArray();
+    void EndArray();
+    void Key(const char* Name);
+    void Int(int64_t Value);
+    void UInt(uint64_t Value);
+    void Double(double Value);
+    void Bool(bool Value);
+    void String(const char* Value);
+    void Clear();
+    const std::string& GetBuffer() const;
+    size_t GetPartLength(size_t Position, size_t MaxLength) const;
+};
+
+
+#endif /* JSONWRITER_H */
+
+/* =================================================[end of file]================================================= */
@@ -0,0 +1,173 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file OutputCache.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Cache for the rendered slot cooldown output of tribes
+*
+* The output of a tribe only changes every second or if the slots of the tribe change. 
+* Entries are keyed by tribe and second of the unix time and get dropped on a slot change.
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "OutputCache.h"
+#include "Statistics.h"
+#include <unordered_map>
+
+
+namespace OutputCache
+{
+    /* ========================================== [local defines] =============================================== */
+
+    /** \brief number of entries at which outdated entries get removed */
+    #define MAX_CACHED_OUTPUTS (size_t)1024
+
+
+    /* ============================================ [type definitions] ============================================ */
+
+    /**
+    *  \brief cached output of a tribe
+    */
+    typedef struct
+    {
+        int64_t unixTime;       /**< \brief second of the unix time the output was rendered for */
+        FString output;         /**< \brief the rendered output */
+
+    }CachedOutput_t;
+
+
+    /* =============================================== [local data] =============================================== */
+
+    /** \brief cached outputs by tribe id */
+    static std::unordered_map<int, CachedOutput_t> CachedOutputs;
+
+
+    /* ===================================== [prototype of local functions] ======================================= */
+
+    static void RemoveOutdatedOutputs(int64_t UnixTime);
+
+
+    /* ===================================== [definition of local functions] ====================================== */
+
+    /**
+    * \brief Removes outdated outputs
+    *
+    * This function removes all outputs that were rendered for an other second
+    *
+    * \param[in] UnixTime the current unix time
+    * \return void
+    */
+    static void RemoveOutdatedOutputs(int64_t UnixTime)
+    {
+        for (auto it = CachedOutputs.begin(); it != CachedOutputs.end();)
+        {
+            if (it->second.unixTime != UnixTime)
+            {
+                it = CachedOutputs.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+
+    /* ===================================== [definition of global functions] ===================================== */
+
+    /**
+    * \brief Gets a cached output
+    *
+    * This function looks for an output of a given tribe that was rendered in the same second
+    *
+    * \param[in] TribeId the given tribe
+    * \param[in] UnixTime the current unix time in seconds
+    * \param[out] Output the cached output
+    * \return true if a cached output was found, otherwise false
+    */
+    bool GetCachedOutput(int TribeId, int64_t UnixTime, FString* Output)
+    {
+        bool result = false;
+        auto it = CachedOutputs.find(TribeId);
+
+        if ((nullptr != Output) && (it != CachedOutputs.end()) && (it->second.unixTime == UnixTime))
+        {
+            *Output = it->second.output;
+            result = true;
+        }
+
+        Statistics::Increment((true == result) ? Statistics::OutputCacheHit : Statistics::OutputCacheMiss);
+
+        return result;
+    }
+
+
+    /**
+    * \brief Stores an output
+    *
+    * This function stores the rendered output of a given tribe
+    *
+    * \param[in] TribeId the given tribe
+    * \param[in] UnixTime the unix time in seconds the output was rendered for
+    * \param[in] Output the rendered output
+    * \return void
+    */
+    void StoreOutput(int TribeId, int64_t UnixTime, const FString& Output)
+    {
+        if (MAX_CACHED_OUTPUTS <= CachedOutputs.size())
+        {
+            RemoveOutdatedOutputs(UnixTime);
+        }
+
+        CachedOutputs[TribeId] = { UnixTime, Output };
+    }
+
+
+    /**
+    * \brief Invalidates the output of a tribe
+    *
+    * This function has to be called every time the slots of a tribe change
+    *
+    * \param[in] TribeId the given tribe
+    * \return void
+    */
+    void InvalidateTribe(int TribeId)
+    {
+        CachedOutputs.erase(TribeId);
+    }
+
+
+    /**
+    * \brief Invalidates all outputs
+    *
+    * \return void
+    */
+    void InvalidateAll(void)
+    {
+        CachedOutputs.clear();
+    }
+}
+
+/* =================================================[end of file]================================================= */
@@ -0,0 +1,49 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file OutputCache.h
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Cache for the rendered slot cooldown output of tribes
+*
+*/
+
+#ifndef OUTPUTCACHE_H
+#define OUTPUTCACHE_H
+
+/* ================================================[includes]================================================ */
+#include <API/ARK/Ark.h>
+
+
+namespace OutputCache
+{
+    /* ================================================[declaration of public functions]========================= */
+
+    extern bool GetCachedOutput(int TribeId, int64_t UnixTime, FString* Output);
+    extern void StoreOutput(int TribeId, int64_t UnixTime, const FString& Output);
+    extern void InvalidateTribe(int TribeId);
+    extern void InvalidateAll();
+}
+
+
+#endif /* OUTPUTCACHE_H */
+
+/* =================================================[end of file]================================================= */
@@ -0,0 +1,373 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file Prefetch.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Background reads of tribes into the tribe cache
+*
+* Tribes are read by a background thread with an own read only connection. The results are stored in the 
+* tribe cache by the game thread on the next lookup of a tribe that is not cached. A result is dropped if 
+* the tribe was invalidated after the request, the read may be outdated then. Tribes that got cached in the 
+* meantime are found in the tribe view and not read again. The requests are shared by the game thread and 
+* the prefetch thread, so the prefetch thread skips requests that got invalidated before their read.
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "Prefetch.h"
+#include "SlotCooldown.h"
+#include "TribeCache.h"
+#include "Statistics.h"
+#include "Clock.h"
+#include "TribeView.h"
+#include "ShardedTribeMap.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/* ========================================== [local defines] =============================================== */
+
+/** \brief maximum wait time of a read on a database locked by an other process in milliseconds */
+#define PREFETCH_BUSY_TIMEOUT_MS 1000
+
+
+namespace Prefetch
+{
+    /* ============================================ [type definitions] ============================================ */
+
+    /**
+    *  \brief requested read of a tribe
+    */
+    typedef struct
+    {
+        int tribeId;                /**< \brief the tribe */
+        uint64_t ticket;            /**< \brief number of the request */
+
+    }Request_t;
+
+
+    /**
+    *  \brief result of a read
+    */
+    typedef struct
+    {
+        int tribeId;                /**< \brief the tribe */
+        uint64_t ticket;            /**< \brief number of the request */
+        bool isValid;               /**< \brief false if the read failed */
+        bool isInDatabase;          /**< \brief true if the tribe has an entry in the database */
+        std::vector<int64_t> slots;     /**< \brief the stored slot cooldowns */
+
+    }Result_t;
+
+
+    /* =============================================== [local data] =============================================== */
+
+    /** \brief path of the database */
+    static std::string DatabaseFile;
+
+    /** \brief maximum number of requested tribes without result */
+    static size_t MaxPending = 0;
+
+    /** \brief number of the last request */
+    static uint64_t LastTicket = 0;
+
+    /** \brief requested tribes without result and the number of their request, changed only by the game thread */
+    static ShardedTribeMap<uint64_t> PendingTribes;
+
+    /** \brief requests for the prefetch thread */
+    static std::deque<Request_t> Requests;
+
+    /** \brief results of the prefetch thread */
+    static std::vector<Result_t> Results;
+
+    /** \brief true if Results is not empty, checked without the lock */
+    static std::atomic<bool> HasResults(false);
+
+    /** \brief true if the prefetch thread is running */
+    static bool IsRunning = false;
+
+    /** \brief true if the prefetch thread has to stop */
+    static bool StopWorker = false;
+
+    /** \brief protects Requests, Results and StopWorker */
+    static std::mutex QueueMutex;
+
+    /** \brief wakes up the prefetch thread */
+    static std::condition_variable QueueCondition;
+
+    /** \brief thread that reads the tribes */
+    static std::thread WorkerThread;
+
+
+    /* ===================================== [prototype of local functions] ======================================= */
+
+    static void ReadTribe(std::unique_ptr<sqlite::database>* Database, Result_t* Result);
+    static void WorkerLoop(void);
+
+
+    /* ===================================== [definition of local functions] ====================================== */
+
+    /**
+    * \brief Reads a tribe from the database
+    *
+    * The connection is opened on the first read and closed after an error
+    *
+    * \param[in,out] Database the read only connection of the prefetch thread
+    * \param[in,out] Result the result with the tribe to read
+    * \return void
+    */
+    static void ReadTribe(std::unique_ptr<sqlite::database>* Database, Result_t* Result)
+    {
+        try
+        {
+            if (nullptr == *Database)
+            {
+                sqlite::sqlite_config config;
+                config.flags = sqlite::OpenFlags::READONLY;
+
+                *Database = std::make_unique<sqlite::database>(DatabaseFile, config);
+
+                /* unlike the game thread the prefetch thread can wait for an other process */
+                sqlite3_busy_timeout((*Database)->connection().get(), PREFETCH_BUSY_TIMEOUT_MS);
+            }
+
+            **Database << "SELECT " DB_SLOTS_COLUMNS " FROM TribeSlots WHERE TribeId = ?;" << Result->tribeId 
+                >> [&](int IsLegacy, std::vector<int> LegacySlots, std::vector<int64_t> SlotsExpiry)
+            {
+                Result->isInDatabase = true;
+                Result->slots = std::move(SlotsExpiry);
+                DBHandler::DecodeSlots(IsLegacy, LegacySlots, &Result->slots);
+            };
+
+            Result->isValid = true;
+        }
+        catch (const sqlite::sqlite_exception& exception)
+        {
+            Log::GetLog()->error("({} {}) Unexpected DB error {}", __FILE__, __FUNCTION__, exception.what());
+            Database->reset();
+        }
+    }
+
+
+    /**
+    * \brief Main loop of the prefetch thread
+    *
+    * The connection is closed while there are no requests, it must not keep the database file open during
+    * an archive.
+    *
+    * \return void
+    */
+    static void WorkerLoop(void)
+    {
+        std::unique_ptr<sqlite::database> database;
+        std::unique_lock<std::mutex> lock(QueueMutex);
+
+        while (false == StopWorker)
+        {
+            QueueCondition.wait(lock, [] { return (true == StopWorker) || (false == Requests.empty()); });
+
+            while ((false == StopWorker) && (false == Requests.empty()))
+            {
+                Result_t result = { Requests.front().tribeId, Requests.front().ticket, false, false, std::vector<int64_t>() };
+                uint64_t ticket = 0;
+
+                Requests.pop_front();
+                lock.unlock();
+
+                /* the request may have been invalidated or the tribe read by the game thread, the result gets dropped */
+                if ((true == PendingTribes.Find(result.tribeId, &ticket)) && (ticket == result.ticket) && 
+                    (false == TribeView::ContainsTribe(result.tribeId)))
+                {
+                    ReadTribe(&database, &result);
+                }
+
+                lock.lock();
+
+                Results.push_back(std::move(result));
+                HasResults = true;
+            }
+
+            database.reset();
+        }
+    }
+
+
+    /* ===================================== [definition of global functions] ===================================== */
+
+    /**
+    * \brief Initialisation of the prefetch
+    *
+    * \param[in] DatabasePath path of the database
+    * \param[in] MaxPendingTribes maximum number of requested tribes without result, 0 disables the prefetch
+    * \return void
+    */
+    void InitPrefetch(const std::string& DatabasePath, int MaxPendingTribes)
+    {
+        DatabaseFile = DatabasePath;
+        MaxPending = (0 < MaxPendingTribes) ? (size_t)MaxPendingTribes : 0;
+
+        if ((0 < MaxPending) && (false == IsRunning))
+        {
+            StopWorker = false;
+            WorkerThread = std::thread(&WorkerLoop);
+            IsRunning = true;
+        }
+    }
+
+
+    /**
+    * \brief Remove of the prefetch
+    *
+    * This function stops the prefetch thread after the running read, open requests are dropped
+    *
+    * \return void
+    */
+    void RemovePrefetch(void)
+    {
+        if (true == IsRunning)
+        {
+            {
+                std::lock_guard<std::mutex> lock(QueueMutex);
+                StopWorker = true;
+            }
+
+            QueueCondition.notify_one();
+            WorkerThread.join();
+            IsRunning = false;
+        }
+
+        Requests.clear();
+        Results.clear();
+        HasResults = false;
+        PendingTribes.Clear();
+    }
+
+
+    /**
+    * \brief Requests the read of a tribe
+    *
+    * The request is dropped if the tribe can be looked up without the database, if it is already requested or 
+    * if too many tribes are requested
+    *
+    * \param[in] TribeId the tribe
+    * \return void
+    */
+    void RequestTribe(int TribeId)
+    {
+        if ((false == IsRunning) || (MaxPending <= PendingTribes.Size()) || (true == PendingTribes.Contains(TribeId)) ||
+            (true == TribeCache::IsTribeResident(TribeId)))
+        {
+            return;
+        }
+
+        LastTicket++;
+        PendingTribes.Insert(TribeId, LastTicket);
+
+        {
+            std::lock_guard<std::mutex> lock(QueueMutex);
+            Requests.push_back({ TribeId, LastTicket });
+        }
+
+        QueueCondition.notify_one();
+    }
+
+
+    /**
+    * \brief Stores the results of the prefetch thread in the tribe cache
+    *
+    * Nothing is stored while the database handler has changes that are not written to the database
+    *
+    * \return void
+    */
+    void ApplyResults(void)
+    {
+        std::vector<Result_t> results;
+
+        if (false == HasResults)
+        {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(QueueMutex);
+            results.swap(Results);
+            HasResults = false;
+        }
+
+        for (Result_t& result : results)
+        {
+            uint64_t ticket = 0;
+
+            if ((false == PendingTribes.Find(result.tribeId, &ticket)) || (ticket != result.ticket))
+            {
+                continue;
+            }
+
+            PendingTribes.Erase(result.tribeId);
+
+            if ((true == result.isValid) && (false == SlotCooldown::database->IsCircuitOpen()) && 
+                (0 == SlotCooldown::database->GetJournalSize()))
+            {
+                Clock::ConvertLegacySlots(&result.slots);
+
+                if (true == TribeCache::StoreTribe(result.tribeId, result.isInDatabase, result.slots, true))
+                {
+                    Statistics::Increment(Statistics::TribePrefetched);
+                }
+            }
+        }
+    }
+
+
+    /**
+    * \brief Invalidates a requested tribe
+    *
+    * This function has to be called every time the slots of a tribe change, a pending read is dropped
+    *
+    * \param[in] TribeId the tribe
+    * \return void
+    */
+    void InvalidateTribe(int TribeId)
+    {
+        PendingTribes.Erase(TribeId);
+    }
+
+
+    /**
+    * \brief Invalidates all requested tribes
+    *
+    * \return void
+    */
+    void InvalidateAll(void)
+    {
+        PendingTribes.Clear();
+    }
+}
+
+/* =================================================[end of file]================================================= */
@@ -0,0 +1,303 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file RateLimiter.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Token bucket rate limiting of player commands
+*
+* Every player owns a token bucket that is refilled with a constant rate. A command consumes one token, 
+* if the bucket is empty the command gets rejected. The buckets are stored in an open addressing hash table
+* keyed by the steam id, so a lookup touches a single cache line in the common case.
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "RateLimiter.h"
+#include <chrono>
+#include <vector>
+
+
+namespace RateLimiter
+{
+    /* ========================================== [local defines] =============================================== */
+
+    /** \brief initial number of buckets, has to be a power of two */
+    #define INITIAL_NUM_OF_BUCKETS (size_t)256
+
+    /** \brief marker for an unused bucket */
+    #define EMPTY_STEAM_ID (uint64_t)0
+
+
+    /* ============================================ [type definitions] ============================================ */
+
+    /**
+    *  \brief token bucket of a player
+    */
+    typedef struct
+    {
+        uint64_t steamId;       /**< \brief owner of the bucket, EMPTY_STEAM_ID if unused */
+        float tokens;           /**< \brief available tokens */
+        uint32_t lastRefill;    /**< \brief time of the last refill in milliseconds */
+
+    }TokenBucket_t;
+
+
+    /* =============================================== [local data] =============================================== */
+
+    /** \brief true if commands are rate limited */
+    static bool RateLimitEnabled = false;
+    /** \brief maximum number of tokens of a bucket */
+    static float MaxTokens = 1.0f;
+    /** \brief refill rate of the buckets */
+    static float TokensPerMillisecond = 0.0f;
+
+    /** \brief hash table with the buckets, size is a power of two */
+    static std::vector<TokenBucket_t> Buckets;
+    /** \brief number of used buckets */
+    static size_t NumOfUsedBuckets = 0;
+
+    /** \brief reference time of the rate limiter */
+    static std::chrono::steady_clock::time_point StartTime = std::chrono::steady_clock::now();
+
+
+    /* ===================================== [prototype of local functions] ======================================= */
+
+    static uint32_t GetTimeMs(void);
+    static size_t GetBucketIndex(uint64_t SteamId, size_t NumOfBuckets);
+    static TokenBucket_t* FindBucket(std::vector<TokenBucket_t>* Table, uint64_t SteamId);
+    static void RefillBucket(TokenBucket_t* Bucket, uint32_t Now);
+    static void Rehash(uint32_t Now);
+
+
+    /* ===================================== [definition of local functions] ====================================== */
+
+    /**
+    * \brief Gets the current time
+    *
+    * \return uint32_t milliseconds since the start of the rate limiter (wraps after 49 days)
+    */
+    static uint32_t GetTimeMs(void)
+    {
+        auto elapsed = std::chrono::steady_clock::now() - StartTime;
+
+        return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+    }
+
+
+    /**
+    * \brief Gets the bucket index of a steam id
+    *
+    * Steam ids only differ in the lower bits, so the id is mixed before it is mapped to the table
+    *
+    * \param[in] SteamId the steam id
+    * \param[in] NumOfBuckets size of the table, a power of two
+    * \return size_t the preferred index of the steam id
+    */
+    static size_t GetBucketIndex(uint64_t SteamId, size_t NumOfBuckets)
+    {
+        uint64_t hash = SteamId;
+
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdULL;
+        hash ^= hash >> 33;
+
+        return (size_t)hash & (NumOfBuckets - 1);
+    }
+
+
+    /**
+    * \brief Finds the bucket of a steam id
+    *
+    * This function returns either the bucket of the steam id or the unused bucket where it has to be inserted
+    *
+    * \param[in] Table the hash table, must contain at least one unused bucket
+    * \param[in] SteamId the steam id
+    * \return TokenBucket_t* the found bucket
+    */
+    static TokenBucket_t* FindBucket(std::vector<TokenBucket_t>* Table, uint64_t SteamId)
+    {
+        size_t mask = Table->size() - 1;
+        size_t index = GetBucketIndex(SteamId, Table->size());
+
+        while (((*Table)[index].steamId != SteamId) && ((*Table)[index].steamId != EMPTY_STEAM_ID))
+        {
+            index = (index + 1) & mask;
+        }
+
+        return &(*Table)[index];
+    }
+
+
+    /**
+    * \brief Refills a bucket
+    *
+    * \param[in/out] Bucket the bucket to refill
+    * \param[in] Now the current time in milliseconds
+    * \return void
+    */
+    static void RefillBucket(TokenBucket_t* Bucket, uint32_t Now)
+    {
+        uint32_t elapsed = Now - Bucket->lastRefill;
+
+        Bucket->tokens += (float)elapsed * TokensPerMillisecond;
+        if (Bucket->tokens > MaxTokens)
+        {
+            Bucket->tokens = MaxTokens;
+        }
+        Bucket->lastRefill = Now;
+    }
+
+
+    /**
+    * \brief Rebuilds the hash table
+    *
+    * Full buckets behave exactly like new ones, so they get dropped. The table grows only if it 
+    * is still more than half used afterwards.
+    *
+    * \param[in] Now the current time in milliseconds
+    * \return void
+    */
+    static void Rehash(uint32_t Now)
+    {
+        std::vector<TokenBucket_t> oldBuckets;
+        size_t numOfActiveBuckets = 0;
+        size_t numOfBuckets = INITIAL_NUM_OF_BUCKETS;
+
+        oldBuckets.swap(Buckets);
+
+        for (TokenBucket_t& bucket : oldBuckets)
+        {
+            if (EMPTY_STEAM_ID != bucket.steamId)
+            {
+                RefillBucket(&bucket, Now);
+                if (bucket.tokens < MaxTokens)
+                {
+                    numOfActiveBuckets++;
+                }
+                else
+                {
+                    bucket.steamId = EMPTY_STEAM_ID;
+                }
+            }
+        }
+
+        while (numOfBuckets < (numOfActiveBuckets * 2))
+        {
+            numOfBuckets *= 2;
+        }
+
+        Buckets.assign(numOfBuckets, { EMPTY_STEAM_ID, 0.0f, 0 });
+        NumOfUsedBuckets = numOfActiveBuckets;
+
+        for (const TokenBucket_t& bucket : oldBuckets)
+        {
+            if (EMPTY_STEAM_ID != bucket.steamId)
+            {
+                *FindBucket(&Buckets, bucket.steamId) = bucket;
+            }
+        }
+    }
+
+
+    /* ===================================== [definition of global functions] ===================================== */
+
+    /**
+    * \brief Initialisation of the rate limiter
+    *
+    * \param[in] Enabled true if commands shall be rate limited
+    * \param[in] BucketSize the maximum number of commands in a burst
+    * \param[in] TokensPerSecond the number of commands per second a player can use permanently
+    * \return void
+    */
+    void InitRateLimiter(bool Enabled, float BucketSize, float TokensPerSecond)
+    {
+        RateLimitEnabled = Enabled;
+        MaxTokens = (BucketSize < 1.0f) ? 1.0f : BucketSize;
+        TokensPerMillisecond = (TokensPerSecond < 0.0f) ? 0.0f : (TokensPerSecond / 1000.0f);
+
+        ClearRateLimiter();
+    }
+
+
+    /**
+    * \brief Consumes a token
+    *
+    * This function consumes a token of the bucket of a given player
+    *
+    * \param[in] SteamId the steam id of the player
+    * \return true if the command of the player is allowed, otherwise false
+    */
+    bool ConsumeToken(uint64_t SteamId)
+    {
+        bool result = true;
+
+        if ((true == RateLimitEnabled) && (EMPTY_STEAM_ID != SteamId))
+        {
+            uint32_t now = GetTimeMs();
+            TokenBucket_t* bucket = FindBucket(&Buckets, SteamId);
+
+            if (EMPTY_STEAM_ID == bucket->steamId)
+            {
+                /* keep the load factor below 3/4 to keep the probe sequences short */
+                if (((NumOfUsedBuckets + 1) * 4) > (Buckets.size() * 3))
+                {
+                    Rehash(now);
+                    bucket = FindBucket(&Buckets, SteamId);
+                }
+
+                *bucket = { SteamId, MaxTokens, now };
+                NumOfUsedBuckets++;
+            }
+            else
+            {
+                RefillBucket(bucket, now);
+            }
+
+            if (bucket->tokens >= 1.0f)
+            {
+                bucket->tokens -= 1.0f;
+            }
+            else
+            {
+                result = false;
+            }
+        }
+
+        return result;
+    }
+
+
+    /**
+    * \brief Removes all buckets
+    *
+    * \return void
+    */
+    void ClearRateLimiter(void)
+    {
+        Buckets.assign(INITIAL_NUM_OF_BUCKETS, { EMPTY_STEAM_ID, 0.0f, 0 });
+        NumOfUsedBuckets = 0;
+    }
+}
+
+/* =================================================[end of file]================================================= */
@@ -0,0 +1,221 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file RejectionCache.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Memoization of rejected tribe joins
+*
+* Clients retry a rejected tribe join several times a second. A rejection is remembered per player for 
+* a configurable window, retries within the window get rejected without evaluating the cooldowns again
+* and without sending the notification again.
+*
+* A rejection only holds for the member count of the tribe it was evaluated with. It ends early when the
+* first slot cooldown of the tribe ends, and it is forgotten when the slots of the tribe change.
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "RejectionCache.h"
+#include <chrono>
+#include <unordered_map>
+
+
+namespace RejectionCache
+{
+    /* ========================================== [local defines] =============================================== */
+
+    /** \brief number of entries at which expired entries get removed */
+    #define MAX_REJECTIONS (size_t)256
+
+
+    /* ============================================ [type definitions] ============================================ */
+
+    /**
+    *  \brief rejected tribe join of a player
+    */
+    typedef struct
+    {
+        int tribeId;                                        /**< \brief the tribe the player was not able to join */
+        int numOfMembers;                                   /**< \brief number of members of the tribe at the rejection */
+        std::chrono::steady_clock::time_point expiresAt;    /**< \brief end of the window of the rejection */
+
+    }Rejection_t;
+
+
+    /* =============================================== [local data] =============================================== */
+
+    /** \brief time a rejection is remembered */
+    static std::chrono::steady_clock::duration RejectionWindow = std::chrono::steady_clock::duration::zero();
+
+    /** \brief rejections by steam id */
+    static std::unordered_map<uint64_t, Rejection_t> Rejections;
+
+
+    /* ===================================== [prototype of local functions] ======================================= */
+
+    static void RemoveExpiredRejections(std::chrono::steady_clock::time_point Now);
+
+
+    /* ===================================== [definition of local functions] ====================================== */
+
+    /**
+    * \brief Removes expired rejections
+    *
+    * \param[in] Now the current time
+    * \return void
+    */
+    static void RemoveExpiredRejections(std::chrono::steady_clock::time_point Now)
+    {
+        for (auto it = Rejections.begin(); it != Rejections.end();)
+        {
+            if (it->second.expiresAt <= Now)
+            {
+                it = Rejections.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+
+    /* ===================================== [definition of global functions] ===================================== */
+
+    /**
+    * \brief Initialisation of the rejection cache
+    *
+    * \param[in] Window time in seconds a rejection is remembered, 0 disables the cache
+    * \return void
+    */
+    void InitRejectionCache(float Window)
+    {
+        if (Window > 0.0f)
+        {
+            RejectionWindow = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(Window));
+        }
+        else
+        {
+            RejectionWindow = std::chrono::steady_clock::duration::zero();
+        }
+
+        InvalidateAll();
+    }
+
+
+    /**
+    * \brief Checks for a remembered rejection
+    *
+    * \param[in] SteamId the player who likes to join
+    * \param[in] TribeId the tribe to join
+    * \param[in] NumOfMembers number of members of the tribe
+    * \return true if the join of the player was rejected within the window, otherwise false
+    */
+    bool IsJoinRejected(uint64_t SteamId, int TribeId, int NumOfMembers)
+    {
+        bool result = false;
+
+        if (false == Rejections.empty())
+        {
+            auto it = Rejections.find(SteamId);
+
+            if ((it != Rejections.end()) && (it->second.tribeId == TribeId) && (it->second.numOfMembers == NumOfMembers)
+                && (it->second.expiresAt > std::chrono::steady_clock::now()))
+            {
+                result = true;
+            }
+        }
+
+        return result;
+    }
+
+
+    /**
+    * \brief Remembers a rejection
+    *
+    * \param[in] SteamId the player who was not able to join
+    * \param[in] TribeId the tribe
+    * \param[in] NumOfMembers number of members of the tribe
+    * \param[in] SecondsUntilSlotFree time until the first slot cooldown of the tribe ends, 0 if no slot is on cooldown
+    * \return void
+    */
+    void StoreJoinRejection(uint64_t SteamId, int TribeId, int NumOfMembers, int64_t SecondsUntilSlotFree)
+    {
+        if (RejectionWindow > std::chrono::steady_clock::duration::zero())
+        {
+            auto now = std::chrono::steady_clock::now();
+            auto window = RejectionWindow;
+
+            /* the join is evaluated again as soon as a slot gets free */
+            if ((0 < SecondsUntilSlotFree) && (std::chrono::seconds(SecondsUntilSlotFree) < window))
+            {
+                window = std::chrono::seconds(SecondsUntilSlotFree);
+            }
+
+            if (MAX_REJECTIONS <= Rejections.size())
+            {
+                RemoveExpiredRejections(now);
+            }
+
+            Rejections[SteamId] = { TribeId, NumOfMembers, now + window };
+        }
+    }
+
+
+    /**
+    * \brief Forgets all rejections of a tribe
+    *
+    * This function has to be called every time the slots of a tribe change
+    *
+    * \param[in] TribeId the tribe
+    * \return void
+    */
+    void InvalidateTribe(int TribeId)
+    {
+        for (auto it = Rejections.begin(); it != Rejections.end();)
+        {
+            if (it->second.tribeId == TribeId)
+            {
+                it = Rejections.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+
+    /**
+    * \brief Forgets all rejections
+    *
+    * \return void
+    */
+    void InvalidateAll(void)
+    {
+        Rejections.clear();
+    }
+}
+
+/* =================================================[end of file]================================================= */
@@ -0,0 +1,50 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file RejectionCache.h
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Memoization of rejected tribe joins
+*
+*/
+
+#ifndef REJECTIONCACHE_H
+#define REJECTIONCACHE_H
+
+/* ================================================[includes]================================================ */
+#include <cstdint>
+
+
+namespace RejectionCache
+{
+    /* ================================================[declaration of public functions]========================= */
+
+    extern void InitRejectionCache(float Window);
+    extern bool IsJoinRejected(uint64_t SteamId, int TribeId, int NumOfMembers);
+    extern void StoreJoinRejection(uint64_t SteamId, int TribeId, int NumOfMembers, int64_t SecondsUntilSlotFree);
+    extern void InvalidateTribe(int TribeId);
+    extern void InvalidateAll();
+}
+
+
+#endif /* REJECTIONCACHE_H */
+
+/* =================================================[end of file]================================================= */
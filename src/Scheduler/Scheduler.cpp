@@ -0,0 +1,281 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file Scheduler.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Maintenance tasks on the game thread within a time slice per tick
+*
+* Maintenance that has to touch the state of the game thread is split into steps. Every tick the scheduler 
+* calls the steps of the due tasks in turn until the time slice is used up, the next tick continues with 
+* the following task. A step has to check the deadline itself and to resume where it stopped.
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "Scheduler.h"
+#include <API/ARK/Ark.h>
+#include <algorithm>
+
+
+namespace Scheduler
+{
+    /* ========================================== [local defines] =============================================== */
+
+    /** \brief id of the tick callback */
+    #define SCHEDULER_TICK_ID "TribeSlotCooldown.Scheduler"
+
+
+    /* ============================================ [type definitions] ============================================ */
+
+    /**
+    *  \brief registered task
+    */
+    typedef struct
+    {
+        TaskStep_t step;                                    /**< \brief step of the task */
+        std::chrono::steady_clock::duration interval;       /**< \brief time between the start of two runs */
+        std::chrono::steady_clock::time_point nextRun;      /**< \brief start of the next run */
+        bool isRemoved;                                     /**< \brief the task gets removed after the current tick */
+        TaskStatistics_t statistics;                        /**< \brief runtime statistics */
+
+    }Task_t;
+
+
+    /* =============================================== [local data] =============================================== */
+
+    /** \brief time slice per tick */
+    static std::chrono::microseconds Slice(0);
+
+    /** \brief true if the tick callback is registered */
+    static bool IsRunning = false;
+
+    /** \brief registered tasks */
+    static std::vector<Task_t> Tasks;
+
+    /** \brief tasks added by a step, they get registered after the current tick */
+    static std::vector<Task_t> AddedTasks;
+
+    /** \brief true while the steps of a tick are called */
+    static bool IsTicking = false;
+
+    /** \brief index of the task that gets the next step */
+    static size_t NextTask = 0;
+
+
+    /* ===================================== [prototype of local functions] ======================================= */
+
+    static void OnTick(float DeltaSeconds);
+
+
+    /* ===================================== [definition of local functions] ====================================== */
+
+    /**
+    * \brief Tick callback
+    *
+    * This function calls the steps of the due tasks until the time slice is used up. Every task gets at most 
+    * one step per tick.
+    *
+    * \param[in] DeltaSeconds variable is not used
+    * \return void
+    */
+    static void OnTick(float)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const auto deadline = start + Slice;
+        auto now = start;
+        size_t numOfTasks = Tasks.size();
+        size_t firstTask = NextTask;
+        size_t numOfVisitedTasks = 0;
+
+        IsTicking = true;
+
+        for (size_t i = 0; (i < numOfTasks) && (now < deadline); i++)
+        {
+            Task_t& task = Tasks[(firstTask + i) % numOfTasks];
+            numOfVisitedTasks = i + 1;
+
+            if ((true == task.isRemoved) || ((false == task.statistics.isRunning) && (now < task.nextRun)))
+            {
+                continue;
+            }
+
+            task.statistics.isRunning = true;
+
+            StepResult_t result = task.step(deadline);
+            auto end = std::chrono::steady_clock::now();
+            uint64_t stepTime = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(end - now).count();
+
+            task.statistics.steps++;
+            task.statistics.totalTime += stepTime;
+            task.statistics.maxStepTime = (std::max)(task.statistics.maxStepTime, stepTime);
+
+            if (end > deadline)
+            {
+                task.statistics.overruns++;
+            }
+
+            if (StepPending != result)
+            {
+                task.statistics.isRunning = false;
+                task.statistics.runs++;
+                task.nextRun = end + task.interval;
+                task.isRemoved = (StepFinished == result);
+            }
+
+            now = end;
+        }
+
+        IsTicking = false;
+
+        /* the next tick continues with the first task that was not visited in this tick */
+        if (0 < numOfTasks)
+        {
+            NextTask = (firstTask + numOfVisitedTasks) % numOfTasks;
+        }
+
+        Tasks.erase(std::remove_if(Tasks.begin(), Tasks.end(), [](const Task_t& Task) { return Task.isRemoved; }), Tasks.end());
+        Tasks.insert(Tasks.end(), std::make_move_iterator(AddedTasks.begin()), std::make_move_iterator(AddedTasks.end()));
+        AddedTasks.clear();
+    }
+
+
+    /* ===================================== [definition of global functions] ===================================== */
+
+    /**
+    * \brief Initialisation of the scheduler
+    *
+    * Tasks can be added before the initialisation, they start with the first tick
+    *
+    * \param[in] SliceMicroseconds time slice per tick in microseconds
+    * \return void
+    */
+    void InitScheduler(int SliceMicroseconds)
+    {
+        Slice = std::chrono::microseconds((0 < SliceMicroseconds) ? SliceMicroseconds : 1);
+
+        if (false == IsRunning)
+        {
+            ArkApi::GetCommands().AddOnTickCallback(SCHEDULER_TICK_ID, &OnTick);
+            IsRunning = true;
+        }
+    }
+
+
+    /**
+    * \brief Remove of the scheduler
+    *
+    * Runs that are not complete are dropped, the tasks have to continue with the next start of the plugin
+    *
+    * \return void
+    */
+    void RemoveScheduler(void)
+    {
+        if (true == IsRunning)
+        {
+            ArkApi::GetCommands().RemoveOnTickCallback(SCHEDULER_TICK_ID);
+            IsRunning = false;
+        }
+
+        Tasks.clear();
+        AddedTasks.clear();
+        NextTask = 0;
+    }
+
+
+    /**
+    * \brief Adds a task
+    *
+    * The first run starts with the next tick, a task with the same name gets replaced
+    *
+    * \param[in] Name name of the task
+    * \param[in] IntervalSeconds time between the start of two runs in seconds
+    * \param[in] Step step of the task
+    * \return void
+    */
+    void AddTask(const std::string& Name, int IntervalSeconds, const TaskStep_t& Step)
+    {
+        Task_t task = { Step, std::chrono::seconds(IntervalSeconds), std::chrono::steady_clock::now(), false, { Name, false, 0, 0, 0, 0, 0 } };
+
+        RemoveTask(Name);
+
+        if (true == IsTicking)
+        {
+            AddedTasks.push_back(std::move(task));
+        }
+        else
+        {
+            Tasks.push_back(std::move(task));
+        }
+    }
+
+
+    /**
+    * \brief Removes a task
+    *
+    * The task does not get any step afterwards, during a tick it is removed after the tick
+    *
+    * \param[in] Name name of the task
+    * \return void
+    */
+    void RemoveTask(const std::string& Name)
+    {
+        for (Task_t& task : Tasks)
+        {
+            if (task.statistics.name == Name)
+            {
+                task.isRemoved = true;
+            }
+        }
+
+        if (false == IsTicking)
+        {
+            Tasks.erase(std::remove_if(Tasks.begin(), Tasks.end(), [](const Task_t& Task) { return Task.isRemoved; }), Tasks.end());
+        }
+
+        AddedTasks.erase(std::remove_if(AddedTasks.begin(), AddedTasks.end(), 
+            [&Name](const Task_t& Task) { return Task.statistics.name == Name; }), AddedTasks.end());
+    }
+
+
+    /**
+    * \brief Gets the runtime statistics of all tasks
+    *
+    * \param[out] Statistics the statistics of the tasks
+    * \return void
+    */
+    void GetTaskStatistics(std::vector<TaskStatistics_t>* Statistics)
+    {
+        Statistics->clear();
+
+        for (const Task_t& task : Tasks)
+        {
+            if (false == task.isRemoved)
+            {
+                Statistics->push_back(task.statistics);
+            }
+        }
+    }
+}
+
+/* =================================================[end of file]================================================= */
@@ -0,0 +1,90 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file Scheduler.h
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Maintenance tasks on the game thread within a time slice per tick
+*
+*/
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+/* ================================================[includes]================================================ */
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+
+namespace Scheduler
+{
+    /* ================================================[type definitions]======================================== */
+
+    /**
+    *  \brief result of a step of a task
+    */
+    typedef enum
+    {
+        StepPending = 0,    /**< \brief the run is not complete, it is resumed with the next tick */
+        StepDone,           /**< \brief the run is complete, the next run starts after the interval */
+        StepFinished        /**< \brief the task has nothing left to do and gets removed */
+
+    }StepResult_t;
+
+
+    /**
+    *  \brief step of a task, it has to return before the deadline and to remember where it stopped
+    */
+    typedef std::function<StepResult_t(std::chrono::steady_clock::time_point Deadline)> TaskStep_t;
+
+
+    /**
+    *  \brief runtime statistics of a task
+    */
+    typedef struct
+    {
+        std::string name;           /**< \brief name of the task */
+        bool isRunning;             /**< \brief true if a run is not complete */
+        uint64_t runs;              /**< \brief number of completed runs */
+        uint64_t steps;             /**< \brief number of steps */
+        uint64_t overruns;          /**< \brief number of steps that returned after the deadline */
+        uint64_t totalTime;         /**< \brief runtime of all steps in microseconds */
+        uint64_t maxStepTime;       /**< \brief runtime of the longest step in microseconds */
+
+    }TaskStatistics_t;
+
+
+    /* ================================================[declaration of public functions]========================= */
+
+    extern void InitScheduler(int SliceMicroseconds);
+    extern void RemoveScheduler();
+    extern void AddTask(const std::string& Name, int IntervalSeconds, const TaskStep_t& Step);
+    extern void RemoveTask(const std::string& Name);
+    extern void GetTaskStatistics(std::vector<TaskStatistics_t>* Statistics);
+}
+
+
+#endif /* SCHEDULER_H */
+
+/* =================================================[end of file]================================================= */
@@ -0,0 +1,275 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file ShardedTribeMap.h
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Hash map by tribe id that can be used by several threads
+*
+* The tribes are spread over shards, every shard has its own lock. Threads that access different shards do
+* not wait for each other. The shards are aligned to cache lines, so their locks do not share one.
+*
+*/
+
+#ifndef SHARDEDTRIBEMAP_H
+#define SHARDEDTRIBEMAP_H
+
+/* ================================================[includes]================================================ */
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+
+/*!
+* Hash map by tribe id with one lock per shard
+*/
+template <typename Value_t>
+class ShardedTribeMap
+{
+private:
+    /*! size of a cache line */
+    static constexpr size_t CacheLineSize = 64;
+
+    /*! multiplier of the fibonacci hashing of the tribe ids */
+    static constexpr uint64_t HashMultiplier = 0x9E3779B97F4A7C15ULL;
+
+    /*!
+    * tribes of a shard and their lock
+    */
+    struct alignas(CacheLineSize) Shard_t
+    {
+        std::mutex mutex;
+        std::unordered_map<int, Value_t> tribes;
+    };
+
+    /*! the shards */
+    std::unique_ptr<Shard_t[]> shards;
+
+    /*! number of shards, a power of two */
+    size_t numOfShards = 2;
+
+    /*! shift of the hash to the shard index */
+    int shardShift = 63;
+
+    /*! number of tribes of all shards */
+    std::atomic<size_t> numOfTribes;
+
+    Shard_t& GetShard(int TribeId) const;
+
+public:
+    /*!
+    * sharded map interfaces; see implementation for further information
+    */
+    explicit ShardedTribeMap(size_t NumOfShards = 16);
+    ShardedTribeMap(const ShardedTribeMap&) = delete;
+    ShardedTribeMap& operator=(const ShardedTribeMap&) = delete;
+
+    bool Find(int TribeId, Value_t* Value) const;
+    bool Contains(int TribeId) const;
+    void Insert(int TribeId, const Value_t& Value);
+    bool Erase(int TribeId);
+    void Clear();
+    size_t Size() const;
+    void ForEach(const std::function<void(int, const Value_t&)>& Callback) const;
+};
+
+
+/* ===================================== [definition of member functions] ===================================== */
+
+/**
+* \brief Constructor
+*
+* \param[in] NumOfShards minimum number of shards, rounded up to a power of two
+*/
+template <typename Value_t>
+ShardedTribeMap<Value_t>::ShardedTribeMap(size_t NumOfShards) : numOfTribes(0)
+{
+    /* the shift of a 64 bit value has to be below 64, so there are at least two shards */
+    numOfShards = 2;
+
+    while (numOfShards < NumOfShards)
+    {
+        numOfShards <<= 1;
+        shardShift--;
+    }
+
+    shards = std::make_unique<Shard_t[]>(numOfShards);
+}
+
+
+/**
+* \brief Gets the shard of a tribe
+*
+* \param[in] TribeId the tribe
+* \return Shard_t& the shard of the tribe
+*/
+template <typename Value_t>
+typename ShardedTribeMap<Value_t>::Shard_t& ShardedTribeMap<Value_t>::GetShard(int TribeId) const
+{
+    return shards[(size_t)(((uint64_t)(uint32_t)TribeId * HashMultiplier) >> shardShift)];
+}
+
+
+/**
+* \brief Finds a tribe
+*
+* \param[in] TribeId the tribe
+* \param[out] Value the value of the tribe
+* \return bool true if the tribe was found, otherwise false
+*/
+template <typename Value_t>
+bool ShardedTribeMap<Value_t>::Find(int TribeId, Value_t* Value) const
+{
+    Shard_t& shard = GetShard(TribeId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.tribes.find(TribeId);
+
+    if (it == shard.tribes.end())
+    {
+        return false;
+    }
+
+    *Value = it->second;
+
+    return true;
+}
+
+
+/**
+* \brief Checks if a tribe is in the map
+*
+* \param[in] TribeId the tribe
+* \return bool true if the tribe was found, otherwise false
+*/
+template <typename Value_t>
+bool ShardedTribeMap<Value_t>::Contains(int TribeId) const
+{
+    Shard_t& shard = GetShard(TribeId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    return (shard.tribes.end() != shard.tribes.find(TribeId));
+}
+
+
+/**
+* \brief Inserts a tribe or replaces its value
+*
+* \param[in] TribeId the tribe
+* \param[in] Value the value of the tribe
+* \return void
+*/
+template <typename Value_t>
+void ShardedTribeMap<Value_t>::Insert(int TribeId, const Value_t& Value)
+{
+    Shard_t& shard = GetShard(TribeId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    if (true == shard.tribes.insert_or_assign(TribeId, Value).second)
+    {
+        numOfTribes++;
+    }
+}
+
+
+/**
+* \brief Erases a tribe
+*
+* \param[in] TribeId the tribe
+* \return bool true if the tribe was in the map, otherwise false
+*/
+template <typename Value_t>
+bool ShardedTribeMap<Value_t>::Erase(int TribeId)
+{
+    Shard_t& shard = GetShard(TribeId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    if (0 == shard.tribes.erase(TribeId))
+    {
+        return false;
+    }
+
+    numOfTribes--;
+
+    return true;
+}
+
+
+/**
+* \brief Erases all tribes
+*
+* The shards are cleared one after the other, tribes inserted meanwhile into cleared shards are kept
+*
+* \return void
+*/
+template <typename Value_t>
+void ShardedTribeMap<Value_t>::Clear()
+{
+    for (size_t i = 0; i < numOfShards; i++)
+    {
+        std::lock_guard<std::mutex> lock(shards[i].mutex);
+
+        numOfTribes -= shards[i].tribes.size();
+        shards[i].tribes.clear();
+    }
+}
+
+
+/**
+* \brief Gets the number of tribes
+*
+* \return size_t number of tribes, it may be outdated while other threads change the map
+*/
+template <typename Value_t>
+size_t ShardedTribeMap<Value_t>::Size() const
+{
+    return numOfTribes;
+}
+
+
+/**
+* \brief Iterates over the tribes
+*
+* Every shard is locked during its iteration, the callback must not access the map
+*
+* \param[in] Callback function that gets called with the tribe id and its value
+* \return void
+*/
+template <typename Value_t>
+void ShardedTribeMap<Value_t>::ForEach(const std::function<void(int, const Value_t&)>& Callback) const
+{
+    for (size_t i = 0; i < numOfShards; i++)
+    {
+        std::lock_guard<std::mutex> lock(shards[i].mutex);
+
+        for (const auto& tribe : shards[i].tribes)
+        {
+            Callback(tribe.first, tribe.second);
+        }
+    }
+}
+
+
+#endif /* SHARDEDTRIBEMAP_H */
+
+/* =================================================[end of file]================================================= */
@@ -0,0 +1,137 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file Shutdown.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Deadline of the orderly shutdown
+*
+* The unload of the plugin drains the pending work of the background threads and checkpoints the database.
+* All of it is bounded by one deadline, work that is left at the deadline gets dropped and logged, so a 
+* slow disk can not stall the server shutdown.
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "Shutdown.h"
+#include "API/ARK/Ark.h"
+#include <atomic>
+#include <chrono>
+
+
+namespace Shutdown
+{
+    /* =============================================== [local data] =============================================== */
+
+    /** \brief true while the plugin shuts down */
+    static std::atomic<bool> IsShutdownActive(false);
+
+    /** \brief start of the shutdown */
+    static std::chrono::steady_clock::time_point ShutdownStart;
+
+    /** \brief deadline of the shutdown, written before IsShutdownActive is set */
+    static std::chrono::steady_clock::time_point ShutdownDeadline;
+
+    /** \brief true if work was dropped at the deadline */
+    static std::atomic<bool> IsWorkDropped(false);
+
+
+    /* ===================================== [definition of global functions] ===================================== */
+
+    /**
+    * \brief Begins the shutdown
+    *
+    * \param[in] DeadlineMs time for the whole shutdown in milliseconds
+    * \return void
+    */
+    void BeginShutdown(int DeadlineMs)
+    {
+        ShutdownStart = std::chrono::steady_clock::now();
+        ShutdownDeadline = ShutdownStart + std::chrono::milliseconds((0 < DeadlineMs) ? DeadlineMs : 0);
+        IsWorkDropped = false;
+        IsShutdownActive.store(true, std::memory_order_release);
+    }
+
+
+    /**
+    * \brief Ends the shutdown
+    *
+    * \return void
+    */
+    void EndShutdown(void)
+    {
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - ShutdownStart);
+
+        IsShutdownActive.store(false, std::memory_order_release);
+
+        if (true == IsWorkDropped)
+        {
+            Log::GetLog()->warn("Shutdown finished after {} ms, pending work was dropped at the deadline", duration.count());
+        }
+        else
+        {
+            Log::GetLog()->info("Shutdown finished after {} ms", duration.count());
+        }
+    }
+
+
+    /**
+    * \brief Checks if the plugin shuts down
+    *
+    * \return bool true while the plugin shuts down
+    */
+    bool IsShuttingDown(void)
+    {
+        return IsShutdownActive.load(std::memory_order_acquire);
+    }
+
+
+    /**
+    * \brief Checks the deadline of the shutdown
+    *
+    * This function can be called from any thread
+    *
+    * \return bool true if the plugin shuts down and the deadline is exceeded
+    */
+    bool IsDeadlineExceeded(void)
+    {
+        return (true == IsShutdownActive.load(std::memory_order_acquire)) && (std::chrono::steady_clock::now() >= ShutdownDeadline);
+    }
+
+
+    /**
+    * \brief Reports work that was dropped at the deadline
+    *
+    * \param[in] Module name of the module
+    * \param[in] NumOfPending number of dropped items
+    * \param[in] What kind of the dropped items
+    * \return void
+    */
+    void ReportPending(const char* Module, size_t NumOfPending, const char* What)
+    {
+        IsWorkDropped = true;
+        Log::GetLog()->warn("{}: shutdown deadline exceeded, {} {} dropped", Module, NumOfPending, What);
+    }
+}
+
+/* =================================================[end of file]================================================= */
@@ -0,0 +1,50 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file Shutdown.h
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Deadline of the orderly shutdown
+*
+*/
+
+#ifndef SHUTDOWN_H
+#define SHUTDOWN_H
+
+/* ================================================[includes]================================================ */
+#include <cstddef>
+
+
+namespace Shutdown
+{
+    /* ================================================[declaration of public functions]========================= */
+
+    extern void BeginShutdown(int DeadlineMs);
+    extern void EndShutdown();
+    extern bool IsShuttingDown();
+    extern bool IsDeadlineExceeded();
+    extern void ReportPending(const char* Module, size_t NumOfPending, const char* What);
+}
+
+
+#endif /* SHUTDOWN_H */
+
+/* =================================================[end of file]================================================= */
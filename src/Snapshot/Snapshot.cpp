@@ -0,0 +1,787 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file Snapshot.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Snapshots of the tribe state
+*
+* On unload the tribe cache is written to a handoff file next to the database, the next load restores it
+* instead of starting with a cold cache. The tribes that changed in the database in between are dropped 
+* by their change sequence, so a reload by ArkApi or a restart of the server never serves outdated slots.
+*
+* A background thread writes a snapshot of all tribes periodically. The snapshot files alternate, so the
+* one mapped by the game thread is never replaced. At startup the newest snapshot gets mapped and serves 
+* the misses of the tribe cache, only the tribes changed after the snapshot are read from the database.
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "Snapshot.h"
+#include "SnapshotFormat.h"
+#include "SlotCooldown.h"
+#include "TribeCache.h"
+#include "Clock.h"
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+
+namespace Snapshot
+{
+    /* ========================================== [local defines] =============================================== */
+
+    /** \brief extension of the handoff file */
+    #define HANDOFF_EXTENSION ".handoff"
+
+    /** \brief extension of the snapshot files, followed by the index of the file */
+    #define SNAPSHOT_EXTENSION ".snapshot"
+
+    /** \brief number of alternating snapshot files */
+    #define NUM_OF_SNAPSHOT_FILES 2
+
+    /** \brief extension of unfinished files */
+    #define TEMPORARY_EXTENSION ".tmp"
+
+
+    /* =============================================== [local data] =============================================== */
+
+    /** \brief path of the handoff file */
+    static std::filesystem::path HandoffFile;
+
+    /** \brief path of the database */
+    static std::string DatabaseFile;
+
+    /** \brief paths of the alternating snapshot files */
+    static std::filesystem::path SnapshotFiles[NUM_OF_SNAPSHOT_FILES];
+
+    /** \brief interval of the snapshots in minutes */
+    static int SnapshotInterval = 0;
+
+    /** \brief index of the mapped snapshot file, -1 if none is mapped */
+    static std::atomic<int> MappedIndex(-1);
+
+    /** \brief view of the mapped snapshot */
+    static const char* MappedView = nullptr;
+
+    /** \brief size of the mapped snapshot in bytes */
+    static size_t MappedSize = 0;
+
+    /** \brief header of the mapped snapshot */
+    static SnapshotHeader_t MappedHeader = {};
+
+    /** \brief tribes of the mapped snapshot sorted by id */
+    static const SnapshotTribe_t* MappedTribes = nullptr;
+
+    /** \brief slot cooldowns of the mapped snapshot */
+    static const int64_t* MappedPool = nullptr;
+
+    /** \brief tribes that changed after the mapped snapshot */
+    static std::unordered_set<int> ChangedTribes;
+
+    /** \brief change sequence up to which the changed tribes are known */
+    static int64_t ReplayedSequence = 0;
+
+    /** \brief true if the snapshot thread is running */
+    static bool IsRunning = false;
+
+    /** \brief true if the snapshot thread has to stop */
+    static bool StopWriter = false;
+
+    /** \brief protects StopWriter */
+    static std::mutex WriterMutex;
+
+    /** \brief wakes up the snapshot thread */
+    static std::condition_variable WriterCondition;
+
+    /** \brief thread that writes the snapshots */
+    static std::thread WriterThread;
+
+
+    /* ===================================== [prototype of local functions] ======================================= */
+
+    static bool WriteSnapshotFile(const std::filesystem::path& File, const ChangeSequence_t& Sequence, 
+        std::vector<SnapshotTribe_t>* Tribes, const std::vector<int64_t>& Pool);
+    static bool ReadSnapshotFile(const std::filesystem::path& File, std::vector<char>* Snapshot);
+    static bool ReadDatabase(ChangeSequence_t* Sequence, std::vector<SnapshotTribe_t>* Tribes, std::vector<int64_t>* Pool);
+    static void WriteSnapshot(void);
+    static void WriterLoop(void);
+    static bool ReadSnapshotHeader(const std::filesystem::path& File, SnapshotHeader_t* Header);
+    static const char* MapFile(const std::filesystem::path& File, size_t Size);
+    static void UnmapFile(const char* View, size_t Size);
+    static bool MapSnapshot(int Index);
+    static void UnmapSnapshot(void);
+
+
+    /* ===================================== [definition of local functions] ====================================== */
+
+    /**
+    * \brief Writes a snapshot file
+    *
+    * The snapshot is written to a temporary file first and renamed when it is complete
+    *
+    * \param[in] File the file to write
+    * \param[in] Sequence the change sequence of the tribes
+    * \param[in,out] Tribes the tribes, they get sorted by id
+    * \param[in] Pool the slot cooldowns the tribes point into
+    * \return bool true if the snapshot was written
+    */
+    static bool WriteSnapshotFile(const std::filesystem::path& File, const ChangeSequence_t& Sequence, 
+        std::vector<SnapshotTribe_t>* Tribes, const std::vector<int64_t>& Pool)
+    {
+        SnapshotHeader_t header = {};
+        std::filesystem::path temporary = File;
+        std::error_code error;
+
+        temporary += TEMPORARY_EXTENSION;
+
+        std::sort(Tribes->begin(), Tribes->end(), [](const SnapshotTribe_t& a, const SnapshotTribe_t& b) { return a.tribeId < b.tribeId; });
+
+        header.magic = SNAPSHOT_MAGIC;
+        header.version = SNAPSHOT_VERSION;
+        header.numOfTribes = (uint32_t)Tribes->size();
+        header.databaseId = Sequence.databaseId;
+        header.sequence = Sequence.sequence;
+        header.poolSize = (uint32_t)Pool.size();
+        header.checksum = UpdateChecksum(GetHeaderChecksum(header), Tribes->data(), Tribes->size() * sizeof(SnapshotTribe_t));
+        header.checksum = UpdateChecksum(header.checksum, Pool.data(), Pool.size() * sizeof(int64_t));
+
+        {
+            std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+
+            stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            stream.write(reinterpret_cast<const char*>(Tribes->data()), Tribes->size() * sizeof(SnapshotTribe_t));
+            stream.write(reinterpret_cast<const char*>(Pool.data()), Pool.size() * sizeof(int64_t));
+
+            if (false == stream.good())
+            {
+                Log::GetLog()->error("Snapshot {} could not be written", File.u8string());
+                stream.close();
+                std::filesystem::remove(temporary, error);
+                return false;
+            }
+        }
+
+        std::filesystem::rename(temporary, File, error);
+
+        if (error)
+        {
+            Log::GetLog()->error("Snapshot {} could not be renamed: {}", File.u8string(), error.message());
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
+
+        return true;
+    }
+
+
+    /**
+    * \brief Reads and validates a snapshot file
+    *
+    * \param[in] File the file to read
+    * \param[out] Snapshot the content of the file, starting with the header
+    * \return bool true if the snapshot is complete and the checksum matches
+    */
+    static bool ReadSnapshotFile(const std::filesystem::path& File, std::vector<char>* Snapshot)
+    {
+        std::error_code error;
+        const uintmax_t fileSize = std::filesystem::file_size(File, error);
+        SnapshotHeader_t header;
+        std::ifstream stream;
+
+        if ((error) || (sizeof(SnapshotHeader_t) > fileSize))
+        {
+            return false;
+        }
+
+        Snapshot->resize((size_t)fileSize);
+        stream.open(File, std::ios::binary);
+        stream.read(Snapshot->data(), Snapshot->size());
+
+        if (false == stream.good())
+        {
+            return false;
+        }
+
+        std::memcpy(&header, Snapshot->data(), sizeof(header));
+
+        if ((SNAPSHOT_MAGIC != header.magic) || (SNAPSHOT_VERSION != header.version) || (GetSnapshotSize(header) != Snapshot->size()))
+        {
+            Log::GetLog()->warn("Snapshot {} has an unknown format", File.u8string());
+            return false;
+        }
+
+        if (header.checksum != UpdateChecksum(GetHeaderChecksum(header), Snapshot->data() + sizeof(header), Snapshot->size() - sizeof(header)))
+        {
+            Log::GetLog()->warn("Snapshot {} is corrupted", File.u8string());
+            return false;
+        }
+
+        return true;
+    }
+
+
+    /**
+    * \brief Reads all tribes from the database
+    *
+    * The tribes are read with an own read only connection within one transaction, so they match the change
+    * sequence. Nothing is read as long as the background migration has not converted all legacy cooldowns.
+    *
+    * \param[out] Sequence the change sequence of the tribes
+    * \param[out] Tribes the tribes sorted by id
+    * \param[out] Pool the slot cooldowns the tribes point into
+    * \return bool true if the tribes were read
+    */
+    static bool ReadDatabase(ChangeSequence_t* Sequence, std::vector<SnapshotTribe_t>* Tribes, std::vector<int64_t>* Pool)
+    {
+        bool hasLegacySlots = true;
+
+        try
+        {
+            sqlite::sqlite_config config;
+            config.flags = sqlite::OpenFlags::READONLY;
+
+            sqlite::database database(DatabaseFile, config);
+
+            database << "BEGIN;";
+            database << "SELECT DatabaseId, Seq, WipeSeq FROM ChangeCounter WHERE Id = 0;" 
+                >> std::tie(Sequence->databaseId, Sequence->sequence, Sequence->wipeSequence);
+            database << "SELECT EXISTS (SELECT 1 FROM TribeSlots WHERE LastExpiry IS NULL OR SlotsExpiry IS NULL OR (LastExpiry > 0 AND LastExpiry < ?));" 
+                << CLOCK_LEGACY_TIME_LIMIT >> hasLegacySlots;
+
+            if (false == hasLegacySlots)
+            {
+                database << "SELECT TribeId, SlotsExpiry FROM TribeSlots ORDER BY TribeId;" >> [&](int TribeId, std::vector<int64_t> SlotsTimer)
+                {
+                    Tribes->push_back({ TribeId, (uint32_t)Pool->size(), (uint16_t)SlotsTimer.size(), SNAPSHOT_TRIBE_IN_DATABASE, 0 });
+                    Pool->insert(Pool->end(), SlotsTimer.begin(), SlotsTimer.end());
+                };
+            }
+
+            database << "COMMIT;";
+        }
+        catch (const sqlite::sqlite_exception& exception)
+        {
+            Log::GetLog()->error("({} {}) Unexpected DB error {}", __FILE__, __FUNCTION__, exception.what());
+            return false;
+        }
+
+        return (false == hasLegacySlots);
+    }
+
+
+    /**
+    * \brief Writes a snapshot of all tribes
+    *
+    * The snapshot replaces the file that is not mapped
+    *
+    * \return void
+    */
+    static void WriteSnapshot(void)
+    {
+        auto start = std::chrono::steady_clock::now();
+        ChangeSequence_t sequence;
+        std::vector<SnapshotTribe_t> tribes;
+        std::vector<int64_t> pool;
+        const int index = (0 == MappedIndex) ? 1 : 0;
+
+        if ((true == ReadDatabase(&sequence, &tribes, &pool)) && (true == WriteSnapshotFile(SnapshotFiles[index], sequence, &tribes, pool)))
+        {
+            Log::GetLog()->info("Snapshot of {} tribes written in {} ms", tribes.size(),
+                std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+        }
+    }
+
+
+    /**
+    * \brief Main loop of the snapshot thread
+    *
+    * \return void
+    */
+    static void WriterLoop(void)
+    {
+        std::unique_lock<std::mutex> lock(WriterMutex);
+
+        while (false == StopWriter)
+        {
+            WriterCondition.wait_for(lock, std::chrono::minutes(SnapshotInterval), [] { return StopWriter; });
+
+            if (false == StopWriter)
+            {
+                lock.unlock();
+                WriteSnapshot();
+                lock.lock();
+            }
+        }
+    }
+
+
+    /**
+    * \brief Reads the header of a snapshot file
+    *
+    * \param[in] File the snapshot file
+    * \param[out] Header the header
+    * \return bool true if the header has the current format
+    */
+    static bool ReadSnapshotHeader(const std::filesystem::path& File, SnapshotHeader_t* Header)
+    {
+        std::ifstream stream(File, std::ios::binary);
+
+        stream.read(reinterpret_cast<char*>(Header), sizeof(SnapshotHeader_t));
+
+        return (true == stream.good()) && (SNAPSHOT_MAGIC == Header->magic) && (SNAPSHOT_VERSION == Header->version);
+    }
+
+
+    /**
+    * \brief Maps a file read only
+    *
+    * \param[in] File the file
+    * \param[in] Size size of the file in bytes
+    * \return const char* view of the file, nullptr on error
+    */
+    static const char* MapFile(const std::filesystem::path& File, size_t Size)
+    {
+        const char* view = nullptr;
+
+#ifdef _WIN32
+        HANDLE file = CreateFileW(File.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+        (void)Size;
+
+        if (INVALID_HANDLE_VALUE != file)
+        {
+            HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+            if (NULL != mapping)
+            {
+                view = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                CloseHandle(mapping);
+            }
+            CloseHandle(file);
+        }
+#else
+        int file = open(File.c_str(), O_RDONLY);
+
+        if (0 <= file)
+        {
+            void* mapping = mmap(nullptr, Size, PROT_READ, MAP_SHARED, file, 0);
+
+            if (MAP_FAILED != mapping)
+            {
+                view = static_cast<const char*>(mapping);
+            }
+            close(file);
+        }
+#endif
+
+        return view;
+    }
+
+
+    /**
+    * \brief Unmaps a file
+    *
+    * \param[in] View view of the file
+    * \param[in] Size size of the file in bytes
+    * \return void
+    */
+    static void UnmapFile(const char* View, size_t Size)
+    {
+#ifdef _WIN32
+        (void)Size;
+        UnmapViewOfFile(View);
+#else
+        munmap(const_cast<char*>(View), Size);
+#endif
+    }
+
+
+    /**
+    * \brief Maps a snapshot file
+    *
+    * \param[in] Index index of the snapshot file
+    * \return bool true if the snapshot is mapped and the checksum matches
+    */
+    static bool MapSnapshot(int Index)
+    {
+        std::error_code error;
+        const uintmax_t fileSize = std::filesystem::file_size(SnapshotFiles[Index], error);
+        const char* view = nullptr;
+        SnapshotHeader_t header;
+
+        if ((error) || (sizeof(SnapshotHeader_t) > fileSize))
+        {
+            return false;
+        }
+
+        view = MapFile(SnapshotFiles[Index], (size_t)fileSize);
+
+        if (nullptr == view)
+        {
+            return false;
+        }
+
+        std::memcpy(&header, view, sizeof(header));
+
+        if ((GetSnapshotSize(header) != fileSize) || 
+            (header.checksum != UpdateChecksum(GetHeaderChecksum(header), view + sizeof(header), (size_t)fileSize - sizeof(header))))
+        {
+            Log::GetLog()->warn("Snapshot {} is corrupted", SnapshotFiles[Index].u8string());
+            UnmapFile(view, (size_t)fileSize);
+            return false;
+        }
+
+        MappedView = view;
+        MappedSize = (size_t)fileSize;
+        MappedHeader = header;
+        MappedTribes = reinterpret_cast<const SnapshotTribe_t*>(view + sizeof(header));
+        MappedPool = reinterpret_cast<const int64_t*>(MappedTribes + header.numOfTribes);
+        MappedIndex = Index;
+
+        return true;
+    }
+
+
+    /**
+    * \brief Unmaps the snapshot
+    *
+    * \return void
+    */
+    static void UnmapSnapshot(void)
+    {
+        if (nullptr != MappedView)
+        {
+            UnmapFile(MappedView, MappedSize);
+        }
+
+        MappedView = nullptr;
+        MappedSize = 0;
+        MappedTribes = nullptr;
+        MappedPool = nullptr;
+        MappedIndex = -1;
+        ChangedTribes.clear();
+    }
+
+
+    /* ===================================== [definition of global functions] ===================================== */
+
+    /**
+    * \brief Initialisation of the snapshots
+    *
+    * \param[in] DatabasePath path of the database
+    * \param[in] IntervalMinutes interval of the snapshots of all tribes in minutes, 0 disables them
+    * \return void
+    */
+    void InitSnapshot(const std::string& DatabasePath, int IntervalMinutes)
+    {
+        DatabaseFile = DatabasePath;
+        HandoffFile = std::filesystem::u8path(DatabasePath + HANDOFF_EXTENSION);
+
+        for (int i = 0; i < NUM_OF_SNAPSHOT_FILES; i++)
+        {
+            SnapshotFiles[i] = std::filesystem::u8path(DatabasePath + SNAPSHOT_EXTENSION + std::to_string(i));
+        }
+
+        SnapshotInterval = IntervalMinutes;
+
+        if ((0 < SnapshotInterval) && (false == IsRunning))
+        {
+            StopWriter = false;
+            WriterThread = std::thread(&WriterLoop);
+            IsRunning = true;
+        }
+    }
+
+
+    /**
+    * \brief Remove of the snapshots
+    *
+    * This function stops the snapshot thread after the running snapshot and unmaps the snapshot
+    *
+    * \return void
+    */
+    void RemoveSnapshot(void)
+    {
+        if (true == IsRunning)
+        {
+            {
+                std::lock_guard<std::mutex> lock(WriterMutex);
+                StopWriter = true;
+            }
+            WriterCondition.notify_one();
+
+            WriterThread.join();
+            IsRunning = false;
+        }
+
+        UnmapSnapshot();
+    }
+
+
+    /**
+    * \brief Saves the tribe cache for the next load
+    *
+    * \return bool true if the handoff file was written
+    */
+    bool SaveHandoff(void)
+    {
+        ChangeSequence_t sequence;
+        std::vector<SnapshotTribe_t> tribes;
+        std::vector<int64_t> pool;
+
+        if ((true == HandoffFile.empty()) || (false == TribeCache::GetCacheSequence(&sequence)))
+        {
+            return false;
+        }
+
+        TribeCache::ForEachCachedTribe([&](int TribeId, bool IsInDatabase, const std::vector<int64_t>& Slots)
+        {
+            tribes.push_back({ TribeId, (uint32_t)pool.size(), (uint16_t)Slots.size(), 
+                (uint16_t)((true == IsInDatabase) ? SNAPSHOT_TRIBE_IN_DATABASE : 0), 0 });
+            pool.insert(pool.end(), Slots.begin(), Slots.end());
+        });
+
+        return WriteSnapshotFile(HandoffFile, sequence, &tribes, pool);
+    }
+
+
+    /**
+    * \brief Restores the tribe cache of the last unload
+    *
+    * The handoff file is only used once. Tribes that changed in the database afterwards are not restored.
+    *
+    * \return bool true if the tribe cache was restored
+    */
+    bool LoadHandoff(void)
+    {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<char> snapshot;
+        SnapshotHeader_t header;
+        ChangeSequence_t sequence;
+        std::vector<int> changedTribes;
+        std::error_code error;
+        size_t numOfTribes = 0;
+        bool result = false;
+
+        if ((false == HandoffFile.empty()) && (true == ReadSnapshotFile(HandoffFile, &snapshot)) &&
+            (nullptr != SlotCooldown::database) && (true == SlotCooldown::database->GetChangeSequence(&sequence)))
+        {
+            std::memcpy(&header, snapshot.data(), sizeof(header));
+
+            /* a snapshot of an other database or from before a wipe is useless */
+            if ((header.databaseId == sequence.databaseId) && (header.sequence >= sequence.wipeSequence) &&
+                (header.sequence <= sequence.sequence) && 
+                (true == SlotCooldown::database->ForEachChangedTribe(header.sequence, [&](int TribeId) { changedTribes.push_back(TribeId); })))
+            {
+                const SnapshotTribe_t* tribes = reinterpret_cast<const SnapshotTribe_t*>(snapshot.data() + sizeof(header));
+                const int64_t* pool = reinterpret_cast<const int64_t*>(tribes + header.numOfTribes);
+
+                std::sort(changedTribes.begin(), changedTribes.end());
+                TribeCache::InvalidateAll();
+
+                for (uint32_t i = 0; i < header.numOfTribes; i++)
+                {
+                    const SnapshotTribe_t& tribe = tribes[i];
+
+                    if (((size_t)tribe.offset + tribe.numOfSlots <= header.poolSize) &&
+                        (false == std::binary_search(changedTribes.begin(), changedTribes.end(), tribe.tribeId)) &&
+                        (true == TribeCache::StoreTribe(tribe.tribeId, (0 != (tribe.flags & SNAPSHOT_TRIBE_IN_DATABASE)),
+                            std::vector<int64_t>(pool + tribe.offset, pool + tribe.offset + tribe.numOfSlots))))
+                    {
+                        numOfTribes++;
+                    }
+                }
+
+                TribeCache::SetCacheSequence({ header.databaseId, header.sequence, sequence.wipeSequence });
+                result = true;
+            }
+        }
+
+        std::filesystem::remove(HandoffFile, error);
+
+        if (true == result)
+        {
+            Log::GetLog()->info("Tribe cache restored with {} tribes in {} ms, {} tribes changed since the unload", numOfTribes, 
+                std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count(), changedTribes.size());
+        }
+
+        return result;
+    }
+
+
+    /**
+    * \brief Maps the newest snapshot of all tribes
+    *
+    * Only the tribes changed after the snapshot have to be read from the database
+    *
+    * \return bool true if a snapshot is mapped
+    */
+    bool LoadSnapshot(void)
+    {
+        auto start = std::chrono::steady_clock::now();
+        ChangeSequence_t sequence;
+        SnapshotHeader_t headers[NUM_OF_SNAPSHOT_FILES];
+        bool isUsable[NUM_OF_SNAPSHOT_FILES] = { false };
+        int newest;
+
+        UnmapSnapshot();
+
+        if ((0 >= SnapshotInterval) || (nullptr == SlotCooldown::database) || (false == SlotCooldown::database->GetChangeSequence(&sequence)))
+        {
+            return false;
+        }
+
+        for (int i = 0; i < NUM_OF_SNAPSHOT_FILES; i++)
+        {
+            isUsable[i] = (true == ReadSnapshotHeader(SnapshotFiles[i], &headers[i])) && (headers[i].databaseId == sequence.databaseId) &&
+                (headers[i].sequence >= sequence.wipeSequence) && (headers[i].sequence <= sequence.sequence);
+        }
+
+        /* the newest snapshot first, the other one is the fallback */
+        newest = ((true == isUsable[1]) && ((false == isUsable[0]) || (headers[1].sequence > headers[0].sequence))) ? 1 : 0;
+
+        for (int index : { newest, 1 - newest })
+        {
+            if ((true == isUsable[index]) && (true == MapSnapshot(index)))
+            {
+                break;
+            }
+        }
+
+        if (nullptr == MappedView)
+        {
+            return false;
+        }
+
+        ReplayedSequence = MappedHeader.sequence;
+        Revalidate();
+
+        if (nullptr != MappedView)
+        {
+            Log::GetLog()->info("Snapshot of {} tribes mapped in {} ms, {} tribes changed since the snapshot", MappedHeader.numOfTribes,
+                std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count(), ChangedTribes.size());
+        }
+
+        return (nullptr != MappedView);
+    }
+
+
+    /**
+    * \brief Looks up a tribe in the mapped snapshot
+    *
+    * \param[in] TribeId the tribe
+    * \param[out] IsInDatabase true if the tribe has an entry in the database
+    * \param[out] Slots the stored slot cooldowns
+    * \return bool true if the snapshot knows the current state of the tribe, otherwise the database has to be read
+    */
+    bool FindTribe(int TribeId, bool* IsInDatabase, std::vector<int64_t>* Slots)
+    {
+        const SnapshotTribe_t* tribe;
+
+        if ((nullptr == MappedView) || (ChangedTribes.end() != ChangedTribes.find(TribeId)))
+        {
+            return false;
+        }
+
+        tribe = std::lower_bound(MappedTribes, MappedTribes + MappedHeader.numOfTribes, TribeId, 
+            [](const SnapshotTribe_t& Entry, int Id) { return Entry.tribeId < Id; });
+
+        if ((tribe != (MappedTribes + MappedHeader.numOfTribes)) && (tribe->tribeId == TribeId) &&
+            (((size_t)tribe->offset + tribe->numOfSlots) <= MappedHeader.poolSize))
+        {
+            *IsInDatabase = true;
+            Slots->assign(MappedPool + tribe->offset, MappedPool + tribe->offset + tribe->numOfSlots);
+        }
+        else
+        {
+            *IsInDatabase = false;
+            Slots->clear();
+        }
+
+        return true;
+    }
+
+
+    /**
+    * \brief Marks a tribe as changed
+    *
+    * This function has to be called every time the slots of a tribe change
+    *
+    * \param[in] TribeId the tribe
+    * \return void
+    */
+    void InvalidateTribe(int TribeId)
+    {
+        if (nullptr != MappedView)
+        {
+            ChangedTribes.insert(TribeId);
+        }
+    }
+
+
+    /**
+    * \brief Reads the tribes changed by other processes
+    *
+    * This function has to be called if the database changed in an unknown way. The snapshot is dropped if 
+    * the database was wiped or replaced.
+    *
+    * \return void
+    */
+    void Revalidate(void)
+    {
+        ChangeSequence_t sequence;
+
+        if (nullptr == MappedView)
+        {
+            return;
+        }
+
+        if ((nullptr == SlotCooldown::database) || (false == SlotCooldown::database->GetChangeSequence(&sequence)) ||
+            (sequence.databaseId != MappedHeader.databaseId) || (sequence.wipeSequence > MappedHeader.sequence) ||
+            (false == SlotCooldown::database->ForEachChangedTribe(ReplayedSequence, [](int TribeId) { ChangedTribes.insert(TribeId); })))
+        {
+            UnmapSnapshot();
+            return;
+        }
+
+        ReplayedSequence = sequence.sequence;
+    }
+}
+
+/* =================================================[end of file]================================================= */
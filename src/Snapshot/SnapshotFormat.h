@@ -0,0 +1,152 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file SnapshotFormat.h
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Binary format of the tribe snapshots
+*
+* A snapshot starts with a SnapshotHeader_t followed by SnapshotTribe_t entries sorted by tribe id and a
+* pool of int64 slot cooldowns the entries point into. The checksum covers the header with a zero checksum
+* field, the entries and the pool. The change sequence of the database at the time of the snapshot tells which tribes changed afterwards.
+*
+*/
+
+#ifndef SNAPSHOTFORMAT_H
+#define SNAPSHOTFORMAT_H
+
+/* ================================================[includes]================================================ */
+#include <cstddef>
+#include <cstdint>
+
+
+namespace Snapshot
+{
+    /* ================================================[declaration of public defines]=========================== */
+
+    /** \brief magic number at the start of every snapshot */
+    #define SNAPSHOT_MAGIC 0x5350414E53435354ULL /* "TSCSNAPS" in little endian */
+
+    /** \brief version of the snapshot format */
+    #define SNAPSHOT_VERSION 3
+
+    /** \brief initial value of the checksum */
+    #define SNAPSHOT_CHECKSUM_SEED 0xCBF29CE484222325ULL
+
+    /** \brief flag of a tribe that has an entry in the database */
+    #define SNAPSHOT_TRIBE_IN_DATABASE 0x0001
+
+
+    /* ================================================[declaration of public types]============================= */
+
+#pragma pack(push, 1)
+
+    /**
+    *  \brief header of a snapshot
+    */
+    typedef struct
+    {
+        uint64_t magic;             /**< \brief SNAPSHOT_MAGIC */
+        uint32_t version;           /**< \brief SNAPSHOT_VERSION */
+        uint32_t numOfTribes;       /**< \brief number of SnapshotTribe_t entries */
+        int64_t databaseId;         /**< \brief id of the database the snapshot was taken from */
+        int64_t sequence;           /**< \brief change sequence of the database at the time of the snapshot */
+        uint32_t poolSize;          /**< \brief number of slot cooldowns in the pool */
+        uint32_t reserved;          /**< \brief always 0 */
+        uint64_t checksum;          /**< \brief FNV-1a of the header, the entries and the pool */
+    }SnapshotHeader_t;
+
+
+    /**
+    *  \brief one tribe of a snapshot
+    */
+    typedef struct
+    {
+        int32_t tribeId;            /**< \brief id of the tribe */
+        uint32_t offset;            /**< \brief index of the first slot cooldown in the pool */
+        uint16_t numOfSlots;        /**< \brief number of slot cooldowns */
+        uint16_t flags;             /**< \brief SNAPSHOT_TRIBE_IN_DATABASE */
+        uint32_t reserved;          /**< \brief always 0, keeps the pool 8 byte aligned */
+    }SnapshotTribe_t;
+
+#pragma pack(pop)
+
+    static_assert(48 == sizeof(SnapshotHeader_t), "the snapshot header must not change without a new version");
+    static_assert(16 == sizeof(SnapshotTribe_t), "the tribe format must not change without a new version");
+
+
+    /* ================================================[definition of public functions]========================== */
+
+    /**
+    * \brief Continues a FNV-1a checksum
+    *
+    * \param[in] Checksum the checksum so far, see GetHeaderChecksum
+    * \param[in] Data the data
+    * \param[in] Size size of the data in bytes
+    * \return uint64_t the checksum including the data
+    */
+    inline uint64_t UpdateChecksum(uint64_t Checksum, const void* Data, size_t Size)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(Data);
+
+        for (size_t i = 0; i < Size; i++)
+        {
+            Checksum = (Checksum ^ bytes[i]) * 0x100000001B3ULL;
+        }
+
+        return Checksum;
+    }
+
+
+    /**
+    * \brief Starts the checksum of a snapshot with its header
+    *
+    * The checksum field counts as 0, the entries and the pool are added with UpdateChecksum
+    *
+    * \param[in] Header the header of the snapshot
+    * \return uint64_t the checksum of the header
+    */
+    inline uint64_t GetHeaderChecksum(const SnapshotHeader_t& Header)
+    {
+        SnapshotHeader_t header = Header;
+
+        header.checksum = 0;
+
+        return UpdateChecksum(SNAPSHOT_CHECKSUM_SEED, &header, sizeof(header));
+    }
+
+
+    /**
+    * \brief Gets the size of a snapshot
+    *
+    * \param[in] Header the header of the snapshot
+    * \return size_t size of the snapshot in bytes
+    */
+    inline size_t GetSnapshotSize(const SnapshotHeader_t& Header)
+    {
+        return sizeof(SnapshotHeader_t) + ((size_t)Header.numOfTribes * sizeof(SnapshotTribe_t)) + ((size_t)Header.poolSize * sizeof(int64_t));
+    }
+}
+
+
+#endif /* SNAPSHOTFORMAT_H */
+
+/* =================================================[end of file]================================================= */
@@ -0,0 +1,245 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file Statistics.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Runtime statistics of the plugin
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "Statistics.h"
+
+
+namespace Statistics
+{
+    /* =============================================== [local data] =============================================== */
+
+    /** \brief values of all counters */
+    static uint64_t Counters[NumOfCounters] = { 0 };
+
+    /** \brief names of all counters, same order as Counter_t */
+    static const char* CounterNames[NumOfCounters] =
+    {
+        "OutputCacheHit",
+        "OutputCacheMiss",
+        "ChatCommandAccepted",
+        "ChatCommandRejected",
+        "JoinRejectionEvaluated",
+        "JoinRejectionMemoized",
+        "TribeCacheHit",
+        "TribeCacheMiss",
+        "DatabaseBusyRetry",
+        "ExternalDatabaseChange",
+        "EventBusPublished",
+        "EventBusReceived",
+        "EventBusResync",
+        "EventBusLatencySum",
+        "DatabaseFailure",
+        "DatabaseCircuitOpened",
+        "DatabaseDegradedRead",
+        "DatabaseJournaled",
+        "DatabaseJournalDropped",
+        "JoinBudgetExceeded",
+        "TribePrefetched",
+        "PrefetchHit",
+        "PrefetchMiss"
+    };
+
+
+    /* ===================================== [prototype of local functions] ======================================= */
+
+    static double GetRatio(Counter_t Hits, Counter_t Misses);
+    static double GetAverageLatency(void);
+
+
+    /* ===================================== [definition of local functions] ====================================== */
+
+    /**
+    * \brief Calculates a hit ratio
+    *
+    * This function calculates the ratio of hits to all accesses in percent
+    *
+    * \param[in] Hits the counter with the hits
+    * \param[in] Misses the counter with the misses
+    * \return double hit ratio in percent, 0 if there was no access
+    */
+    static double GetRatio(Counter_t Hits, Counter_t Misses)
+    {
+        double result = 0.0;
+        uint64_t total = Counters[Hits] + Counters[Misses];
+
+        if (0 != total)
+        {
+            result = (100.0 * (double)Counters[Hits]) / (double)total;
+        }
+
+        return result;
+    }
+
+
+    /**
+    * \brief Calculates the average propagation latency of the event bus
+    *
+    * \return double average latency in microseconds, 0 if no event was received
+    */
+    static double GetAverageLatency(void)
+    {
+        double result = 0.0;
+
+        if (0 != Counters[EventBusReceived])
+        {
+            result = (double)Counters[EventBusLatencySum] / (double)Counters[EventBusReceived];
+        }
+
+        return result;
+    }
+
+
+    /* ===================================== [definition of global functions] ===================================== */
+
+    /**
+    * \brief Increments a counter
+    *
+    * \param[in] Counter the counter to increment
+    * \return void
+    */
+    void Increment(Counter_t Counter)
+    {
+        if (NumOfCounters > Counter)
+        {
+            Counters[Counter]++;
+        }
+    }
+
+
+    /**
+    * \brief Adds a value to a counter
+    *
+    * \param[in] Counter the counter to add to
+    * \param[in] Value the value to add
+    * \return void
+    */
+    void Add(Counter_t Counter, uint64_t Value)
+    {
+        if (NumOfCounters > Counter)
+        {
+            Counters[Counter] += Value;
+        }
+    }
+
+
+    /**
+    * \brief Gets the value of a counter
+    *
+    * \param[in] Counter the counter to read
+    * \return uint64_t value of the counter
+    */
+    uint64_t Get(Counter_t Counter)
+    {
+        uint64_t result = 0;
+
+        if (NumOfCounters > Counter)
+        {
+            result = Counters[Counter];
+        }
+
+        return result;
+    }
+
+
+    /**
+    * \brief Resets all counters
+    *
+    * \return void
+    */
+    void ResetStatistics(void)
+    {
+        for (int i = 0; i < NumOfCounters; i++)
+        {
+            Counters[i] = 0;
+        }
+    }
+
+
+    /**
+    * \brief Gets a string with the statistics
+    *
+    * This function returns a human readable string with all statistics of the plugin
+    *
+    * \return FString the string with the statistics
+    */
+    FString GetStatisticsString(void)
+    {
+        FString displayString = FString::Format("Output cache: {} hits, {} misses, hit ratio {:.1f}%\n",
+            Counters[OutputCacheHit], Counters[OutputCacheMiss], GetRatio(OutputCacheHit, OutputCacheMiss));
+
+        displayString += FString::Format("Chat commands: {} accepted, {} rejected by rate limit\n",
+            Counters[ChatCommandAccepted], Counters[ChatCommandRejected]);
+
+        displayString += FString::Format("Rejected tribe joins: {} evaluated, {} remembered\n",
+            Counters[JoinRejectionEvaluated], Counters[JoinRejectionMemoized]);
+
+        displayString += FString::Format("Tribe cache: {} hits, {} misses, hit ratio {:.1f}%\n",
+            Counters[TribeCacheHit], Counters[TribeCacheMiss], GetRatio(TribeCacheHit, TribeCacheMiss));
+
+        displayString += FString::Format("Shared database: {} busy retries, {} external changes\n",
+            Counters[DatabaseBusyRetry], Counters[ExternalDatabaseChange]);
+
+        displayString += FString::Format("Event bus: {} published, {} received, {} resyncs, average latency {:.1f} us\n",
+            Counters[EventBusPublished], Counters[EventBusReceived], Counters[EventBusResync], GetAverageLatency());
+
+        displayString += FString::Format("Database circuit: {} failures, {} opened, {} degraded reads, {} journaled, {} dropped\n",
+            Counters[DatabaseFailure], Counters[DatabaseCircuitOpened], Counters[DatabaseDegradedRead], 
+            Counters[DatabaseJournaled], Counters[DatabaseJournalDropped]);
+
+        displayString += FString::Format("Join latency budget: {} exceeded\n", Counters[JoinBudgetExceeded]);
+
+        displayString += FString::Format("Prefetch: {} tribes prefetched, {} hits, {} misses, hit ratio {:.1f}%\n",
+            Counters[TribePrefetched], Counters[PrefetchHit], Counters[PrefetchMiss], GetRatio(PrefetchHit, PrefetchMiss));
+
+        return displayString;
+    }
+
+
+    /**
+    * \brief Gets the name of a counter
+    *
+    * \param[in] Counter the counter
+    * \return const char* machine readable name of the counter
+    */
+    const char* GetCounterName(Counter_t Counter)
+    {
+        const char* result = "Unknown";
+
+        if (NumOfCounters > Counter)
+        {
+            result = CounterNames[Counter];
+        }
+
+        return result;
+    }
+}
+
+/* =================================================[end of file]================================================= */
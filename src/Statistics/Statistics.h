@@ -0,0 +1,88 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file Statistics.h
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Runtime statistics of the plugin
+*
+*/
+
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+/* ================================================[includes]================================================ */
+#include "API/ARK/Ark.h"
+#include <cstdint>
+
+
+namespace Statistics
+{
+    /* ================================================[type definitions]======================================== */
+
+    /**
+    *  \brief runtime counters of the plugin
+    */
+    typedef enum
+    {
+        OutputCacheHit = 0,     /**< \brief slot cooldown output served from the output cache */
+        OutputCacheMiss,        /**< \brief slot cooldown output rendered from the database */
+        ChatCommandAccepted,    /**< \brief chat command executed */
+        ChatCommandRejected,    /**< \brief chat command rejected by the rate limiter */
+        JoinRejectionEvaluated, /**< \brief tribe join rejected after evaluating the cooldowns */
+        JoinRejectionMemoized,  /**< \brief tribe join rejected by a remembered rejection */
+        TribeCacheHit,          /**< \brief slot cooldowns of a tribe served from the tribe cache */
+        TribeCacheMiss,         /**< \brief slot cooldowns of a tribe read from the database */
+        DatabaseBusyRetry,      /**< \brief access retried because an other process locked the database */
+        ExternalDatabaseChange, /**< \brief change of the database by an other process detected */
+        EventBusPublished,      /**< \brief event published to the other servers of the cluster */
+        EventBusReceived,       /**< \brief event of an other server of the cluster applied */
+        EventBusResync,         /**< \brief all caches dropped because events of an other server got lost */
+        EventBusLatencySum,     /**< \brief sum of the propagation latencies of all received events in microseconds */
+        DatabaseFailure,        /**< \brief access failed because of a locked, full or corrupt database */
+        DatabaseCircuitOpened,  /**< \brief database not accessed anymore after too many failures in a row */
+        DatabaseDegradedRead,   /**< \brief tribe read while the database was not accessed */
+        DatabaseJournaled,      /**< \brief change of a tribe kept in the journal until the database recovers */
+        DatabaseJournalDropped, /**< \brief change of a tribe lost because the journal was full */
+        JoinBudgetExceeded,     /**< \brief tribe join decided by the fallback policy, the tribe could not be read */
+        TribePrefetched,        /**< \brief tribe read in the background and stored in the tribe cache */
+        PrefetchHit,            /**< \brief tribe join served by a tribe read in the background */
+        PrefetchMiss,           /**< \brief tribe join that had to read the database */
+
+        NumOfCounters           /**< \brief number of counters, has to be the last entry */
+
+    }Counter_t;
+
+
+    /* ================================================[declaration of public functions]========================= */
+
+    extern void Increment(Counter_t Counter);
+    extern void Add(Counter_t Counter, uint64_t Value);
+    extern uint64_t Get(Counter_t Counter);
+    extern void ResetStatistics();
+    extern FString GetStatisticsString();
+    extern const char* GetCounterName(Counter_t Counter);
+}
+
+
+#endif /* STATISTICS_H */
+
+/* =================================================[end of file]================================================= */
@@ -0,0 +1,476 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file TribeCache.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Local cache of the slot cooldowns stored in the database
+*
+* Read through cache in front of the database. Tribes that are not in the database get cached as well, 
+* they are the common case for tribe joins. The tribes are kept in a flat hash table sized at startup. The 
+* cache has to be invalidated on every change of a tribe and completely if an other process changed the 
+* database. A join can look up a tribe within a deadline, 
+* tribes that could not be read in time are prefetched in the background. A maintenance task evicts tribes 
+* without active cooldowns before the cache gets full. Every cached tribe is published in the tribe view 
+* as well, so other threads can read it without locks.
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "TribeCache.h"
+#include "SlotCooldown.h"
+#include "Statistics.h"
+#include "Snapshot.h"
+#include "Prefetch.h"
+#include "Scheduler.h"
+#include "Clock.h"
+#include "TribeView.h"
+#include "TribeTable.h"
+#include <algorithm>
+
+
+namespace TribeCache
+{
+    /* ========================================== [local defines] =============================================== */
+
+    /** \brief name of the maintenance task compacting the cache */
+    #define COMPACTION_TASK "TribeCacheCompaction"
+
+    /** \brief seconds between two runs of the compaction */
+    #define COMPACTION_INTERVAL 10
+
+    /** \brief number of records the compaction checks between two checks of the deadline */
+    #define COMPACTION_CHUNK_SIZE 64
+
+
+    /* =============================================== [local data] =============================================== */
+
+    /** \brief maximum number of cached tribes */
+    static size_t MaxCachedTribes = 0;
+
+    /** \brief cached tribes by tribe id */
+    static TribeTable CachedTribes;
+
+    /** \brief change sequence of the database when the cache was empty, all tribes changed afterwards may be outdated */
+    static ChangeSequence_t CacheSequence = {};
+
+    /** \brief true if CacheSequence is known */
+    static bool IsCacheSequenceValid = false;
+
+    /** \brief record of the cache the compaction continues with */
+    static size_t CompactionIndex = 0;
+
+
+    /* ===================================== [prototype of local functions] ======================================= */
+
+    static bool HasActiveCooldown(const std::vector<int64_t>& Slots, int64_t Now);
+    static Scheduler::StepResult_t CompactionStep(std::chrono::steady_clock::time_point Deadline);
+
+
+    /* ===================================== [definition of local functions] ====================================== */
+
+    /**
+    * \brief Checks if stored slots have an active cooldown
+    *
+    * \param[in] Slots the stored slot cooldowns
+    * \param[in] Now the current unix time
+    * \return bool true if a cooldown is active or not yet converted, otherwise false
+    */
+    static bool HasActiveCooldown(const std::vector<int64_t>& Slots, int64_t Now)
+    {
+        for (int64_t slotTimer : Slots)
+        {
+            if ((CLOCK_LEGACY_TIME_LIMIT > slotTimer) || (Now < (int64_t)slotTimer))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+
+    /**
+    * \brief Step of the maintenance task compacting the cache
+    *
+    * The cache is compacted once it is filled by more than three quarters. The step evicts the tribes without 
+    * active cooldowns chunk by chunk until the deadline, so the cache does not need to be restarted on the 
+    * next miss.
+    *
+    * \param[in] Deadline end of the time slice
+    * \return Scheduler::StepResult_t StepDone once all records are compacted
+    */
+    static Scheduler::StepResult_t CompactionStep(std::chrono::steady_clock::time_point Deadline)
+    {
+        const int64_t now = Clock::Now();
+        std::vector<int64_t> slots;
+
+        if ((0 == CompactionIndex) && ((MaxCachedTribes / 4) * 3 >= CachedTribes.Size()))
+        {
+            return Scheduler::StepDone;
+        }
+
+        while ((CompactionIndex < CachedTribes.Capacity()) && (std::chrono::steady_clock::now() < Deadline))
+        {
+            size_t end = (std::min)(CompactionIndex + COMPACTION_CHUNK_SIZE, CachedTribes.Capacity());
+
+            /* erasing a tribe does not move the other records */
+            for (; CompactionIndex < end; CompactionIndex++)
+            {
+                int tribeId = 0;
+                bool isInDatabase = false;
+
+                if ((true == CachedTribes.GetAt(CompactionIndex, &tribeId, &isInDatabase, &slots)) && 
+                    (false == HasActiveCooldown(slots, now)))
+                {
+                    CachedTribes.Erase(tribeId);
+                    TribeView::Retract(tribeId);
+                }
+            }
+        }
+
+        if (CompactionIndex < CachedTribes.Capacity())
+        {
+            return Scheduler::StepPending;
+        }
+
+        CompactionIndex = 0;
+
+        return Scheduler::StepDone;
+    }
+
+
+    /* ===================================== [definition of global functions] ===================================== */
+
+    /**
+    * \brief Initialisation of the tribe cache
+    *
+    * \param[in] MaxNumOfTribes maximum number of cached tribes, 0 disables the cache
+    * \return void
+    */
+    void InitTribeCache(int MaxNumOfTribes)
+    {
+        MaxCachedTribes = (0 < MaxNumOfTribes) ? (size_t)MaxNumOfTribes : 0;
+        CompactionIndex = 0;
+
+        CachedTribes.Init(MaxCachedTribes);
+        TribeView::InitTribeView(MaxCachedTribes);
+        InvalidateAll();
+
+        if (0 < MaxCachedTribes)
+        {
+            Scheduler::AddTask(COMPACTION_TASK, COMPACTION_INTERVAL, &CompactionStep);
+        }
+    }
+
+
+    /**
+    * \brief Remove of the tribe cache
+    *
+    * All threads reading the tribe view have to be stopped before
+    *
+    * \return void
+    */
+    void RemoveTribeCache(void)
+    {
+        Scheduler::RemoveTask(COMPACTION_TASK);
+        CachedTribes.Init(0);
+        TribeView::RemoveTribeView();
+    }
+
+
+    /**
+    * \brief Gets the stored slot cooldowns of a tribe
+    *
+    * The slots are read from the database only if the tribe is neither cached nor in the mapped snapshot
+    *
+    * \param[in] TribeId the tribe
+    * \param[out] Slots the stored slot cooldowns, not normalized
+    * \return true if the tribe is in the database, otherwise false
+    */
+    bool GetTribeSlots(int TribeId, std::vector<int64_t>* Slots)
+    {
+        return (LookupInDatabase == LookupTribeSlots(TribeId, nullptr, Slots));
+    }
+
+
+    /**
+    * \brief Looks up the stored slot cooldowns of a tribe within a deadline
+    *
+    * The slots are read from the database only if the tribe is neither cached, prefetched nor in the mapped 
+    * snapshot. The read is interrupted at the deadline. A tribe is unavailable if it could not be read in time,
+    * if the database is locked by an other process or while the database is not accessed because of failures.
+    * A failed read is never cached, the tribe is read again on the next lookup.
+    *
+    * \param[in] TribeId the tribe
+    * \param[in] Deadline deadline of the database read, nullptr for no deadline
+    * \param[out] Slots the stored slot cooldowns, not normalized
+    * \param[out] Source origin of the slot cooldowns, optional
+    * \return Lookup_t the result of the lookup
+    */
+    Lookup_t LookupTribeSlots(int TribeId, const std::chrono::steady_clock::time_point* Deadline, std::vector<int64_t>* Slots,
+        LookupSource_t* Source)
+    {
+        LookupSource_t source = SourceSnapshot;
+        bool isInDatabase = false;
+        bool isPrefetched = false;
+        bool isCached = CachedTribes.Find(TribeId, &isInDatabase, Slots, &isPrefetched);
+
+        if (false == isCached)
+        {
+            /* the tribe may have been prefetched since the last lookup */
+            Prefetch::ApplyResults();
+            isCached = CachedTribes.Find(TribeId, &isInDatabase, Slots, &isPrefetched);
+        }
+
+        if (false == isCached)
+        {
+            std::vector<int64_t> slots;
+            bool isCacheable = true;
+
+            Statistics::Increment(Statistics::TribeCacheMiss);
+
+            if (false == Snapshot::FindTribe(TribeId, &isInDatabase, &slots))
+            {
+                bool isDeadlineExceeded = false;
+                ReadResult_t read = ReadFailed;
+
+                source = SourceDatabase;
+
+                if (nullptr != Deadline)
+                {
+                    if (std::chrono::steady_clock::now() >= *Deadline)
+                    {
+                        return LookupUnavailable;
+                    }
+
+                    SlotCooldown::database->SetDeadline(*Deadline);
+                }
+
+                read = SlotCooldown::database->ReadTribe(TribeId, &slots);
+                isInDatabase = (ReadFound == read);
+
+                if (nullptr != Deadline)
+                {
+                    isDeadlineExceeded = SlotCooldown::database->ClearDeadline();
+                }
+
+                /* a tribe read from the journal may be incomplete */
+                isCacheable = (false == SlotCooldown::database->IsCircuitOpen()) && (0 == SlotCooldown::database->GetJournalSize());
+
+                if ((true == isDeadlineExceeded) || (ReadFailed == read))
+                {
+                    if (nullptr != Source)
+                    {
+                        *Source = source;
+                    }
+                    return LookupUnavailable;
+                }
+            }
+
+            if (nullptr != Source)
+            {
+                *Source = source;
+            }
+
+            if ((0 < MaxCachedTribes) && (true == isCacheable))
+            {
+                /* the cache is only a copy of the database, it is simply restarted when it is full */
+                if (MaxCachedTribes <= CachedTribes.Size())
+                {
+                    CachedTribes.Clear();
+                    TribeView::RetractAll();
+                }
+
+                CachedTribes.Insert(TribeId, isInDatabase, slots, false);
+                TribeView::Publish(TribeId, isInDatabase, slots);
+            }
+
+            if (nullptr != Slots)
+            {
+                *Slots = std::move(slots);
+            }
+        }
+        else
+        {
+            Statistics::Increment(Statistics::TribeCacheHit);
+
+            /* only the first lookup is served by the prefetch, the later ones would have hit the cache anyway */
+            if (true == isPrefetched)
+            {
+                CachedTribes.ClearPrefetched(TribeId);
+            }
+
+            if (nullptr != Source)
+            {
+                *Source = (true == isPrefetched) ? SourcePrefetch : SourceCache;
+            }
+        }
+
+        return (true == isInDatabase) ? LookupInDatabase : LookupNotInDatabase;
+    }
+
+
+    /**
+    * \brief Invalidates a tribe
+    *
+    * This function has to be called every time the slots of a tribe change
+    *
+    * \param[in] TribeId the tribe
+    * \return void
+    */
+    void InvalidateTribe(int TribeId)
+    {
+        if (true == CachedTribes.Erase(TribeId))
+        {
+            TribeView::Retract(TribeId);
+        }
+    }
+
+
+    /**
+    * \brief Invalidates all tribes
+    *
+    * \return void
+    */
+    void InvalidateAll(void)
+    {
+        CachedTribes.Clear();
+        TribeView::RetractAll();
+
+        IsCacheSequenceValid = (nullptr != SlotCooldown::database) && (true == SlotCooldown::database->GetChangeSequence(&CacheSequence));
+    }
+
+
+    /**
+    * \brief Iterates over the cached tribes
+    *
+    * \param[in] Callback function that gets called with the tribe id, the database flag and the stored slots
+    * \return void
+    */
+    void ForEachCachedTribe(const std::function<void(int, bool, const std::vector<int64_t>&)>& Callback)
+    {
+        std::vector<int64_t> slots;
+
+        for (size_t i = 0; i < CachedTribes.Capacity(); i++)
+        {
+            int tribeId = 0;
+            bool isInDatabase = false;
+
+            if (true == CachedTribes.GetAt(i, &tribeId, &isInDatabase, &slots))
+            {
+                Callback(tribeId, isInDatabase, slots);
+            }
+        }
+    }
+
+
+    /**
+    * \brief Stores a tribe in the cache
+    *
+    * This function is used to restore the cache and to store prefetched tribes, the tribe has to match the 
+    * database
+    *
+    * \param[in] TribeId the tribe
+    * \param[in] IsInDatabase true if the tribe has an entry in the database
+    * \param[in] Slots the stored slot cooldowns
+    * \param[in] IsPrefetched true if the tribe was read in the background
+    * \return bool true if the tribe was stored, false if the cache is full
+    */
+    bool StoreTribe(int TribeId, bool IsInDatabase, const std::vector<int64_t>& Slots, bool IsPrefetched)
+    {
+        if ((MaxCachedTribes <= CachedTribes.Size()) || (false == CachedTribes.Insert(TribeId, IsInDatabase, Slots, IsPrefetched)))
+        {
+            return false;
+        }
+
+        TribeView::Publish(TribeId, IsInDatabase, Slots);
+
+        return true;
+    }
+
+
+    /**
+    * \brief Checks if a tribe can be looked up without reading the database
+    *
+    * \param[in] TribeId the tribe
+    * \return bool true if the tribe is cached or in the mapped snapshot, otherwise false
+    */
+    bool IsTribeResident(int TribeId)
+    {
+        bool isInDatabase;
+        std::vector<int64_t> slots;
+
+        return (true == CachedTribes.Contains(TribeId)) || (true == Snapshot::FindTribe(TribeId, &isInDatabase, &slots));
+    }
+
+
+    /**
+    * \brief Gets the change sequence of the cache
+    *
+    * Tribes that changed after this sequence may be outdated in the cache
+    *
+    * \param[out] Sequence the change sequence
+    * \return bool true if the sequence is known
+    */
+    bool GetCacheSequence(ChangeSequence_t* Sequence)
+    {
+        if (true == IsCacheSequenceValid)
+        {
+            *Sequence = CacheSequence;
+        }
+
+        return IsCacheSequenceValid;
+    }
+
+
+    /**
+    * \brief Sets the change sequence of the cache
+    *
+    * \param[in] Sequence the change sequence of the restored tribes
+    * \return void
+    */
+    void SetCacheSequence(const ChangeSequence_t& Sequence)
+    {
+        CacheSequence = Sequence;
+        IsCacheSequenceValid = true;
+    }
+
+
+    /**
+    * \brief Gets the usage of the cache
+    *
+    * \param[out] NumOfTribes number of cached tribes
+    * \param[out] Capacity max number of cached tribes
+    * \param[out] MemoryUsage allocated bytes of the cache
+    * \return void
+    */
+    void GetCacheUsage(size_t* NumOfTribes, size_t* Capacity, size_t* MemoryUsage)
+    {
+        *NumOfTribes = CachedTribes.Size();
+        *Capacity = MaxCachedTribes;
+        *MemoryUsage = CachedTribes.GetMemoryUsage();
+    }
+}
+
+/* =================================================[end of file]================================================= */
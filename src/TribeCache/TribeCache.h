@@ -0,0 +1,88 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file TribeCache.h
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Local cache of the slot cooldowns stored in the database
+*
+*/
+
+#ifndef TRIBECACHE_H
+#define TRIBECACHE_H
+
+/* ================================================[includes]================================================ */
+#include "DBHandler.h"
+#include <chrono>
+#include <functional>
+#include <vector>
+
+
+namespace TribeCache
+{
+    /* ================================================[type definitions]======================================== */
+
+    /**
+    *  \brief result of a lookup
+    */
+    typedef enum
+    {
+        LookupInDatabase = 0,   /**< \brief the tribe has an entry in the database */
+        LookupNotInDatabase,    /**< \brief the tribe has no entry in the database */
+        LookupUnavailable       /**< \brief the tribe could not be read within the deadline */
+
+    }Lookup_t;
+
+
+    /**
+    *  \brief origin of the slot cooldowns of a lookup
+    */
+    typedef enum
+    {
+        SourceCache = 0,        /**< \brief tribe was cached by an earlier lookup */
+        SourcePrefetch,         /**< \brief tribe was cached by a background read */
+        SourceSnapshot,         /**< \brief tribe was found in the mapped snapshot */
+        SourceDatabase          /**< \brief tribe was read from the database, also if the read failed */
+
+    }LookupSource_t;
+
+
+    /* ================================================[declaration of public functions]========================= */
+
+    extern void InitTribeCache(int MaxNumOfTribes);
+    extern void RemoveTribeCache();
+    extern bool GetTribeSlots(int TribeId, std::vector<int64_t>* Slots);
+    extern Lookup_t LookupTribeSlots(int TribeId, const std::chrono::steady_clock::time_point* Deadline, std::vector<int64_t>* Slots,
+        LookupSource_t* Source = nullptr);
+    extern bool IsTribeResident(int TribeId);
+    extern void InvalidateTribe(int TribeId);
+    extern void InvalidateAll();
+    extern void ForEachCachedTribe(const std::function<void(int, bool, const std::vector<int64_t>&)>& Callback);
+    extern bool StoreTribe(int TribeId, bool IsInDatabase, const std::vector<int64_t>& Slots, bool IsPrefetched = false);
+    extern bool GetCacheSequence(ChangeSequence_t* Sequence);
+    extern void GetCacheUsage(size_t* NumOfTribes, size_t* Capacity, size_t* MemoryUsage);
+    extern void SetCacheSequence(const ChangeSequence_t& Sequence);
+}
+
+
+#endif /* TRIBECACHE_H */
+
+/* =================================================[end of file]================================================= */
@@ -0,0 +1,633 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file TribeTable.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Flat hash table of the slot cooldowns of tribes
+*
+* The records are stored in one array without a node per tribe. Every record has a control byte that is 
+* empty, deleted or holds 7 bits of the hash of its tribe. A lookup compares the control bytes of a group 
+* of 16 records at once and only reads the records whose bits match, so most lookups touch one cache line
+* of control bytes and one record. The groups are probed one after the other until a group with an empty 
+* record.
+*
+* The capacity is fixed and not rounded to a power of two, the table is filled up to 7/8. Deleted records 
+* are reclaimed by a rehash when no empty record is left.
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "TribeTable.h"
+#include <emmintrin.h>
+#include <cstring>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+
+/* ========================================== [local defines] =============================================== */
+
+/** \brief number of records whose control bytes are compared at once */
+#define GROUP_WIDTH 16
+
+/** \brief control byte of an empty record */
+#define CONTROL_EMPTY ((int8_t)-128)
+
+/** \brief control byte of a deleted record */
+#define CONTROL_DELETED ((int8_t)-2)
+
+/** \brief index returned if a tribe is not found */
+#define INDEX_NOT_FOUND ((size_t)-1)
+
+
+/* ===================================== [prototype of local functions] ======================================= */
+
+static uint64_t GetHash(int TribeId);
+static uint32_t GetLowestBit(uint32_t Mask);
+static uint32_t MatchGroup(const int8_t* Group, int8_t Control);
+static uint32_t MatchFree(const int8_t* Group);
+static bool IsInline(const std::vector<int64_t>& Slots);
+
+
+/* ===================================== [definition of local functions] ====================================== */
+
+/**
+* \brief Checks if the slots of a tribe fit into its record
+*
+* The record stores unsigned 32 bit values, that covers the unix times until 2106
+*
+* \param[in] Slots the slot cooldowns
+* \return bool true if the slots are stored inline, otherwise false
+*/
+static bool IsInline(const std::vector<int64_t>& Slots)
+{
+    if (TRIBE_TABLE_INLINE_SLOTS < Slots.size())
+    {
+        return false;
+    }
+
+    for (int64_t slot : Slots)
+    {
+        if ((0 > slot) || ((int64_t)UINT32_MAX < slot))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/**
+* \brief Gets the hash of a tribe
+*
+* The tribe ids are mixed completely, the low 7 bits go to the control byte and the high 32 bits select the
+* first group
+*
+* \param[in] TribeId the tribe
+* \return uint64_t the hash
+*/
+static uint64_t GetHash(int TribeId)
+{
+    uint64_t hash = (uint64_t)(uint32_t)TribeId;
+
+    hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBULL;
+
+    return hash ^ (hash >> 31);
+}
+
+
+/**
+* \brief Gets the index of the lowest set bit
+*
+* \param[in] Mask the mask, not 0
+* \return uint32_t index of the lowest set bit
+*/
+static uint32_t GetLowestBit(uint32_t Mask)
+{
+#ifdef _MSC_VER
+    unsigned long index = 0;
+
+    _BitScanForward(&index, Mask);
+
+    return (uint32_t)index;
+#else
+    return (uint32_t)__builtin_ctz(Mask);
+#endif
+}
+
+
+/**
+* \brief Matches the control bytes of a group
+*
+* \param[in] Group the control bytes of the group
+* \param[in] Control the control byte to look for
+* \return uint32_t mask with a bit for every matching record of the group
+*/
+static uint32_t MatchGroup(const int8_t* Group, int8_t Control)
+{
+    __m128i group = _mm_loadu_si128((const __m128i*)Group);
+
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(Control)));
+}
+
+
+/**
+* \brief Matches the empty and deleted records of a group
+*
+* \param[in] Group the control bytes of the group
+* \return uint32_t mask with a bit for every empty or deleted record of the group
+*/
+static uint32_t MatchFree(const int8_t* Group)
+{
+    /* only the control bytes of empty and deleted records have the sign bit set */
+    return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)Group));
+}
+
+
+/* ===================================== [definition of member functions] ===================================== */
+
+/**
+* \brief Initialisation of the table
+*
+* All tribes are removed and the memory for the maximum number of tribes is allocated
+*
+* \param[in] MaxNumOfTribes maximum number of tribes, 0 frees the table
+* \return void
+*/
+void TribeTable::Init(size_t MaxNumOfTribes)
+{
+    control.reset();
+    records.reset();
+    capacity = 0;
+
+    if (0 < MaxNumOfTribes)
+    {
+        /* at least 8 records per 7 tribes, rounded up to whole groups */
+        capacity = ((MaxNumOfTribes * 8 / 7) / GROUP_WIDTH + 1) * GROUP_WIDTH;
+        control = std::make_unique<int8_t[]>(capacity);
+        records = std::make_unique<Record_t[]>(capacity);
+    }
+
+    Clear();
+}
+
+
+/**
+* \brief Gets the first group of the probe sequence of a hash
+*
+* \param[in] Hash the hash of the tribe
+* \return size_t index of the group
+*/
+size_t TribeTable::GetFirstGroup(uint64_t Hash) const
+{
+    return (size_t)(((Hash >> 32) * (uint64_t)(capacity / GROUP_WIDTH)) >> 32);
+}
+
+
+/**
+* \brief Finds the record of a tribe
+*
+* \param[in] TribeId the tribe
+* \return size_t index of the record, INDEX_NOT_FOUND if the tribe is not in the table
+*/
+size_t TribeTable::FindIndex(int TribeId) const
+{
+    if (0 == capacity)
+    {
+        return INDEX_NOT_FOUND;
+    }
+
+    const uint64_t hash = GetHash(TribeId);
+    const size_t numOfGroups = capacity / GROUP_WIDTH;
+    size_t group = GetFirstGroup(hash);
+
+    for (size_t probe = 0; probe < numOfGroups; probe++)
+    {
+        const int8_t* groupControl = &control[group * GROUP_WIDTH];
+        uint32_t match = MatchGroup(groupControl, (int8_t)(hash & 0x7F));
+
+        while (0 != match)
+        {
+            size_t index = group * GROUP_WIDTH + GetLowestBit(match);
+
+            if (records[index].tribeId == TribeId)
+            {
+                return index;
+            }
+
+            match &= match - 1;
+        }
+
+        /* the tribe would have been stored in the first empty record of its probe sequence */
+        if (0 != MatchGroup(groupControl, CONTROL_EMPTY))
+        {
+            return INDEX_NOT_FOUND;
+        }
+
+        group = (numOfGroups == group + 1) ? 0 : group + 1;
+    }
+
+    return INDEX_NOT_FOUND;
+}
+
+
+/**
+* \brief Finds the first empty or deleted record of the probe sequence of a hash
+*
+* \param[in] Hash the hash of the tribe
+* \return size_t index of the record, INDEX_NOT_FOUND if the table has no free record
+*/
+size_t TribeTable::FindFreeIndex(uint64_t Hash) const
+{
+    const size_t numOfGroups = capacity / GROUP_WIDTH;
+    size_t group = GetFirstGroup(Hash);
+
+    for (size_t probe = 0; probe < numOfGroups; probe++)
+    {
+        uint32_t match = MatchFree(&control[group * GROUP_WIDTH]);
+
+        if (0 != match)
+        {
+            return group * GROUP_WIDTH + GetLowestBit(match);
+        }
+
+        group = (numOfGroups == group + 1) ? 0 : group + 1;
+    }
+
+    return INDEX_NOT_FOUND;
+}
+
+
+/**
+* \brief Stores the slots of a tribe in its record
+*
+* \param[in,out] Record the record
+* \param[in] Slots the slot cooldowns
+* \return void
+*/
+void TribeTable::StoreSlots(Record_t* Record, const std::vector<int64_t>& Slots)
+{
+    if (true == IsInline(Slots))
+    {
+        Record->isOverflow = false;
+        Record->numOfSlots = (uint8_t)Slots.size();
+
+        for (size_t i = 0; i < Slots.size(); i++)
+        {
+            Record->slots[i] = (uint32_t)Slots[i];
+        }
+    }
+    else
+    {
+        uint32_t index = 0;
+
+        if (false == freeOverflow.empty())
+        {
+            index = freeOverflow.back();
+            freeOverflow.pop_back();
+            overflowPool[index] = Slots;
+        }
+        else
+        {
+            index = (uint32_t)overflowPool.size();
+            overflowPool.push_back(Slots);
+        }
+
+        Record->isOverflow = true;
+        Record->numOfSlots = 0;
+        Record->slots[0] = index;
+    }
+}
+
+
+/**
+* \brief Loads the slots of a tribe from its record
+*
+* \param[in] Record the record
+* \param[out] Slots the slot cooldowns
+* \return void
+*/
+void TribeTable::LoadSlots(const Record_t& Record, std::vector<int64_t>* Slots) const
+{
+    if (true == Record.isOverflow)
+    {
+        *Slots = overflowPool[(size_t)Record.slots[0]];
+    }
+    else
+    {
+        Slots->assign(Record.slots, Record.slots + Record.numOfSlots);
+    }
+}
+
+
+/**
+* \brief Releases the overflow slots of a record
+*
+* \param[in,out] Record the record
+* \return void
+*/
+void TribeTable::ReleaseSlots(Record_t* Record)
+{
+    if (true == Record->isOverflow)
+    {
+        overflowPool[(size_t)Record->slots[0]].clear();
+        overflowPool[(size_t)Record->slots[0]].shrink_to_fit();
+        freeOverflow.push_back(Record->slots[0]);
+        Record->isOverflow = false;
+    }
+}
+
+
+/**
+* \brief Reclaims the deleted records
+*
+* The tribes are stored again at the same capacity, the overflow slots keep their place
+*
+* \return void
+*/
+void TribeTable::Rehash()
+{
+    std::unique_ptr<int8_t[]> oldControl = std::move(control);
+    std::unique_ptr<Record_t[]> oldRecords = std::move(records);
+
+    control = std::make_unique<int8_t[]>(capacity);
+    records = std::make_unique<Record_t[]>(capacity);
+    std::memset(control.get(), CONTROL_EMPTY, capacity);
+
+    for (size_t i = 0; i < capacity; i++)
+    {
+        if (0 <= oldControl[i])
+        {
+            const uint64_t hash = GetHash(oldRecords[i].tribeId);
+            size_t index = FindFreeIndex(hash);
+
+            control[index] = (int8_t)(hash & 0x7F);
+            records[index] = oldRecords[i];
+        }
+    }
+
+    growthLeft = (capacity / 8) * 7 - size;
+}
+
+
+/**
+* \brief Finds a tribe
+*
+* \param[in] TribeId the tribe
+* \param[out] IsInDatabase true if the tribe has an entry in the database
+* \param[out] Slots the slot cooldowns, optional
+* \param[out] IsPrefetched true if the tribe was stored by a background read, optional
+* \return bool true if the tribe is in the table, otherwise false
+*/
+bool TribeTable::Find(int TribeId, bool* IsInDatabase, std::vector<int64_t>* Slots, bool* IsPrefetched) const
+{
+    size_t index = FindIndex(TribeId);
+
+    if (INDEX_NOT_FOUND == index)
+    {
+        return false;
+    }
+
+    *IsInDatabase = records[index].isInDatabase;
+
+    if (nullptr != Slots)
+    {
+        LoadSlots(records[index], Slots);
+    }
+
+    if (nullptr != IsPrefetched)
+    {
+        *IsPrefetched = records[index].isPrefetched;
+    }
+
+    return true;
+}
+
+
+/**
+* \brief Checks if a tribe is in the table
+*
+* \param[in] TribeId the tribe
+* \return bool true if the tribe is in the table, otherwise false
+*/
+bool TribeTable::Contains(int TribeId) const
+{
+    return (INDEX_NOT_FOUND != FindIndex(TribeId));
+}
+
+
+/**
+* \brief Clears the mark of a tribe stored by a background read
+*
+* \param[in] TribeId the tribe
+* \return bool true if the tribe was marked, otherwise false
+*/
+bool TribeTable::ClearPrefetched(int TribeId)
+{
+    size_t index = FindIndex(TribeId);
+    bool isPrefetched = false;
+
+    if (INDEX_NOT_FOUND != index)
+    {
+        isPrefetched = records[index].isPrefetched;
+        records[index].isPrefetched = false;
+    }
+
+    return isPrefetched;
+}
+
+
+/**
+* \brief Inserts a tribe or replaces its record
+*
+* \param[in] TribeId the tribe
+* \param[in] IsInDatabase true if the tribe has an entry in the database
+* \param[in] Slots the slot cooldowns
+* \param[in] IsPrefetched true if the tribe was read in the background
+* \return bool true if the tribe was stored, false if the table is full
+*/
+bool TribeTable::Insert(int TribeId, bool IsInDatabase, const std::vector<int64_t>& Slots, bool IsPrefetched)
+{
+    size_t index = FindIndex(TribeId);
+
+    if (INDEX_NOT_FOUND != index)
+    {
+        ReleaseSlots(&records[index]);
+    }
+    else
+    {
+        const uint64_t hash = GetHash(TribeId);
+
+        if ((capacity / 8) * 7 <= size)
+        {
+            return false;
+        }
+
+        if (0 == growthLeft)
+        {
+            Rehash();
+        }
+
+        index = FindFreeIndex(hash);
+
+        if (CONTROL_EMPTY == control[index])
+        {
+            growthLeft--;
+        }
+
+        control[index] = (int8_t)(hash & 0x7F);
+        size++;
+    }
+
+    records[index].tribeId = (int32_t)TribeId;
+    records[index].isInDatabase = IsInDatabase;
+    records[index].isPrefetched = IsPrefetched;
+    StoreSlots(&records[index], Slots);
+
+    return true;
+}
+
+
+/**
+* \brief Erases a tribe
+*
+* \param[in] TribeId the tribe
+* \return bool true if the tribe was in the table, otherwise false
+*/
+bool TribeTable::Erase(int TribeId)
+{
+    size_t index = FindIndex(TribeId);
+
+    if (INDEX_NOT_FOUND == index)
+    {
+        return false;
+    }
+
+    ReleaseSlots(&records[index]);
+    size--;
+
+    /* a group with an empty record ends every probe sequence, so the record can become empty again */
+    if (0 != MatchGroup(&control[index - (index % GROUP_WIDTH)], CONTROL_EMPTY))
+    {
+        control[index] = CONTROL_EMPTY;
+        growthLeft++;
+    }
+    else
+    {
+        control[index] = CONTROL_DELETED;
+    }
+
+    return true;
+}
+
+
+/**
+* \brief Erases all tribes
+*
+* \return void
+*/
+void TribeTable::Clear()
+{
+    if (0 < capacity)
+    {
+        std::memset(control.get(), CONTROL_EMPTY, capacity);
+    }
+
+    overflowPool.clear();
+    freeOverflow.clear();
+    size = 0;
+    growthLeft = (capacity / 8) * 7;
+}
+
+
+/**
+* \brief Gets the number of tribes
+*
+* \return size_t number of tribes
+*/
+size_t TribeTable::Size() const
+{
+    return size;
+}
+
+
+/**
+* \brief Gets the number of records
+*
+* \return size_t number of records, the indices of GetAt
+*/
+size_t TribeTable::Capacity() const
+{
+    return capacity;
+}
+
+
+/**
+* \brief Gets the tribe of a record
+*
+* The records can be iterated by their index, erasing a tribe does not move the other ones
+*
+* \param[in] Index index of the record
+* \param[out] TribeId the tribe
+* \param[out] IsInDatabase true if the tribe has an entry in the database
+* \param[out] Slots the slot cooldowns
+* \return bool true if the record holds a tribe, otherwise false
+*/
+bool TribeTable::GetAt(size_t Index, int* TribeId, bool* IsInDatabase, std::vector<int64_t>* Slots) const
+{
+    if ((capacity <= Index) || (0 > control[Index]))
+    {
+        return false;
+    }
+
+    *TribeId = records[Index].tribeId;
+    *IsInDatabase = records[Index].isInDatabase;
+    LoadSlots(records[Index], Slots);
+
+    return true;
+}
+
+
+/**
+* \brief Gets the memory used by the table
+*
+* \return size_t allocated bytes of the records, the control bytes and the overflow pool
+*/
+size_t TribeTable::GetMemoryUsage() const
+{
+    size_t result = capacity * (sizeof(int8_t) + sizeof(Record_t));
+
+    result += overflowPool.capacity() * sizeof(std::vector<int64_t>) + freeOverflow.capacity() * sizeof(uint32_t);
+
+    for (const std::vector<int64_t>& slots : overflowPool)
+    {
+        result += slots.capacity() * sizeof(int);
+    }
+
+    return result;
+}
+
+/* =================================================[end of file]================================================= */
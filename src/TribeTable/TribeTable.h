@@ -0,0 +1,114 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file TribeTable.h
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Flat hash table of the slot cooldowns of tribes
+*
+*/
+
+#ifndef TRIBETABLE_H
+#define TRIBETABLE_H
+
+/* ================================================[includes]================================================ */
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+/* ================================================[public defines]========================================== */
+
+/** \brief number of slot cooldowns stored within the record of a tribe, more are stored in the overflow pool */
+#define TRIBE_TABLE_INLINE_SLOTS 6
+
+
+/*!
+* Open addressing hash table by tribe id with a fixed capacity. The slot cooldowns of a tribe are stored 
+* within its record, only large tribes and cooldowns beyond 32 bit unix times use the overflow pool.
+*/
+class TribeTable
+{
+private:
+    /*!
+    * record of a tribe
+    */
+    typedef struct
+    {
+        int32_t tribeId;                                /*!< the tribe */
+        bool isInDatabase;                              /*!< true if the tribe has an entry in the database */
+        bool isPrefetched;                              /*!< true if the tribe was stored by a background read */
+        uint8_t numOfSlots;                             /*!< number of inline slots */
+        bool isOverflow;                                /*!< true if the slots are in the overflow pool */
+        uint32_t slots[TRIBE_TABLE_INLINE_SLOTS];       /*!< inline slots, or the index in the overflow pool */
+
+    }Record_t;
+
+    /*! control byte of every record, the low bits of the hash if used */
+    std::unique_ptr<int8_t[]> control;
+
+    /*! the records */
+    std::unique_ptr<Record_t[]> records;
+
+    /*! slots of the tribes whose slots do not fit into the record */
+    std::vector<std::vector<int64_t>> overflowPool;
+
+    /*! unused entries of the overflow pool */
+    std::vector<uint32_t> freeOverflow;
+
+    /*! number of records, a multiple of the group width */
+    size_t capacity = 0;
+
+    /*! number of tribes */
+    size_t size = 0;
+
+    /*! number of tribes that can be inserted until the deleted records have to be reclaimed */
+    size_t growthLeft = 0;
+
+    size_t GetFirstGroup(uint64_t Hash) const;
+    size_t FindIndex(int TribeId) const;
+    size_t FindFreeIndex(uint64_t Hash) const;
+    void StoreSlots(Record_t* Record, const std::vector<int64_t>& Slots);
+    void LoadSlots(const Record_t& Record, std::vector<int64_t>* Slots) const;
+    void ReleaseSlots(Record_t* Record);
+    void Rehash();
+
+public:
+    /*!
+    * table interfaces; see implementation for further information
+    */
+    void Init(size_t MaxNumOfTribes);
+    bool Find(int TribeId, bool* IsInDatabase, std::vector<int64_t>* Slots, bool* IsPrefetched = nullptr) const;
+    bool Contains(int TribeId) const;
+    bool ClearPrefetched(int TribeId);
+    bool Insert(int TribeId, bool IsInDatabase, const std::vector<int64_t>& Slots, bool IsPrefetched);
+    bool Erase(int TribeId);
+    void Clear();
+    size_t Size() const;
+    size_t Capacity() const;
+    bool GetAt(size_t Index, int* TribeId, bool* IsInDatabase, std::vector<int64_t>* Slots) const;
+    size_t GetMemoryUsage() const;
+};
+
+
+#endif /* TRIBETABLE_H */
+
+/* =================================================[end of file]================================================= */
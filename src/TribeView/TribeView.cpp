@@ -0,0 +1,534 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file TribeView.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Lock free view of the cached tribes for all threads
+*
+* The game thread publishes every tribe of the tribe cache as an immutable record, other threads read them 
+* without locks. The records are kept in a fixed number of buckets. A change copies the chain of records of 
+* its bucket and swaps it in, readers that still walk the old chain see a consistent state of the tribes.
+*
+* Old chains are reclaimed by epochs. A reader announces the epoch it started in, a chain swapped out in an 
+* epoch gets deleted once every active reader started in a later epoch. Readers never wait, only the first 
+* read of a thread claims a reader slot.
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "TribeView.h"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+
+namespace TribeView
+{
+    /* ========================================== [local defines] =============================================== */
+
+    /** \brief maximum number of threads reading the view */
+    #define MAX_NUM_OF_READERS 64
+
+    /** \brief number of swapped out chains that triggers a reclamation */
+    #define RECLAIM_THRESHOLD 64
+
+    /** \brief size of a cache line, the reader slots do not share them */
+    #define CACHE_LINE_SIZE 64
+
+    /** \brief multiplier of the fibonacci hashing of the tribe ids */
+    #define HASH_MULTIPLIER 0x9E3779B97F4A7C15ULL
+
+
+    /* ============================================ [type definitions] ============================================ */
+
+    /**
+    *  \brief immutable record of a tribe
+    */
+    typedef struct Record_s
+    {
+        int tribeId;                    /**< \brief the tribe */
+        bool isInDatabase;              /**< \brief true if the tribe has an entry in the database */
+        std::vector<int64_t> slots;         /**< \brief the stored slot cooldowns */
+        const struct Record_s* next;    /**< \brief next record of the bucket */
+
+    }Record_t;
+
+
+    /**
+    *  \brief state of a reading thread
+    */
+    typedef struct alignas(CACHE_LINE_SIZE)
+    {
+        std::atomic<bool> isClaimed;    /**< \brief true if the slot belongs to a thread */
+        std::atomic<uint64_t> epoch;    /**< \brief epoch of the running read, 0 if the thread does not read */
+
+    }ReaderSlot_t;
+
+
+    /**
+    *  \brief reader slot of a thread, the slot is released when the thread ends
+    */
+    class ReaderRegistration
+    {
+    public:
+        ~ReaderRegistration();
+
+        int slot = -1;      /**< \brief index of the claimed reader slot, -1 if none */
+        int depth = 0;      /**< \brief number of nested reads */
+    };
+
+
+    /* =============================================== [local data] =============================================== */
+
+    /** \brief buckets with the chains of records, nullptr if the view is disabled */
+    static std::unique_ptr<std::atomic<const Record_t*>[]> Buckets;
+
+    /** \brief number of buckets */
+    static size_t NumOfBuckets = 0;
+
+    /** \brief shift of the hash to the bucket index */
+    static int BucketShift = 0;
+
+    /** \brief number of published records, only used by the game thread */
+    static size_t NumOfRecords = 0;
+
+    /** \brief current epoch, incremented by every swap */
+    static std::atomic<uint64_t> GlobalEpoch(1);
+
+    /** \brief state of the reading threads */
+    static ReaderSlot_t ReaderSlots[MAX_NUM_OF_READERS];
+
+    /** \brief swapped out chains and the epoch of their swap, ascending by epoch, only used by the game thread */
+    static std::vector<std::pair<uint64_t, const Record_t*>> RetiredChains;
+
+    /** \brief reader slot of the current thread */
+    static thread_local ReaderRegistration Registration;
+
+
+    /* ===================================== [prototype of local functions] ======================================= */
+
+    static size_t GetBucket(int TribeId);
+    static void DeleteChain(const Record_t* Chain);
+    static void Retire(const Record_t* Chain);
+    static void Reclaim(void);
+    static void Swap(size_t Bucket, int TribeId, Record_t* Record);
+    static bool BeginRead(void);
+    static void EndRead(void);
+
+
+    /* ===================================== [definition of local functions] ====================================== */
+
+    /**
+    * \brief Releases the reader slot of a thread
+    */
+    ReaderRegistration::~ReaderRegistration()
+    {
+        if (0 <= slot)
+        {
+            ReaderSlots[slot].epoch = 0;
+            ReaderSlots[slot].isClaimed = false;
+        }
+    }
+
+
+    /**
+    * \brief Gets the bucket of a tribe
+    *
+    * \param[in] TribeId the tribe
+    * \return size_t index of the bucket
+    */
+    static size_t GetBucket(int TribeId)
+    {
+        return (size_t)(((uint64_t)(uint32_t)TribeId * HASH_MULTIPLIER) >> BucketShift);
+    }
+
+
+    /**
+    * \brief Deletes a chain of records
+    *
+    * \param[in] Chain first record of the chain
+    * \return void
+    */
+    static void DeleteChain(const Record_t* Chain)
+    {
+        while (nullptr != Chain)
+        {
+            const Record_t* next = Chain->next;
+            delete Chain;
+            Chain = next;
+        }
+    }
+
+
+    /**
+    * \brief Retires a swapped out chain
+    *
+    * The chain is deleted once no reader can walk it anymore
+    *
+    * \param[in] Chain first record of the chain
+    * \return void
+    */
+    static void Retire(const Record_t* Chain)
+    {
+        if (nullptr == Chain)
+        {
+            return;
+        }
+
+        /* a reader that announces a later epoch started after the swap and can not see the chain */
+        RetiredChains.emplace_back(GlobalEpoch.fetch_add(1), Chain);
+
+        if (RECLAIM_THRESHOLD <= RetiredChains.size())
+        {
+            Reclaim();
+        }
+    }
+
+
+    /**
+    * \brief Deletes the retired chains no reader can walk anymore
+    *
+    * \return void
+    */
+    static void Reclaim(void)
+    {
+        uint64_t oldestEpoch = UINT64_MAX;
+        size_t numOfReclaimed = 0;
+
+        for (ReaderSlot_t& reader : ReaderSlots)
+        {
+            uint64_t epoch = reader.epoch;
+
+            if (0 != epoch)
+            {
+                oldestEpoch = (std::min)(oldestEpoch, epoch);
+            }
+        }
+
+        while ((numOfReclaimed < RetiredChains.size()) && (RetiredChains[numOfReclaimed].first < oldestEpoch))
+        {
+            DeleteChain(RetiredChains[numOfReclaimed].second);
+            numOfReclaimed++;
+        }
+
+        RetiredChains.erase(RetiredChains.begin(), RetiredChains.begin() + numOfReclaimed);
+    }
+
+
+    /**
+    * \brief Swaps in a new chain of a bucket
+    *
+    * The new chain is a copy of the current one without the record of the tribe, followed by the new record
+    *
+    * \param[in] Bucket index of the bucket
+    * \param[in] TribeId the changed tribe
+    * \param[in] Record new record of the tribe, nullptr to remove the tribe
+    * \return void
+    */
+    static void Swap(size_t Bucket, int TribeId, Record_t* Record)
+    {
+        const Record_t* chain = Buckets[Bucket];
+        Record_t* head = Record;
+        bool isFound = false;
+
+        for (const Record_t* record = chain; nullptr != record; record = record->next)
+        {
+            if (record->tribeId == TribeId)
+            {
+                isFound = true;
+            }
+            else
+            {
+                head = new Record_t{ record->tribeId, record->isInDatabase, record->slots, head };
+            }
+        }
+
+        if ((false == isFound) && (nullptr == Record))
+        {
+            DeleteChain(head);
+            return;
+        }
+
+        NumOfRecords = NumOfRecords + ((nullptr != Record) ? 1 : 0) - ((true == isFound) ? 1 : 0);
+
+        Buckets[Bucket] = head;
+        Retire(chain);
+    }
+
+
+    /**
+    * \brief Begins a read of the current thread
+    *
+    * \return bool true if the thread can read, false if all reader slots are claimed
+    */
+    static bool BeginRead(void)
+    {
+        if (0 > Registration.slot)
+        {
+            for (int i = 0; (i < MAX_NUM_OF_READERS) && (0 > Registration.slot); i++)
+            {
+                bool isClaimed = false;
+
+                if (true == ReaderSlots[i].isClaimed.compare_exchange_strong(isClaimed, true))
+                {
+                    Registration.slot = i;
+                }
+            }
+
+            if (0 > Registration.slot)
+            {
+                return false;
+            }
+        }
+
+        /* the epoch has to be announced before the first bucket is loaded */
+        if (0 == Registration.depth)
+        {
+            ReaderSlots[Registration.slot].epoch = GlobalEpoch.load();
+        }
+
+        Registration.depth++;
+
+        return true;
+    }
+
+
+    /**
+    * \brief Ends a read of the current thread
+    *
+    * \return void
+    */
+    static void EndRead(void)
+    {
+        Registration.depth--;
+
+        if (0 == Registration.depth)
+        {
+            ReaderSlots[Registration.slot].epoch = 0;
+        }
+    }
+
+
+    /* ===================================== [definition of global functions] ===================================== */
+
+    /**
+    * \brief Initialisation of the view
+    *
+    * The number of buckets is fixed, the chains stay short as long as the view holds at most the given number
+    * of tribes
+    *
+    * \param[in] MaxNumOfTribes expected maximum number of tribes, 0 disables the view
+    * \return void
+    */
+    void InitTribeView(size_t MaxNumOfTribes)
+    {
+        RemoveTribeView();
+
+        if (0 == MaxNumOfTribes)
+        {
+            return;
+        }
+
+        NumOfBuckets = 1;
+        BucketShift = 64;
+
+        while (NumOfBuckets < MaxNumOfTribes)
+        {
+            NumOfBuckets <<= 1;
+            BucketShift--;
+        }
+
+        /* the shift of a 64 bit value has to be below 64 */
+        if (64 == BucketShift)
+        {
+            NumOfBuckets = 2;
+            BucketShift = 63;
+        }
+
+        Buckets = std::make_unique<std::atomic<const Record_t*>[]>(NumOfBuckets);
+
+        for (size_t i = 0; i < NumOfBuckets; i++)
+        {
+            Buckets[i] = nullptr;
+        }
+    }
+
+
+    /**
+    * \brief Remove of the view
+    *
+    * All threads reading the view have to be stopped before
+    *
+    * \return void
+    */
+    void RemoveTribeView(void)
+    {
+        for (size_t i = 0; i < NumOfBuckets; i++)
+        {
+            DeleteChain(Buckets[i]);
+        }
+
+        for (auto& retired : RetiredChains)
+        {
+            DeleteChain(retired.second);
+        }
+
+        RetiredChains.clear();
+        Buckets.reset();
+        NumOfBuckets = 0;
+        NumOfRecords = 0;
+    }
+
+
+    /**
+    * \brief Publishes the record of a tribe
+    *
+    * This function may only be called by the game thread, readers that already found the old record keep it
+    *
+    * \param[in] TribeId the tribe
+    * \param[in] IsInDatabase true if the tribe has an entry in the database
+    * \param[in] Slots the stored slot cooldowns
+    * \return void
+    */
+    void Publish(int TribeId, bool IsInDatabase, const std::vector<int64_t>& Slots)
+    {
+        if (nullptr != Buckets)
+        {
+            Swap(GetBucket(TribeId), TribeId, new Record_t{ TribeId, IsInDatabase, Slots, nullptr });
+        }
+    }
+
+
+    /**
+    * \brief Removes the record of a tribe
+    *
+    * This function may only be called by the game thread
+    *
+    * \param[in] TribeId the tribe
+    * \return void
+    */
+    void Retract(int TribeId)
+    {
+        if (nullptr != Buckets)
+        {
+            Swap(GetBucket(TribeId), TribeId, nullptr);
+        }
+    }
+
+
+    /**
+    * \brief Removes the records of all tribes
+    *
+    * This function may only be called by the game thread
+    *
+    * \return void
+    */
+    void RetractAll(void)
+    {
+        if ((nullptr == Buckets) || (0 == NumOfRecords))
+        {
+            return;
+        }
+
+        for (size_t i = 0; i < NumOfBuckets; i++)
+        {
+            Retire(Buckets[i].exchange(nullptr));
+        }
+
+        NumOfRecords = 0;
+    }
+
+
+    /**
+    * \brief Reads the record of a tribe
+    *
+    * This function can be called by any thread, it does not wait for the game thread
+    *
+    * \param[in] TribeId the tribe
+    * \param[out] IsInDatabase true if the tribe has an entry in the database
+    * \param[out] Slots the stored slot cooldowns, not normalized
+    * \return bool true if the tribe is in the view
+    */
+    bool ReadTribe(int TribeId, bool* IsInDatabase, std::vector<int64_t>* Slots)
+    {
+        bool isFound = false;
+
+        if ((nullptr == Buckets) || (false == BeginRead()))
+        {
+            return false;
+        }
+
+        for (const Record_t* record = Buckets[GetBucket(TribeId)]; nullptr != record; record = record->next)
+        {
+            if (record->tribeId == TribeId)
+            {
+                *IsInDatabase = record->isInDatabase;
+                *Slots = record->slots;
+                isFound = true;
+                break;
+            }
+        }
+
+        EndRead();
+
+        return isFound;
+    }
+
+
+    /**
+    * \brief Checks if a tribe is in the view
+    *
+    * This function can be called by any thread, it does not wait for the game thread
+    *
+    * \param[in] TribeId the tribe
+    * \return bool true if the tribe is in the view
+    */
+    bool ContainsTribe(int TribeId)
+    {
+        bool isFound = false;
+
+        if ((nullptr == Buckets) || (false == BeginRead()))
+        {
+            return false;
+        }
+
+        for (const Record_t* record = Buckets[GetBucket(TribeId)]; nullptr != record; record = record->next)
+        {
+            if (record->tribeId == TribeId)
+            {
+                isFound = true;
+                break;
+            }
+        }
+
+        EndRead();
+
+        return isFound;
+    }
+}
+
+/* =================================================[end of file]================================================= */
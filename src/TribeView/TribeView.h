@@ -0,0 +1,54 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file TribeView.h
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Lock free view of the cached tribes for all threads
+*
+*/
+
+#ifndef TRIBEVIEW_H
+#define TRIBEVIEW_H
+
+/* ================================================[includes]================================================ */
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace TribeView
+{
+    /* ================================================[declaration of public functions]========================= */
+
+    extern void InitTribeView(size_t MaxNumOfTribes);
+    extern void RemoveTribeView();
+    extern void Publish(int TribeId, bool IsInDatabase, const std::vector<int64_t>& Slots);
+    extern void Retract(int TribeId);
+    extern void RetractAll();
+    extern bool ReadTribe(int TribeId, bool* IsInDatabase, std::vector<int64_t>* Slots);
+    extern bool ContainsTribe(int TribeId);
+}
+
+
+#endif /* TRIBEVIEW_H */
+
+/* =================================================[end of file]================================================= */
@@ -0,0 +1,253 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file ArchiveTest.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 19 October 2026
+* \brief Tests of the archive of the database of past seasons
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "Archive.h"
+#include "Backup.h"
+#include "DBHandler.h"
+#include "SlotCooldown.h"
+#include "API/ARK/Ark.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+/* ========================================== [local defines] =============================================== */
+
+/** \brief slot cooldowns of the archived tribe */
+#define TEST_SLOTS { 2000000000, 2000000001 }
+
+/** \brief time the test waits for a backup */
+#define BACKUP_TIMEOUT std::chrono::seconds(10)
+
+
+/* ============================================ [type definitions] ============================================ */
+
+/**
+* \brief Fixture with the database of a season in a temporary directory
+*/
+class ArchiveTest : public ::testing::Test
+{
+protected:
+    std::filesystem::path directory;
+    std::filesystem::path archiveDirectory;
+    std::string path;
+
+    void SetUp() override
+    {
+        directory = std::filesystem::temp_directory_path() / "ArchiveTest";
+        archiveDirectory = directory / "Archives";
+        path = (directory / "Slots.db").string();
+
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+
+        SlotCooldown::database = std::make_unique<DBHandler>(path);
+        SlotCooldown::database->AddTribe(42);
+        SlotCooldown::database->UpdateSlotTimer(42, TEST_SLOTS);
+    }
+
+    void TearDown() override
+    {
+        Backup::RemoveBackup();
+        Archive::RemoveArchive();
+        SlotCooldown::database.reset();
+
+        std::error_code error;
+        std::filesystem::remove_all(directory, error);
+    }
+};
+
+
+/* ===================================== [definition of local functions] ====================================== */
+
+/**
+* \brief Gets the names of the archives
+*
+* \return std::vector<std::string> the names sorted by age
+*/
+static std::vector<std::string> GetArchiveNames(void)
+{
+    std::vector<Archive::ArchiveInfo_t> archives;
+    std::vector<std::string> names;
+
+    Archive::ListArchives(&archives);
+
+    for (const Archive::ArchiveInfo_t& archive : archives)
+    {
+        names.push_back(archive.name);
+    }
+
+    return names;
+}
+
+
+/**
+* \brief Counts the backups of the database
+*
+* \param[in] Directory directory of the backups
+* \return int number of the backups
+*/
+static int CountBackups(const std::filesystem::path& Directory)
+{
+    int numOfBackups = 0;
+
+    for (const auto& entry : std::filesystem::directory_iterator(Directory))
+    {
+        if (0 == entry.path().filename().string().rfind("Slots_Backup_", 0))
+        {
+            numOfBackups++;
+        }
+    }
+
+    return numOfBackups;
+}
+
+
+/* ============================================== [tests] ===================================================== */
+
+TEST_F(ArchiveTest, DatabaseIsReopenedEmptyAfterTheArchive)
+{
+    std::vector<Archive::ArchiveInfo_t> archives;
+
+    Archive::InitArchive(true, path, archiveDirectory.string());
+
+    ASSERT_TRUE(Archive::ArchiveDatabase());
+
+    /* the new season starts with an empty database in the same file */
+    EXPECT_FALSE(SlotCooldown::database->IsTribeInDatabase(42));
+    SlotCooldown::database->AddTribe(43);
+    EXPECT_TRUE(SlotCooldown::database->UpdateSlotTimer(43, { 2000000002 }));
+    EXPECT_TRUE(std::filesystem::exists(path));
+
+    {
+        DBHandler other(path);
+
+        EXPECT_FALSE(other.IsTribeInDatabase(42));
+        EXPECT_EQ(std::vector<int64_t>({ 2000000002 }), other.GetTribeSlotsTimer(43));
+    }
+
+    Archive::ListArchives(&archives);
+
+    ASSERT_EQ(1u, archives.size());
+    EXPECT_EQ(0u, archives[0].name.rfind("Slots_Archive_", 0));
+    EXPECT_LT(0u, archives[0].size);
+}
+
+
+TEST_F(ArchiveTest, ArchiveIsQueriedByItsListedName)
+{
+    std::vector<int64_t> slots;
+
+    Archive::InitArchive(true, path, archiveDirectory.string());
+
+    ASSERT_TRUE(Archive::ArchiveDatabase());
+
+    std::vector<std::string> names = GetArchiveNames();
+
+    ASSERT_EQ(1u, names.size());
+    EXPECT_EQ(Archive::QueryOk, Archive::QueryArchive(names[0], 42, &slots));
+    EXPECT_EQ(std::vector<int64_t>(TEST_SLOTS), slots);
+    EXPECT_EQ(Archive::QueryTribeNotFound, Archive::QueryArchive(names[0], 43, &slots));
+
+    /* only listed archives are opened, never other files */
+    EXPECT_EQ(Archive::QueryArchiveNotFound, Archive::QueryArchive("Slots.db", 42, &slots));
+    EXPECT_EQ(Archive::QueryArchiveNotFound, Archive::QueryArchive("../Slots.db", 42, &slots));
+    EXPECT_EQ(Archive::QueryArchiveNotFound, Archive::QueryArchive(names[0], 42, nullptr));
+    EXPECT_STREQ("TribeNotFound", Archive::GetQueryResultName(Archive::QueryTribeNotFound));
+}
+
+
+TEST_F(ArchiveTest, ArchivesAndBackupsInTheSameDirectoryAreKeptApart)
+{
+    std::vector<int64_t> slots;
+
+    Archive::InitArchive(true, path, directory.string());
+    Backup::InitBackup(path, directory.string(), 0, 1, 1000);
+
+    ASSERT_TRUE(Archive::ArchiveDatabase());
+
+    /* the retention keeps one backup and must not count the archive, a request is only accepted after the 
+       previous backup was written */
+    for (int i = 0; i < 3; i++)
+    {
+        const auto timeout = std::chrono::steady_clock::now() + BACKUP_TIMEOUT;
+
+        while ((false == Backup::RequestBackup()) && (std::chrono::steady_clock::now() < timeout))
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    Backup::RemoveBackup();
+
+    std::vector<std::string> names = GetArchiveNames();
+
+    ASSERT_EQ(1u, names.size());
+    EXPECT_EQ(0u, names[0].rfind("Slots_Archive_", 0));
+    EXPECT_EQ(Archive::QueryOk, Archive::QueryArchive(names[0], 42, &slots));
+    EXPECT_EQ(Archive::QueryArchiveNotFound, Archive::QueryArchive("Slots.db", 42, &slots));
+    EXPECT_EQ(1, CountBackups(directory));
+}
+
+
+TEST_F(ArchiveTest, FailedRenameKeepsTheDatabaseWorking)
+{
+    uint64_t errors = 0;
+
+    /* the archives can not be written below a file */
+    std::ofstream(archiveDirectory) << "not a directory";
+
+    Archive::InitArchive(true, path, archiveDirectory.string());
+    errors = Log::GetLog()->errors;
+
+    /* the rename fails after the database was closed, it is reopened at its path */
+    EXPECT_FALSE(Archive::ArchiveDatabase());
+    EXPECT_EQ(errors + 1, Log::GetLog()->errors);
+
+    EXPECT_EQ(std::vector<int64_t>(TEST_SLOTS), SlotCooldown::database->GetTribeSlotsTimer(42));
+    SlotCooldown::database->AddTribe(43);
+    EXPECT_TRUE(SlotCooldown::database->UpdateSlotTimer(43, { 2000000002 }));
+
+    {
+        DBHandler other(path);
+
+        EXPECT_EQ(std::vector<int64_t>(TEST_SLOTS), other.GetTribeSlotsTimer(42));
+        EXPECT_EQ(std::vector<int64_t>({ 2000000002 }), other.GetTribeSlotsTimer(43));
+    }
+
+    EXPECT_TRUE(GetArchiveNames().empty());
+}
+
+
+/* =================================================[end of file]================================================= */
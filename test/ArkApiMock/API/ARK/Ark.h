@@ -0,0 +1,166 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file Ark.h
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Stand-in of the Ark Server API for the tests, it provides only the parts used by the modules under test
+*
+*/
+
+#ifndef ARK_MOCK_H
+#define ARK_MOCK_H
+
+/* ================================================[includes]================================================ */
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+
+/* ================================================[type definitions]======================================== */
+
+/**
+*  \brief string of the game, the format arguments are not evaluated
+*/
+class FString
+{
+public:
+    FString() = default;
+    FString(const char* Text) : text(Text) {}
+    FString(const std::string& Text) : text(Text) {}
+    FString(const wchar_t* Text);
+
+    template<typename... Args>
+    static FString Format(const char* Text, Args&&...) { return FString(Text); }
+
+    FString& operator+=(const FString& Other) { text += Other.text; return *this; }
+    bool operator<(const FString& Other) const { return text < Other.text; }
+    bool operator==(const FString& Other) const { return text == Other.text; }
+    const std::string& ToString() const { return text; }
+
+private:
+    std::string text;
+};
+
+
+/**
+*  \brief logger of the plugin, the messages are counted and dropped
+*/
+class Logger
+{
+public:
+    template<typename... Args> void error(const char*, Args&&...) { errors++; }
+    template<typename... Args> void warn(const char*, Args&&...) { warnings++; }
+    template<typename... Args> void info(const char*, Args&&...) {}
+    template<typename... Args> void debug(const char*, Args&&...) {}
+
+    uint64_t errors = 0;
+    uint64_t warnings = 0;
+};
+
+
+/**
+*  \brief log of the plugin
+*/
+class Log
+{
+public:
+    static std::shared_ptr<Logger> GetLog();
+};
+
+
+/**
+*  \brief world of the game
+*/
+class UWorld
+{
+public:
+    float& TimeSecondsField() { return timeSeconds; }
+
+private:
+    float timeSeconds = 0.0f;
+};
+
+
+/**
+*  \brief game mode of the server
+*/
+class AShooterGameMode
+{
+public:
+    int& MaxNumberOfPlayersInTribeField() { return maxNumberOfPlayersInTribe; }
+
+private:
+    int maxNumberOfPlayersInTribe = 10;
+};
+
+
+namespace ArkApi
+{
+    /**
+    *  \brief utilities of the game
+    */
+    class IApiUtils
+    {
+    public:
+        UWorld* GetWorld();
+        AShooterGameMode* GetShooterGameMode();
+    };
+
+
+    /**
+    *  \brief commands and callbacks of the game
+    */
+    class ICommands
+    {
+    public:
+        void AddOnTickCallback(const FString& Id, const std::function<void(float)>& Callback);
+        bool RemoveOnTickCallback(const FString& Id);
+        void AddOnTimerCallback(const FString& Id, const std::function<void()>& Callback);
+        bool RemoveOnTimerCallback(const FString& Id);
+    };
+
+
+    extern IApiUtils& GetApiUtils();
+    extern ICommands& GetCommands();
+
+
+    namespace Tools
+    {
+        extern std::string GetCurrentDir();
+        extern std::wstring Utf8Decode(const std::string& Text);
+    }
+}
+
+
+namespace ArkApiMock
+{
+    extern void Tick(float DeltaSeconds);
+    extern void Timer();
+    extern size_t GetNumOfTickCallbacks();
+    extern void SetWorld(UWorld* NewWorld);
+}
+
+
+#endif /* ARK_MOCK_H */
+
+/* =================================================[end of file]================================================= */
@@ -0,0 +1,312 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file ArkApiMock.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Stand-in of the Ark Server API for the tests
+*
+* The tick and timer callbacks are stored and called by the test with ArkApiMock::Tick and ArkApiMock::Timer,
+* there is no world until a test sets one. The game mode allows 10 players per tribe unless a test changes it.
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "API/ARK/Ark.h"
+#include <filesystem>
+#include <map>
+
+
+/* =============================================== [local data] =============================================== */
+
+/** \brief registered tick callbacks */
+static std::map<FString, std::function<void(float)>> TickCallbacks;
+
+/** \brief registered timer callbacks */
+static std::map<FString, std::function<void()>> TimerCallbacks;
+
+/** \brief world returned to the modules */
+static UWorld* World = nullptr;
+
+/** \brief game mode returned to the modules */
+static AShooterGameMode GameMode;
+
+
+/* ===================================== [definition of global functions] ===================================== */
+
+/**
+* \brief Creates a string of the game from a wide string
+*
+* \param[in] Text the wide string, it is stored as utf-8
+*/
+FString::FString(const wchar_t* Text)
+{
+    for (; 0 != *Text; Text++)
+    {
+        uint32_t code = (uint32_t)*Text;
+
+        if (0x80 > code)
+        {
+            text += (char)code;
+        }
+        else if (0x800 > code)
+        {
+            text += (char)(0xC0 | (code >> 6));
+            text += (char)(0x80 | (code & 0x3F));
+        }
+        else if (0x10000 > code)
+        {
+            text += (char)(0xE0 | (code >> 12));
+            text += (char)(0x80 | ((code >> 6) & 0x3F));
+            text += (char)(0x80 | (code & 0x3F));
+        }
+        else
+        {
+            text += (char)(0xF0 | (code >> 18));
+            text += (char)(0x80 | ((code >> 12) & 0x3F));
+            text += (char)(0x80 | ((code >> 6) & 0x3F));
+            text += (char)(0x80 | (code & 0x3F));
+        }
+    }
+}
+
+
+/**
+* \brief Gets the log of the plugin
+*
+* \return std::shared_ptr<Logger> logger
+*/
+std::shared_ptr<Logger> Log::GetLog(void)
+{
+    static std::shared_ptr<Logger> logger = std::make_shared<Logger>();
+
+    return logger;
+}
+
+
+namespace ArkApi
+{
+    /**
+    * \brief Gets the world of the game
+    *
+    * \return UWorld* world set by the test, nullptr without one
+    */
+    UWorld* IApiUtils::GetWorld(void)
+    {
+        return World;
+    }
+
+
+    /**
+    * \brief Gets the game mode of the server
+    *
+    * \return AShooterGameMode* game mode
+    */
+    AShooterGameMode* IApiUtils::GetShooterGameMode(void)
+    {
+        return &GameMode;
+    }
+
+
+    /**
+    * \brief Adds a tick callback
+    *
+    * \param[in] Id id of the callback
+    * \param[in] Callback callback
+    * \return void
+    */
+    void ICommands::AddOnTickCallback(const FString& Id, const std::function<void(float)>& Callback)
+    {
+        TickCallbacks[Id] = Callback;
+    }
+
+
+    /**
+    * \brief Removes a tick callback
+    *
+    * \param[in] Id id of the callback
+    * \return bool true if the callback was registered
+    */
+    bool ICommands::RemoveOnTickCallback(const FString& Id)
+    {
+        return (0 < TickCallbacks.erase(Id));
+    }
+
+
+    /**
+    * \brief Adds a timer callback
+    *
+    * \param[in] Id id of the callback
+    * \param[in] Callback callback
+    * \return void
+    */
+    void ICommands::AddOnTimerCallback(const FString& Id, const std::function<void()>& Callback)
+    {
+        TimerCallbacks[Id] = Callback;
+    }
+
+
+    /**
+    * \brief Removes a timer callback
+    *
+    * \param[in] Id id of the callback
+    * \return bool true if the callback was registered
+    */
+    bool ICommands::RemoveOnTimerCallback(const FString& Id)
+    {
+        return (0 < TimerCallbacks.erase(Id));
+    }
+
+
+    /**
+    * \brief Gets the utilities of the game
+    *
+    * \return IApiUtils& utilities
+    */
+    IApiUtils& GetApiUtils(void)
+    {
+        static IApiUtils apiUtils;
+
+        return apiUtils;
+    }
+
+
+    /**
+    * \brief Gets the commands of the game
+    *
+    * \return ICommands& commands
+    */
+    ICommands& GetCommands(void)
+    {
+        static ICommands commands;
+
+        return commands;
+    }
+
+
+    namespace Tools
+    {
+        /**
+        * \brief Gets the directory of the server
+        *
+        * \return std::string working directory of the test
+        */
+        std::string GetCurrentDir(void)
+        {
+            return std::filesystem::current_path().string();
+        }
+
+
+        /**
+        * \brief Decodes an utf-8 string
+        *
+        * \param[in] Text the utf-8 string, it has to be valid
+        * \return std::wstring the decoded string
+        */
+        std::wstring Utf8Decode(const std::string& Text)
+        {
+            std::wstring result;
+            size_t position = 0;
+
+            while (position < Text.size())
+            {
+                uint32_t lead = (unsigned char)Text[position];
+                size_t length = (0x80 > lead) ? 1 : (0xE0 > lead) ? 2 : (0xF0 > lead) ? 3 : 4;
+                uint32_t code = (1 == length) ? lead : (lead & (0xFF >> (length + 1)));
+
+                for (size_t i = 1; (i < length) && ((position + i) < Text.size()); i++)
+                {
+                    code = (code << 6) | ((unsigned char)Text[position + i] & 0x3F);
+                }
+
+                result += (wchar_t)code;
+                position += length;
+            }
+
+            return result;
+        }
+    }
+}
+
+
+namespace ArkApiMock
+{
+    /**
+    * \brief Calls all tick callbacks once
+    *
+    * \param[in] DeltaSeconds seconds since the last tick
+    * \return void
+    */
+    void Tick(float DeltaSeconds)
+    {
+        /* a callback can remove itself */
+        auto callbacks = TickCallbacks;
+
+        for (auto& callback : callbacks)
+        {
+            callback.second(DeltaSeconds);
+        }
+    }
+
+
+    /**
+    * \brief Calls all timer callbacks once, like the game does every second
+    *
+    * \return void
+    */
+    void Timer(void)
+    {
+        /* a callback can remove itself */
+        auto callbacks = TimerCallbacks;
+
+        for (auto& callback : callbacks)
+        {
+            callback.second();
+        }
+    }
+
+
+    /**
+    * \brief Gets the number of registered tick callbacks
+    *
+    * \return size_t number of callbacks
+    */
+    size_t GetNumOfTickCallbacks(void)
+    {
+        return TickCallbacks.size();
+    }
+
+
+    /**
+    * \brief Sets the world of the game
+    *
+    * \param[in] NewWorld world, nullptr if there is no world
+    * \return void
+    */
+    void SetWorld(UWorld* NewWorld)
+    {
+        World = NewWorld;
+    }
+}
+
+/* =================================================[end of file]================================================= */
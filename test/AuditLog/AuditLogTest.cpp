@@ -0,0 +1,166 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file AuditLogTest.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Round trip of the audit log, the records written by the plugin are read back like the offline reader does
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "AuditLog.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <filesystem>
+#include <vector>
+
+
+/* ===================================== [definition of local functions] ====================================== */
+
+/**
+* \brief Reads all records of the segments of a directory
+*
+* \param[in] Directory directory of the audit log
+* \return std::vector<AuditLog::AuditRecord_t> the records in the order of the segments
+*/
+static std::vector<AuditLog::AuditRecord_t> ReadAllRecords(const std::filesystem::path& Directory)
+{
+    std::vector<AuditLog::AuditRecord_t> records;
+    std::vector<std::filesystem::path> segments;
+    AuditLog::AuditSegmentHeader_t header;
+    AuditLog::AuditRecord_t record;
+    int64_t firstRecordTime;
+
+    for (const auto& entry : std::filesystem::directory_iterator(Directory))
+    {
+        if (true == AuditLog::ParseSegmentName(entry.path().filename().u8string(), &firstRecordTime))
+        {
+            segments.push_back(entry.path());
+        }
+    }
+
+    std::sort(segments.begin(), segments.end());
+
+    for (const auto& segment : segments)
+    {
+        std::FILE* file = std::fopen(segment.u8string().c_str(), "rb");
+
+        EXPECT_NE(nullptr, file);
+        EXPECT_EQ(1u, std::fread(&header, sizeof(header), 1, file));
+        EXPECT_EQ(AUDIT_SEGMENT_MAGIC, header.magic);
+        EXPECT_EQ((uint32_t)AUDIT_SEGMENT_VERSION, header.version);
+        EXPECT_EQ(sizeof(AuditLog::AuditRecord_t), header.recordSize);
+
+        for (long long index = 0; true == AuditLog::ReadRecord(file, index, &record); index++)
+        {
+            records.push_back(record);
+        }
+
+        std::fclose(file);
+    }
+
+    return records;
+}
+
+
+/* ============================================== [tests] ===================================================== */
+
+TEST(AuditLog, RecordsAreReadBack)
+{
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "TribeSlotCooldownAuditLogTest";
+    const int numOfRecords = 100;
+
+    std::filesystem::remove_all(directory);
+
+    /* 1 KB segments hold 32 records, records of the same millisecond continue a segment */
+    AuditLog::InitAuditLog(true, directory.u8string(), 1, 0);
+
+    for (int i = 0; i < numOfRecords; i++)
+    {
+        AuditLog::Record(AuditLog::AuditJoin, AuditLog::AuditRejected, 76561198000000000ULL + i, i, -i, i % 70, i % 7);
+    }
+
+    AuditLog::RemoveAuditLog();
+
+    std::vector<AuditLog::AuditRecord_t> records = ReadAllRecords(directory);
+
+    ASSERT_EQ((size_t)numOfRecords, records.size());
+
+    for (int i = 0; i < numOfRecords; i++)
+    {
+        EXPECT_EQ(76561198000000000ULL + i, records[i].steamId);
+        EXPECT_EQ(i, records[i].tribeId);
+        EXPECT_EQ(-i, records[i].otherTribeId);
+        EXPECT_EQ((uint8_t)AuditLog::AuditJoin, records[i].type);
+        EXPECT_EQ((uint8_t)AuditLog::AuditRejected, records[i].decision);
+        EXPECT_EQ(i % 70, records[i].playersInTribe);
+        EXPECT_EQ(i % 7, records[i].slotsOnCooldown);
+
+        if (0 < i)
+        {
+            EXPECT_LE(records[i - 1].time, records[i].time);
+        }
+    }
+
+    std::filesystem::remove_all(directory);
+}
+
+
+TEST(AuditLog, FirstRecordIsFoundByTime)
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / AuditLog::GetSegmentName(1000);
+    const AuditLog::AuditSegmentHeader_t header = { AUDIT_SEGMENT_MAGIC, AUDIT_SEGMENT_VERSION, sizeof(AuditLog::AuditRecord_t) };
+    AuditLog::AuditRecord_t record = {};
+    std::FILE* file = std::fopen(path.u8string().c_str(), "wb");
+
+    ASSERT_NE(nullptr, file);
+    std::fwrite(&header, sizeof(header), 1, file);
+
+    /* times 1000, 1000, 1010, 1010, ... */
+    for (int i = 0; i < 64; i++)
+    {
+        record.time = 1000 + ((i / 2) * 10);
+        record.tribeId = i;
+        std::fwrite(&record, sizeof(record), 1, file);
+    }
+
+    std::fclose(file);
+    file = std::fopen(path.u8string().c_str(), "rb");
+    ASSERT_NE(nullptr, file);
+
+    EXPECT_EQ(0, AuditLog::FindFirstRecord(file, 64, 0));
+    EXPECT_EQ(0, AuditLog::FindFirstRecord(file, 64, 1000));
+    EXPECT_EQ(2, AuditLog::FindFirstRecord(file, 64, 1001));
+    EXPECT_EQ(20, AuditLog::FindFirstRecord(file, 64, 1100));
+    EXPECT_EQ(64, AuditLog::FindFirstRecord(file, 64, 2000));
+
+    ASSERT_TRUE(AuditLog::ReadRecord(file, 63, &record));
+    EXPECT_EQ(63, record.tribeId);
+    EXPECT_FALSE(AuditLog::ReadRecord(file, 64, &record));
+
+    std::fclose(file);
+    std::filesystem::remove(path);
+}
+
+/* =================================================[end of file]================================================= */
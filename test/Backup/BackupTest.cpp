@@ -0,0 +1,247 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file BackupTest.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 19 October 2026
+* \brief Tests of the online backup of the database
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "Backup.h"
+#include "DBHandler.h"
+#include "API/ARK/Ark.h"
+#include <gtest/gtest.h>
+#include <sqlite3.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+/* ========================================== [local defines] =============================================== */
+
+/** \brief number of tribes in the database */
+#define TEST_NUM_OF_TRIBES 2000
+
+/** \brief time the test waits for a backup */
+#define BACKUP_TIMEOUT std::chrono::seconds(10)
+
+
+/* ============================================ [type definitions] ============================================ */
+
+/**
+* \brief Fixture with a filled database and an empty backup directory
+*/
+class BackupTest : public ::testing::Test
+{
+protected:
+    std::filesystem::path directory;
+    std::filesystem::path backupDirectory;
+    std::string path;
+
+    void SetUp() override
+    {
+        directory = std::filesystem::temp_directory_path() / "BackupTest";
+        backupDirectory = directory / "Backups";
+        path = (directory / "Slots.db").string();
+
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+
+        DBHandler database(path);
+
+        database.BeginTransaction();
+        for (int tribeId = 1; tribeId <= TEST_NUM_OF_TRIBES; tribeId++)
+        {
+            database.AddTribe(tribeId);
+            database.UpdateSlotTimer(tribeId, { 2000000000, 2000000001 });
+        }
+        database.CommitTransaction();
+    }
+
+    void TearDown() override
+    {
+        Backup::RemoveBackup();
+
+        std::error_code error;
+        std::filesystem::remove_all(directory, error);
+    }
+
+    std::vector<std::string> GetBackups()
+    {
+        std::vector<std::string> backups;
+        std::error_code error;
+
+        for (const auto& entry : std::filesystem::directory_iterator(backupDirectory, error))
+        {
+            backups.push_back(entry.path().filename().string());
+        }
+
+        std::sort(backups.begin(), backups.end());
+
+        return backups;
+    }
+
+    std::string WaitForNewBackup(const std::set<std::string>& Known)
+    {
+        const auto timeout = std::chrono::steady_clock::now() + BACKUP_TIMEOUT;
+
+        while (std::chrono::steady_clock::now() < timeout)
+        {
+            for (const std::string& backup : GetBackups())
+            {
+                if ((0 == Known.count(backup)) && (std::string::npos == backup.find(".tmp")))
+                {
+                    return backup;
+                }
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        return std::string();
+    }
+};
+
+
+/* ===================================== [definition of local functions] ====================================== */
+
+/**
+* \brief Checks a backup
+*
+* \param[in] File the backup
+* \param[out] NumOfTribes number of tribes in the backup
+* \return bool true if the backup passes the integrity check
+*/
+static bool CheckBackup(const std::filesystem::path& File, int* NumOfTribes)
+{
+    sqlite3* database = nullptr;
+    sqlite3_stmt* statement = nullptr;
+    bool result = false;
+
+    if (SQLITE_OK == sqlite3_open_v2(File.string().c_str(), &database, SQLITE_OPEN_READONLY, nullptr))
+    {
+        if (SQLITE_OK == sqlite3_prepare_v2(database, "PRAGMA integrity_check;", -1, &statement, nullptr))
+        {
+            result = (SQLITE_ROW == sqlite3_step(statement)) && 
+                (std::string("ok") == reinterpret_cast<const char*>(sqlite3_column_text(statement, 0)));
+            sqlite3_finalize(statement);
+        }
+
+        if (SQLITE_OK == sqlite3_prepare_v2(database, "SELECT count(*) FROM TribeSlots;", -1, &statement, nullptr))
+        {
+            *NumOfTribes = (SQLITE_ROW == sqlite3_step(statement)) ? sqlite3_column_int(statement, 0) : 0;
+            sqlite3_finalize(statement);
+        }
+    }
+
+    sqlite3_close(database);
+
+    return result;
+}
+
+
+/* ============================================== [tests] ===================================================== */
+
+TEST_F(BackupTest, BackupIsConsistentWhileWriterIsActive)
+{
+    std::atomic<bool> stopWriter(false);
+    std::atomic<int> numOfWrites(0);
+    int numOfTribes = 0;
+
+    /* the game thread keeps writing through its own connection */
+    std::thread writer([&]
+    {
+        DBHandler database(path);
+        int tribeId = TEST_NUM_OF_TRIBES;
+
+        while (false == stopWriter)
+        {
+            tribeId++;
+            database.AddTribe(tribeId);
+            database.UpdateSlotTimer(tribeId, { 2000000000 });
+            numOfWrites++;
+        }
+    });
+
+    /* one page per step, the writer commits between the steps */
+    Backup::InitBackup(path, backupDirectory.string(), 0, 0, 1);
+    ASSERT_TRUE(Backup::RequestBackup());
+
+    std::string backup = WaitForNewBackup({});
+
+    stopWriter = true;
+    writer.join();
+
+    ASSERT_FALSE(backup.empty());
+    EXPECT_LT(0, numOfWrites.load());
+    EXPECT_TRUE(CheckBackup(backupDirectory / backup, &numOfTribes));
+    EXPECT_LE(TEST_NUM_OF_TRIBES, numOfTribes);
+    EXPECT_GE(TEST_NUM_OF_TRIBES + numOfWrites.load(), numOfTribes);
+}
+
+
+TEST_F(BackupTest, OnlyTheNewestBackupsAreKept)
+{
+    std::vector<std::string> written;
+    std::set<std::string> known;
+    int numOfTribes = 0;
+
+    Backup::InitBackup(path, backupDirectory.string(), 0, 3, 1000);
+
+    /* the backups are written within the same second */
+    for (int i = 0; i < 5; i++)
+    {
+        while (false == Backup::RequestBackup())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        std::string backup = WaitForNewBackup(known);
+
+        ASSERT_FALSE(backup.empty());
+        written.push_back(backup);
+        known.insert(backup);
+    }
+
+    Backup::RemoveBackup();
+
+    std::sort(written.begin(), written.end());
+
+    EXPECT_EQ(std::vector<std::string>(written.end() - 3, written.end()), GetBackups());
+
+    for (const std::string& backup : GetBackups())
+    {
+        EXPECT_TRUE(CheckBackup(backupDirectory / backup, &numOfTribes));
+        EXPECT_EQ(TEST_NUM_OF_TRIBES, numOfTribes);
+    }
+}
+
+
+/* =================================================[end of file]================================================= */
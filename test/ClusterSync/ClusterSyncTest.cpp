@@ -0,0 +1,268 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file ClusterSyncTest.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 19 October 2026
+* \brief Tests of the synchronisation of server processes sharing one database
+*
+* The other server process is a forked child. It is stepped through its transaction with a pipe, so the test
+* polls the data version before and after the commit.
+*
+*/
+
+#ifndef _WIN32
+
+/* =================================================[includes]================================================= */
+
+#include "ClusterSync.h"
+#include "DBHandler.h"
+#include "OutputCache.h"
+#include "SlotCooldown.h"
+#include "Statistics.h"
+#include "API/ARK/Ark.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+
+/* ========================================== [local defines] =============================================== */
+
+/** \brief unix time the cached outputs are rendered for */
+#define OUTPUT_TIME 1000
+
+
+/* ============================================ [type definitions] ============================================ */
+
+/**
+* \brief Fixture with the database shared by this process and an other one
+*/
+class ClusterSyncTest : public ::testing::Test
+{
+protected:
+    std::string path;
+
+    void SetUp() override
+    {
+        path = (std::filesystem::temp_directory_path() / "ClusterSyncTest.db").string();
+        RemoveDatabase();
+
+        SlotCooldown::database = std::make_unique<DBHandler>(path);
+        SlotCooldown::database->AddTribe(42);
+        OutputCache::InvalidateAll();
+    }
+
+    void TearDown() override
+    {
+        ClusterSync::RemoveClusterSync();
+        SlotCooldown::database.reset();
+        OutputCache::InvalidateAll();
+        RemoveDatabase();
+    }
+
+    void RemoveDatabase()
+    {
+        std::error_code error;
+
+        std::filesystem::remove(path, error);
+        std::filesystem::remove(path + "-wal", error);
+        std::filesystem::remove(path + "-shm", error);
+    }
+};
+
+
+/* ===================================== [definition of local functions] ====================================== */
+
+/**
+* \brief Waits for a step of the other process
+*
+* \param[in] Pipe the pipe of the steps
+* \return bool true if the step was received
+*/
+static bool WaitForStep(int Pipe)
+{
+    char step = 0;
+
+    return (1 == read(Pipe, &step, 1));
+}
+
+
+/**
+* \brief Signals a step to the other process
+*
+* \param[in] Pipe the pipe of the steps
+* \return bool true if the step was sent
+*/
+static bool SignalStep(int Pipe)
+{
+    const char step = 1;
+
+    return (1 == write(Pipe, &step, 1));
+}
+
+
+/**
+* \brief Writes the database like an other server process of the cluster
+*
+* The process writes within a transaction, signals the test, commits after the test signalled back and 
+* signals the commit.
+*
+* \param[in] Path path of the database
+* \param[in] ToTest pipe to the test
+* \param[in] FromTest pipe from the test
+* \return int 0 if the change was committed
+*/
+static int RunOtherProcess(const std::string& Path, int ToTest, int FromTest)
+{
+    bool isCommitted = false;
+    DBHandler database(Path);
+
+    if (true == database.BeginTransaction())
+    {
+        database.UpdateSlotTimer(42, { 2000000000 });
+
+        isCommitted = (true == SignalStep(ToTest)) && (true == WaitForStep(FromTest)) && (true == database.CommitTransaction());
+    }
+
+    return ((true == isCommitted) && (true == SignalStep(ToTest))) ? 0 : 1;
+}
+
+
+/**
+* \brief Checks if the output of a tribe is still cached
+*
+* \param[in] TribeId the tribe
+* \return bool true if the output is cached
+*/
+static bool IsOutputCached(int TribeId)
+{
+    FString output;
+
+    return OutputCache::GetCachedOutput(TribeId, OUTPUT_TIME, &output);
+}
+
+
+/* ============================================== [tests] ===================================================== */
+
+TEST_F(ClusterSyncTest, OwnCommitsKeepTheCaches)
+{
+    uint64_t changes = Statistics::Get(Statistics::ExternalDatabaseChange);
+
+    ClusterSync::InitClusterSync(1);
+    OutputCache::StoreOutput(42, OUTPUT_TIME, FString("42"));
+
+    SlotCooldown::database->UpdateSlotTimer(42, { 2000000000 });
+    ArkApiMock::Timer();
+
+    EXPECT_TRUE(IsOutputCached(42));
+    EXPECT_EQ(changes, Statistics::Get(Statistics::ExternalDatabaseChange));
+}
+
+
+TEST_F(ClusterSyncTest, CachesAreDroppedOnlyAfterTheOtherProcessCommits)
+{
+    uint64_t changes = Statistics::Get(Statistics::ExternalDatabaseChange);
+    int toTest[2];
+    int fromTest[2];
+    int status = 0;
+    pid_t process;
+
+    ClusterSync::InitClusterSync(1);
+    OutputCache::StoreOutput(42, OUTPUT_TIME, FString("42"));
+
+    ASSERT_EQ(0, pipe(toTest));
+    ASSERT_EQ(0, pipe(fromTest));
+
+    process = fork();
+    if (0 == process)
+    {
+        _exit(RunOtherProcess(path, toTest[1], fromTest[0]));
+    }
+    ASSERT_LT(0, process);
+
+    /* the change of the other process is not committed yet */
+    ASSERT_TRUE(WaitForStep(toTest[0]));
+    ArkApiMock::Timer();
+
+    EXPECT_TRUE(IsOutputCached(42));
+    EXPECT_EQ(changes, Statistics::Get(Statistics::ExternalDatabaseChange));
+
+    /* the next poll after the commit drops the caches, once */
+    ASSERT_TRUE(SignalStep(fromTest[1]));
+    ASSERT_TRUE(WaitForStep(toTest[0]));
+    ArkApiMock::Timer();
+
+    EXPECT_FALSE(IsOutputCached(42));
+    EXPECT_EQ(changes + 1, Statistics::Get(Statistics::ExternalDatabaseChange));
+    EXPECT_EQ(std::vector<int64_t>({ 2000000000 }), SlotCooldown::database->GetTribeSlotsTimer(42));
+
+    OutputCache::StoreOutput(42, OUTPUT_TIME, FString("42"));
+    ArkApiMock::Timer();
+
+    EXPECT_TRUE(IsOutputCached(42));
+    EXPECT_EQ(changes + 1, Statistics::Get(Statistics::ExternalDatabaseChange));
+
+    ASSERT_EQ(process, waitpid(process, &status, 0));
+    EXPECT_EQ(0, WEXITSTATUS(status));
+
+    close(toTest[0]);
+    close(toTest[1]);
+    close(fromTest[0]);
+    close(fromTest[1]);
+}
+
+
+TEST_F(ClusterSyncTest, DataVersionIsPolledInTheConfiguredInterval)
+{
+    uint64_t changes = Statistics::Get(Statistics::ExternalDatabaseChange);
+    int status = 0;
+    pid_t process;
+
+    ClusterSync::InitClusterSync(2);
+    OutputCache::StoreOutput(42, OUTPUT_TIME, FString("42"));
+
+    process = fork();
+    if (0 == process)
+    {
+        DBHandler database(path);
+
+        _exit((true == database.UpdateSlotTimer(42, { 2000000000 })) ? 0 : 1);
+    }
+    ASSERT_LT(0, process);
+    ASSERT_EQ(process, waitpid(process, &status, 0));
+    ASSERT_EQ(0, WEXITSTATUS(status));
+
+    ArkApiMock::Timer();
+
+    EXPECT_TRUE(IsOutputCached(42));
+
+    ArkApiMock::Timer();
+
+    EXPECT_FALSE(IsOutputCached(42));
+    EXPECT_EQ(changes + 1, Statistics::Get(Statistics::ExternalDatabaseChange));
+}
+
+#endif /* _WIN32 */
+
+/* =================================================[end of file]================================================= */
@@ -0,0 +1,390 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file CommandParserTest.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Tests and benchmark of the command parser
+*
+* The fuzz tests feed random commands with a fixed seed to the parser and compare the results with a simple 
+* reference implementation. The benchmark compares the parser with the ParseIntoArray and SaveStoull path it 
+* replaced.
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "CommandParser.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+/* ========================================== [local defines] =============================================== */
+
+/** \brief number of random commands of a fuzz test */
+#define NUM_OF_FUZZ_COMMANDS 200000
+
+/** \brief number of commands of the benchmark */
+#define BENCHMARK_NUM_OF_COMMANDS 1000000
+
+/** \brief steam id of the first player of the benchmark */
+#define BENCHMARK_FIRST_STEAM_ID 76561198000000000ULL
+
+
+/* ===================================== [definition of local functions] ====================================== */
+
+/**
+* \brief Splits a command into its tokens, reference of the tokenizer
+*
+* \param[in] Command the command
+* \return std::vector<std::wstring> the tokens
+*/
+static std::vector<std::wstring> SplitCommand(const std::wstring& Command)
+{
+    std::vector<std::wstring> tokens;
+    std::wstring token;
+
+    for (wchar_t character : Command)
+    {
+        if ((L' ' == character) || (L'\t' == character) || (L'\r' == character) || (L'\n' == character))
+        {
+            if (false == token.empty())
+            {
+                tokens.push_back(token);
+                token.clear();
+            }
+        }
+        else
+        {
+            token += character;
+        }
+    }
+
+    if (false == token.empty())
+    {
+        tokens.push_back(token);
+    }
+
+    return tokens;
+}
+
+
+/**
+* \brief Parses an unsigned 64 bit number, reference of ParseUInt64
+*
+* \param[in] Text the text to parse
+* \param[out] Value the parsed number
+* \return CommandParser::ParseResult_t result
+*/
+static CommandParser::ParseResult_t ReferenceParseUInt64(const std::wstring& Text, uint64_t* Value)
+{
+    const std::wstring maxValue = L"18446744073709551615";
+    std::wstring digits;
+
+    if ((true == Text.empty()) || (std::wstring::npos != Text.find_first_not_of(L"0123456789")))
+    {
+        return CommandParser::ParseInvalidArgument;
+    }
+
+    digits = Text.substr((std::min)(Text.find_first_not_of(L'0'), Text.size() - 1));
+
+    if ((digits.size() > maxValue.size()) || ((digits.size() == maxValue.size()) && (digits > maxValue)))
+    {
+        return CommandParser::ParseOutOfRange;
+    }
+
+    *Value = std::stoull(digits);
+
+    return CommandParser::ParseOk;
+}
+
+
+/**
+* \brief Creates a random command
+*
+* \param[in] Random the random generator
+* \return std::wstring the command
+*/
+static std::wstring CreateRandomCommand(std::mt19937& Random)
+{
+    static const wchar_t alphabet[] = L"0000011111234567899  \t\r\n-+x/ä€";
+    std::wstring command;
+    size_t length = Random() % 48;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        switch (Random() % 16)
+        {
+        case 0:
+            /* any character except the terminating null */
+            command += (wchar_t)(1 + (Random() % 0xFFFE));
+            break;
+        case 1:
+            /* numbers around the limits */
+            command += std::to_wstring((Random() % 2) ? UINT64_MAX - (Random() % 3) : (uint64_t)INT_MAX + (Random() % 3) - 1);
+            break;
+        default:
+            command += alphabet[Random() % (sizeof(alphabet) / sizeof(alphabet[0]) - 1)];
+            break;
+        }
+    }
+
+    return command;
+}
+
+
+/**
+* \brief Splits a command at spaces into new strings, like FString::ParseIntoArray of the old handlers
+*
+* \param[in] Command the command
+* \param[out] Parsed the words of the command
+* \return void
+*/
+static void LegacyParseIntoArray(const std::wstring& Command, std::vector<std::wstring>* Parsed)
+{
+    size_t start = 0;
+
+    Parsed->clear();
+
+    while (start <= Command.size())
+    {
+        size_t end = Command.find(L' ', start);
+
+        if (std::wstring::npos == end)
+        {
+            end = Command.size();
+        }
+
+        if (end > start)
+        {
+            Parsed->push_back(Command.substr(start, end - start));
+        }
+
+        start = end + 1;
+    }
+}
+
+
+/**
+* \brief Converts a word into a number, like SaveStoull of the old handlers
+*
+* The string is copied and the exceptions are thrown like in the old handlers, the result is not narrowed to 
+* int to compare it with the parser.
+*
+* \param[in] InString the word
+* \param[out] OutNumber the number
+* \return bool true if the word is a number
+*/
+static bool LegacySaveStoull(std::wstring InString, uint64_t* OutNumber)
+{
+    bool result = false;
+
+    try
+    {
+        *OutNumber = std::stoull(InString);
+        result = true;
+    }
+    catch (const std::invalid_argument&)
+    {
+        result = false;
+    }
+    catch (const std::out_of_range&)
+    {
+        result = false;
+    }
+
+    return result;
+}
+
+
+/* ============================================== [tests] ===================================================== */
+
+TEST(CommandParser, TokensAreSplitAtWhitespace)
+{
+    std::wstring_view token;
+
+    EXPECT_TRUE(CommandParser::GetToken(L"  /cmd\t12 \r\n 34  ", 0, &token));
+    EXPECT_EQ(L"/cmd", token);
+    EXPECT_TRUE(CommandParser::GetToken(L"  /cmd\t12 \r\n 34  ", 2, &token));
+    EXPECT_EQ(L"34", token);
+    EXPECT_FALSE(CommandParser::GetToken(L"  /cmd\t12 \r\n 34  ", 3, &token));
+    EXPECT_FALSE(CommandParser::GetToken(L"", 0, &token));
+    EXPECT_FALSE(CommandParser::GetToken(nullptr, 0, &token));
+}
+
+
+TEST(CommandParser, NumbersAreCheckedForRange)
+{
+    uint64_t value = 7;
+    int intValue = 7;
+
+    EXPECT_EQ(CommandParser::ParseOk, CommandParser::ParseUInt64(L"18446744073709551615", &value));
+    EXPECT_EQ(UINT64_MAX, value);
+    EXPECT_EQ(CommandParser::ParseOutOfRange, CommandParser::ParseUInt64(L"18446744073709551616", &value));
+    EXPECT_EQ(CommandParser::ParseInvalidArgument, CommandParser::ParseUInt64(L"99999999999999999999x", &value));
+    EXPECT_EQ(CommandParser::ParseInvalidArgument, CommandParser::ParseUInt64(L"-1", &value));
+    EXPECT_EQ(CommandParser::ParseInvalidArgument, CommandParser::ParseUInt64(L"", &value));
+    EXPECT_EQ(UINT64_MAX, value);
+
+    EXPECT_EQ(CommandParser::ParseOk, CommandParser::ParseInt(L"2147483647", &intValue));
+    EXPECT_EQ(INT_MAX, intValue);
+    EXPECT_EQ(CommandParser::ParseOutOfRange, CommandParser::ParseInt(L"2147483648", &intValue));
+    EXPECT_EQ(INT_MAX, intValue);
+
+    EXPECT_EQ(CommandParser::ParseMissingArgument, CommandParser::ParseIntArgument(L"/cmd", 1, &intValue));
+    EXPECT_EQ(CommandParser::ParseOk, CommandParser::ParseIntArgument(L"/cmd 0042", 1, &intValue));
+    EXPECT_EQ(42, intValue);
+}
+
+
+TEST(CommandParser, FuzzTokenizer)
+{
+    std::mt19937 random(0x54534321);
+
+    for (int i = 0; i < NUM_OF_FUZZ_COMMANDS; i++)
+    {
+        const std::wstring command = CreateRandomCommand(random);
+        const std::vector<std::wstring> expectedTokens = SplitCommand(command);
+        CommandParser::Tokenizer_t tokenizer;
+        std::wstring_view token;
+        size_t numOfTokens = 0;
+
+        CommandParser::InitTokenizer(&tokenizer, command.c_str());
+
+        while (true == CommandParser::NextToken(&tokenizer, &token))
+        {
+            ASSERT_LT(numOfTokens, expectedTokens.size());
+            ASSERT_EQ(expectedTokens[numOfTokens], token);
+            ASSERT_GE(token.data(), command.c_str());
+            ASSERT_LE(token.data() + token.size(), command.c_str() + command.size());
+            numOfTokens++;
+        }
+
+        ASSERT_EQ(expectedTokens.size(), numOfTokens);
+        ASSERT_FALSE(CommandParser::NextToken(&tokenizer, &token));
+    }
+}
+
+
+TEST(CommandParser, FuzzArguments)
+{
+    std::mt19937 random(0x4E554D53);
+
+    for (int i = 0; i < NUM_OF_FUZZ_COMMANDS; i++)
+    {
+        const std::wstring command = CreateRandomCommand(random);
+        const std::vector<std::wstring> tokens = SplitCommand(command);
+        const int index = (int)(random() % 4);
+
+        uint64_t value = 0;
+        uint64_t expectedValue = 0;
+        CommandParser::ParseResult_t expectedResult = CommandParser::ParseMissingArgument;
+
+        if ((size_t)index < tokens.size())
+        {
+            expectedResult = ReferenceParseUInt64(tokens[index], &expectedValue);
+        }
+
+        ASSERT_EQ(expectedResult, CommandParser::ParseUInt64Argument(command.c_str(), index, &value));
+
+        if (CommandParser::ParseOk == expectedResult)
+        {
+            ASSERT_EQ(expectedValue, value);
+        }
+
+        int intValue = -1;
+        CommandParser::ParseResult_t intResult = CommandParser::ParseIntArgument(command.c_str(), index, &intValue);
+
+        if ((CommandParser::ParseOk == expectedResult) && (expectedValue > (uint64_t)INT_MAX))
+        {
+            ASSERT_EQ(CommandParser::ParseOutOfRange, intResult);
+        }
+        else
+        {
+            ASSERT_EQ(expectedResult, intResult);
+        }
+
+        ASSERT_EQ((CommandParser::ParseOk == intResult) ? (int)expectedValue : -1, intValue);
+        ASSERT_NE(nullptr, CommandParser::GetParseErrorMessage(intResult));
+    }
+}
+
+TEST(CommandParser, BenchmarkAgainstParseIntoArray)
+{
+    std::vector<std::wstring> commands;
+    std::vector<std::wstring> parsed;
+    uint64_t legacySum = 0;
+    uint64_t parserSum = 0;
+    uint64_t value = 0;
+
+    /* the RCON commands of the tools, every tenth one has an invalid steam id that makes std::stoull throw */
+    for (uint64_t i = 0; i < BENCHMARK_NUM_OF_COMMANDS; i++)
+    {
+        if (0 == (i % 10))
+        {
+            commands.push_back(L"ListPlayerTribeCooldownSlots x" + std::to_wstring(BENCHMARK_FIRST_STEAM_ID + i));
+        }
+        else
+        {
+            commands.push_back(L"ListPlayerTribeCooldownSlots " + std::to_wstring(BENCHMARK_FIRST_STEAM_ID + i));
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (const std::wstring& command : commands)
+    {
+        LegacyParseIntoArray(command, &parsed);
+
+        if ((parsed.size() > 1) && (true == LegacySaveStoull(parsed[1], &value)))
+        {
+            legacySum += value;
+        }
+    }
+    double legacySeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (const std::wstring& command : commands)
+    {
+        if (CommandParser::ParseOk == CommandParser::ParseUInt64Argument(command.c_str(), 1, &value))
+        {
+            parserSum += value;
+        }
+    }
+    double parserSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("ParseIntoArray + SaveStoull: %.1f M commands/s\n", BENCHMARK_NUM_OF_COMMANDS / legacySeconds / 1e6);
+    std::printf("CommandParser:               %.1f M commands/s\n", BENCHMARK_NUM_OF_COMMANDS / parserSeconds / 1e6);
+
+    RecordProperty("LegacyCommandsPerSecond", (int)(BENCHMARK_NUM_OF_COMMANDS / legacySeconds));
+    RecordProperty("ParserCommandsPerSecond", (int)(BENCHMARK_NUM_OF_COMMANDS / parserSeconds));
+
+    /* both found the same steam ids */
+    EXPECT_EQ(legacySum, parserSum);
+}
+
+/* =================================================[end of file]================================================= */
@@ -0,0 +1,853 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file DBHandlerTest.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 19 October 2026
+* \brief Tests of the database interface
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "DBHandler.h"
+#include "Clock.h"
+#include "Shutdown.h"
+#include "Statistics.h"
+#include "API/ARK/Ark.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <thread>
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+
+/* ========================================== [local defines] =============================================== */
+
+/** \brief number of server processes writing the same database */
+#define NUM_OF_WRITER_PROCESSES 4
+
+/** \brief number of transactions of every writer process */
+#define NUM_OF_WRITES_PER_PROCESS 100
+
+/** \brief busy retries of the writer processes, the default of the config */
+#define WRITER_BUSY_RETRIES 8
+
+/** \brief busy backoff of the writer processes in milliseconds, the default of the config */
+#define WRITER_BUSY_BACKOFF_MS 1
+
+/** \brief tribe every writer process adds a slot to */
+#define SHARED_TRIBE_ID 1
+
+/** \brief first slot cooldown written by the writer processes */
+#define FIRST_WRITTEN_COOLDOWN 2000000000
+
+
+/* ============================================ [type definitions] ============================================ */
+
+/**
+* \brief File of the slow disk, the file of the default vfs follows it
+*/
+typedef struct
+{
+    sqlite3_file base;          /**< \brief methods of the slow disk */
+    sqlite3_file* real;         /**< \brief file of the default vfs */
+}SlowFile_t;
+
+
+/**
+* \brief Fixture with an empty database file
+*/
+class DBHandlerTest : public ::testing::Test
+{
+protected:
+    std::string path;
+
+    void SetUp() override
+    {
+        path = (std::filesystem::temp_directory_path() / "DBHandlerTest.db").string();
+        RemoveDatabase();
+    }
+
+    void TearDown() override
+    {
+        DBHandler::SetFaultHook(nullptr);
+        Clock::SetTimeSource(nullptr, nullptr);
+        RemoveDatabase();
+    }
+
+    void RemoveDatabase()
+    {
+        std::error_code error;
+
+        std::filesystem::remove(path, error);
+        std::filesystem::remove(path + "-wal", error);
+        std::filesystem::remove(path + "-shm", error);
+    }
+};
+
+
+/* =============================================== [local data] =============================================== */
+
+/** \brief the default vfs the slow disk forwards to */
+static sqlite3_vfs* RealVfs = nullptr;
+
+/** \brief vfs of the slow disk */
+static sqlite3_vfs SlowVfs;
+
+/** \brief file methods of the slow disk */
+static sqlite3_io_methods SlowIoMethods;
+
+/** \brief delay of every write and sync of the slow disk in milliseconds */
+static std::atomic<int> SlowDiskDelayMs(0);
+
+
+/* ===================================== [definition of local functions] ====================================== */
+
+/**
+* \brief Waits like a slow disk
+*
+* \return void
+*/
+static void WaitForSlowDisk(void)
+{
+    if (0 < SlowDiskDelayMs)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(SlowDiskDelayMs.load()));
+    }
+}
+
+
+/** \brief file methods of the slow disk, they forward to the default vfs */
+static sqlite3_file* Real(sqlite3_file* File) { return reinterpret_cast<SlowFile_t*>(File)->real; }
+static int SlowClose(sqlite3_file* File) { return Real(File)->pMethods->xClose(Real(File)); }
+static int SlowRead(sqlite3_file* File, void* Buffer, int Amount, sqlite3_int64 Offset) { return Real(File)->pMethods->xRead(Real(File), Buffer, Amount, Offset); }
+static int SlowWrite(sqlite3_file* File, const void* Buffer, int Amount, sqlite3_int64 Offset) { WaitForSlowDisk(); return Real(File)->pMethods->xWrite(Real(File), Buffer, Amount, Offset); }
+static int SlowTruncate(sqlite3_file* File, sqlite3_int64 Size) { return Real(File)->pMethods->xTruncate(Real(File), Size); }
+static int SlowSync(sqlite3_file* File, int Flags) { WaitForSlowDisk(); return Real(File)->pMethods->xSync(Real(File), Flags); }
+static int SlowFileSize(sqlite3_file* File, sqlite3_int64* Size) { return Real(File)->pMethods->xFileSize(Real(File), Size); }
+static int SlowLock(sqlite3_file* File, int Lock) { return Real(File)->pMethods->xLock(Real(File), Lock); }
+static int SlowUnlock(sqlite3_file* File, int Lock) { return Real(File)->pMethods->xUnlock(Real(File), Lock); }
+static int SlowCheckReservedLock(sqlite3_file* File, int* Result) { return Real(File)->pMethods->xCheckReservedLock(Real(File), Result); }
+static int SlowFileControl(sqlite3_file* File, int Op, void* Arg) { return Real(File)->pMethods->xFileControl(Real(File), Op, Arg); }
+static int SlowSectorSize(sqlite3_file* File) { return Real(File)->pMethods->xSectorSize(Real(File)); }
+static int SlowDeviceCharacteristics(sqlite3_file* File) { return Real(File)->pMethods->xDeviceCharacteristics(Real(File)); }
+static int SlowShmMap(sqlite3_file* File, int Page, int Size, int Extend, void volatile** Memory) { return Real(File)->pMethods->xShmMap(Real(File), Page, Size, Extend, Memory); }
+static int SlowShmLock(sqlite3_file* File, int Offset, int Count, int Flags) { return Real(File)->pMethods->xShmLock(Real(File), Offset, Count, Flags); }
+static void SlowShmBarrier(sqlite3_file* File) { Real(File)->pMethods->xShmBarrier(Real(File)); }
+static int SlowShmUnmap(sqlite3_file* File, int Delete) { return Real(File)->pMethods->xShmUnmap(Real(File), Delete); }
+
+
+/**
+* \brief Opens a file of the slow disk
+*
+* \param[in] Vfs the slow disk
+* \param[in] Name name of the file
+* \param[out] File the file
+* \param[in] Flags flags of the file
+* \param[out] OutFlags flags of the opened file
+* \return int result of the default vfs
+*/
+static int SlowOpen(sqlite3_vfs* Vfs, const char* Name, sqlite3_file* File, int Flags, int* OutFlags)
+{
+    SlowFile_t* file = reinterpret_cast<SlowFile_t*>(File);
+    int result;
+
+    (void)Vfs;
+
+    file->real = reinterpret_cast<sqlite3_file*>(file + 1);
+    result = RealVfs->xOpen(RealVfs, Name, file->real, Flags, OutFlags);
+    file->base.pMethods = (nullptr != file->real->pMethods) ? &SlowIoMethods : nullptr;
+
+    return result;
+}
+
+
+/**
+* \brief Registers the slow disk as default vfs
+*
+* The slow disk forwards everything to the default vfs, writes and syncs wait for SlowDiskDelayMs
+*
+* \return void
+*/
+static void RegisterSlowDisk(void)
+{
+    RealVfs = sqlite3_vfs_find(nullptr);
+
+    SlowVfs = *RealVfs;
+    SlowVfs.zName = "SlowDisk";
+    SlowVfs.szOsFile = (int)sizeof(SlowFile_t) + RealVfs->szOsFile;
+    SlowVfs.xOpen = &SlowOpen;
+    SlowVfs.pNext = nullptr;
+
+    SlowIoMethods = { 2, &SlowClose, &SlowRead, &SlowWrite, &SlowTruncate, &SlowSync, &SlowFileSize, &SlowLock, &SlowUnlock,
+        &SlowCheckReservedLock, &SlowFileControl, &SlowSectorSize, &SlowDeviceCharacteristics, &SlowShmMap, &SlowShmLock,
+        &SlowShmBarrier, &SlowShmUnmap, nullptr, nullptr };
+
+    sqlite3_vfs_register(&SlowVfs, 1);
+}
+
+
+/**
+* \brief Removes the slow disk, the previous vfs becomes the default again
+*
+* \return void
+*/
+static void UnregisterSlowDisk(void)
+{
+    SlowDiskDelayMs = 0;
+    sqlite3_vfs_unregister(&SlowVfs);
+    sqlite3_vfs_register(RealVfs, 1);
+}
+
+
+/**
+* \brief Time source of a virtual clock 1000 seconds after the 32 bit unix time overflows
+*
+* \return int64_t the unix time
+*/
+static int64_t GetTimeAfter2038(void)
+{
+    return (int64_t)INT32_MAX + 1000;
+}
+
+
+/**
+* \brief World time source of a virtual clock
+*
+* \return double the world time
+*/
+static double GetWorldTime(void)
+{
+    return 100.0;
+}
+
+
+/**
+* \brief Fault hook that fails every access like a broken disk
+*
+* \param[in] Access name of the access
+* \return int the injected fault
+*/
+static int FailEveryAccess(const char* Access)
+{
+    (void)Access;
+
+    return SQLITE_IOERR;
+}
+
+
+#ifndef _WIN32
+
+/**
+* \brief Writes the database like a server process of the cluster
+*
+* Every transaction adds a slot to the shared tribe and writes a tribe of its own. The busy retries of the 
+* process are sent to the test through the pipe.
+*
+* \param[in] Path path of the database
+* \param[in] Index index of the process
+* \param[in] Start time all processes start writing at
+* \param[in] ResultPipe pipe to the test
+* \return int number of lost writes
+*/
+static int RunWriterProcess(const std::string& Path, int Index, std::chrono::system_clock::time_point Start, int ResultPipe)
+{
+    int numOfLostWrites = 0;
+    uint64_t busyRetries = Statistics::Get(Statistics::DatabaseBusyRetry);
+
+    {
+        DBHandler database(Path, WRITER_BUSY_RETRIES, WRITER_BUSY_BACKOFF_MS);
+
+        std::this_thread::sleep_until(Start);
+
+        for (int i = 0; i < NUM_OF_WRITES_PER_PROCESS; i++)
+        {
+            const int write = (Index * NUM_OF_WRITES_PER_PROCESS) + i;
+            bool isWritten = false;
+
+            if (true == database.BeginTransaction())
+            {
+                std::vector<int64_t> slots = database.GetTribeSlotsTimer(SHARED_TRIBE_ID);
+
+                slots.push_back(FIRST_WRITTEN_COOLDOWN + write);
+                database.AddTribe(SHARED_TRIBE_ID + 1 + write);
+
+                isWritten = (true == database.UpdateSlotTimer(SHARED_TRIBE_ID, slots)) &&
+                    (true == database.UpdateSlotTimer(SHARED_TRIBE_ID + 1 + write, { FIRST_WRITTEN_COOLDOWN + write })) &&
+                    (true == database.CommitTransaction());
+            }
+
+            if (false == isWritten)
+            {
+                numOfLostWrites++;
+            }
+        }
+
+        /* a write kept in the journal is not in the database */
+        if ((true == database.IsCircuitOpen()) || (0 != database.GetJournalSize()))
+        {
+            numOfLostWrites++;
+        }
+    }
+
+    busyRetries = Statistics::Get(Statistics::DatabaseBusyRetry) - busyRetries;
+    if (sizeof(busyRetries) != write(ResultPipe, &busyRetries, sizeof(busyRetries)))
+    {
+        numOfLostWrites++;
+    }
+
+    return numOfLostWrites;
+}
+
+#endif /* _WIN32 */
+
+
+/* ============================================== [tests] ===================================================== */
+
+TEST_F(DBHandlerTest, FailedOpenIsRepairedByProbe)
+{
+    DBHandler::SetFaultHook(&FailEveryAccess);
+
+    DBHandler database(path, 1, 1, 2);
+
+    EXPECT_FALSE(database.IsCircuitOpen());
+
+    database.AddTribe(1);
+    EXPECT_TRUE(database.IsCircuitOpen());
+    EXPECT_TRUE(database.UpdateSlotTimer(1, { 100 }));
+    EXPECT_EQ(std::vector<int64_t>({ 100 }), database.GetTribeSlotsTimer(1));
+    EXPECT_FALSE(database.ProbeCircuit());
+
+    DBHandler::SetFaultHook(nullptr);
+
+    EXPECT_TRUE(database.ProbeCircuit());
+    EXPECT_EQ(0u, database.GetJournalSize());
+    EXPECT_LT(0, database.GetSchemaVersion());
+    EXPECT_EQ(std::vector<int64_t>({ 100 }), database.GetTribeSlotsTimer(1));
+}
+
+
+TEST_F(DBHandlerTest, JournalIsBounded)
+{
+    DBHandler database(path, 1, 1, 1, 2);
+
+    DBHandler::SetFaultHook(&FailEveryAccess);
+
+    EXPECT_TRUE(database.UpdateSlotTimer(1, { 100 }));
+    EXPECT_TRUE(database.IsCircuitOpen());
+    EXPECT_TRUE(database.UpdateSlotTimer(2, { 200 }));
+    EXPECT_FALSE(database.UpdateSlotTimer(3, { 300 }));
+    EXPECT_TRUE(database.UpdateSlotTimer(1, { 150 }));
+    EXPECT_EQ(2u, database.GetJournalSize());
+
+    /* a tribe without changes is not read while the circuit is open */
+    EXPECT_FALSE(database.IsTribeInDatabase(3));
+    EXPECT_TRUE(database.GetTribeSlotsTimer(3).empty());
+}
+
+
+TEST_F(DBHandlerTest, FailedReplayKeepsCircuitOpen)
+{
+    DBHandler database(path, 1, 1, 1);
+
+    DBHandler::SetFaultHook(&FailEveryAccess);
+    EXPECT_TRUE(database.UpdateSlotTimer(1, { 100 }));
+    EXPECT_TRUE(database.IsCircuitOpen());
+
+    DBHandler::SetFaultHook([](const char* Access)
+    {
+        return (std::string("ReplayJournal") == Access) ? SQLITE_FULL : SQLITE_OK;
+    });
+
+    EXPECT_FALSE(database.ProbeCircuit());
+    EXPECT_TRUE(database.IsCircuitOpen());
+    EXPECT_EQ(1u, database.GetJournalSize());
+
+    DBHandler::SetFaultHook(nullptr);
+
+    EXPECT_TRUE(database.ProbeCircuit());
+    EXPECT_EQ(0u, database.GetJournalSize());
+    EXPECT_EQ(std::vector<int64_t>({ 100 }), database.GetTribeSlotsTimer(1));
+}
+
+
+TEST_F(DBHandlerTest, ReplayKeepsStoredSlotsOfUnknownTribes)
+{
+    DBHandler database(path, 1, 1, 1);
+
+    EXPECT_TRUE(database.UpdateSlotTimer(1, { 50 }));
+    EXPECT_TRUE(database.UpdateSlotTimer(2, { 60 }));
+
+    DBHandler::SetFaultHook(&FailEveryAccess);
+    database.AddTribe(1);
+    EXPECT_TRUE(database.IsCircuitOpen());
+    database.DeleteTribe(2);
+    EXPECT_TRUE(database.UpdateSlotTimer(3, { 70 }));
+
+    /* the journal is read first, the stored slots of tribe 1 are unknown */
+    EXPECT_TRUE(database.GetTribeSlotsTimer(1).empty());
+    EXPECT_FALSE(database.IsTribeInDatabase(2));
+
+    DBHandler::SetFaultHook(nullptr);
+
+    EXPECT_TRUE(database.ProbeCircuit());
+    EXPECT_EQ(std::vector<int64_t>({ 50 }), database.GetTribeSlotsTimer(1));
+    EXPECT_FALSE(database.IsTribeInDatabase(2));
+    EXPECT_EQ(std::vector<int64_t>({ 70 }), database.GetTribeSlotsTimer(3));
+}
+
+
+TEST_F(DBHandlerTest, DeadlineOnBusyDatabaseIsNoFailure)
+{
+    DBHandler database(path, 1000, 1, 2);
+    sqlite::database other(path);
+    std::vector<int> tribeIds;
+
+    other << "BEGIN IMMEDIATE;";
+
+    for (int i = 0; i < 5; i++)
+    {
+        database.SetDeadline(std::chrono::steady_clock::now() + std::chrono::milliseconds(5));
+        EXPECT_EQ(-1, database.DeleteExpiredTribes(0, 100, &tribeIds));
+        EXPECT_TRUE(database.ClearDeadline());
+    }
+
+    EXPECT_FALSE(database.IsCircuitOpen());
+
+    other << "COMMIT;";
+
+    database.SetDeadline(std::chrono::steady_clock::now() + std::chrono::seconds(10));
+    EXPECT_EQ(0, database.DeleteExpiredTribes(0, 100, &tribeIds));
+    EXPECT_FALSE(database.ClearDeadline());
+}
+
+
+TEST_F(DBHandlerTest, BusyDatabaseWithoutDeadlineOpensCircuit)
+{
+    DBHandler database(path, 1, 1, 2);
+    sqlite::database other(path);
+
+    other << "BEGIN IMMEDIATE;";
+
+    EXPECT_FALSE(database.BeginTransaction());
+    EXPECT_FALSE(database.BeginTransaction());
+    EXPECT_TRUE(database.IsCircuitOpen());
+
+    other << "COMMIT;";
+
+    EXPECT_TRUE(database.ProbeCircuit());
+}
+
+
+TEST_F(DBHandlerTest, ReadTribeDistinguishesFailures)
+{
+    DBHandler database(path, 1000, 1, 1);
+    std::vector<int64_t> slots;
+
+    EXPECT_TRUE(database.UpdateSlotTimer(1, { 100 }));
+
+    EXPECT_EQ(ReadFound, database.ReadTribe(1, &slots));
+    EXPECT_EQ(std::vector<int64_t>({ 100 }), slots);
+    EXPECT_EQ(ReadNotFound, database.ReadTribe(2, &slots));
+    EXPECT_TRUE(slots.empty());
+
+    DBHandler::SetFaultHook(&FailEveryAccess);
+
+    EXPECT_EQ(ReadFailed, database.ReadTribe(1, &slots));
+    EXPECT_TRUE(slots.empty());
+    EXPECT_TRUE(database.IsCircuitOpen());
+
+    DBHandler::SetFaultHook(nullptr);
+
+    EXPECT_EQ(ReadFailed, database.ReadTribe(1, &slots));
+    EXPECT_TRUE(database.ProbeCircuit());
+    EXPECT_EQ(ReadFound, database.ReadTribe(1, &slots));
+}
+
+
+TEST_F(DBHandlerTest, LockedDatabaseIsNoFailureOfRead)
+{
+    DBHandler database(path, 1000, 50, 1);
+    std::vector<int64_t> slots;
+
+    EXPECT_TRUE(database.UpdateSlotTimer(1, { 100 }));
+
+    DBHandler::SetFaultHook([](const char* Access)
+    {
+        return (std::string("ReadTribe") == Access) ? SQLITE_BUSY : SQLITE_OK;
+    });
+
+    EXPECT_EQ(ReadFailed, database.ReadTribe(1, &slots));
+    EXPECT_EQ(ReadFailed, database.ReadTribe(1, &slots));
+    EXPECT_FALSE(database.IsCircuitOpen());
+
+    DBHandler::SetFaultHook(nullptr);
+
+    EXPECT_EQ(ReadFound, database.ReadTribe(1, &slots));
+}
+
+
+TEST_F(DBHandlerTest, FailedWriteInTransactionIsNotJournaled)
+{
+    DBHandler database(path, 1, 1, 5);
+
+    EXPECT_TRUE(database.UpdateSlotTimer(1, { 100 }));
+    EXPECT_TRUE(database.BeginTransaction());
+    EXPECT_TRUE(database.DeleteTribe(1));
+
+    DBHandler::SetFaultHook(&FailEveryAccess);
+
+    EXPECT_FALSE(database.UpdateSlotTimer(2, { 200 }));
+    EXPECT_FALSE(database.DeleteTribe(3));
+    EXPECT_EQ(0u, database.GetJournalSize());
+
+    DBHandler::SetFaultHook(nullptr);
+    database.RollbackTransaction();
+
+    EXPECT_EQ(std::vector<int64_t>({ 100 }), database.GetTribeSlotsTimer(1));
+}
+
+
+TEST_F(DBHandlerTest, NoTransactionWhileJournalHasChanges)
+{
+    DBHandler database(path, 1, 1, 5);
+
+    DBHandler::SetFaultHook(&FailEveryAccess);
+    EXPECT_TRUE(database.DeleteTribe(1));
+    DBHandler::SetFaultHook(nullptr);
+
+    EXPECT_FALSE(database.IsCircuitOpen());
+    EXPECT_EQ(1u, database.GetJournalSize());
+    EXPECT_FALSE(database.BeginTransaction());
+
+    EXPECT_TRUE(database.ProbeCircuit());
+    EXPECT_TRUE(database.BeginTransaction());
+    EXPECT_TRUE(database.CommitTransaction());
+}
+
+
+TEST_F(DBHandlerTest, CooldownsBeyond2038AreKept)
+{
+    DBHandler database(path, 1, 1, 5);
+    std::vector<int64_t> slots;
+    std::vector<int> tribeIds;
+    int numOfTribes = 0;
+
+    Clock::SetTimeSource(&GetTimeAfter2038, &GetWorldTime);
+
+    const int64_t expiry = Clock::Now() + 3600;
+
+    EXPECT_TRUE(database.UpdateSlotTimer(1, { expiry }));
+    EXPECT_EQ(ReadFound, database.ReadTribe(1, &slots));
+    EXPECT_EQ(std::vector<int64_t>({ expiry }), slots);
+
+    EXPECT_TRUE(database.ForEachTribeOnCooldown(Clock::Now(), true, 0, 10, [&](int TribeId, int BlockedSlots, int64_t NextExpiry)
+    {
+        EXPECT_EQ(1, TribeId);
+        EXPECT_EQ(1, BlockedSlots);
+        EXPECT_EQ(expiry, NextExpiry);
+        numOfTribes++;
+    }));
+    EXPECT_EQ(1, numOfTribes);
+    EXPECT_EQ(1, database.CountTribesOnCooldown(Clock::Now()));
+
+    EXPECT_EQ(0, database.DeleteExpiredTribes(Clock::Now(), 10, &tribeIds));
+    EXPECT_EQ(1, database.DeleteExpiredTribes(expiry, 10, &tribeIds));
+}
+
+
+TEST_F(DBHandlerTest, RowOfOlderVersionIsMigrated)
+{
+    DBHandler database(path, 1, 1, 5);
+    sqlite::database other(path);
+    std::vector<int64_t> slots;
+    std::vector<int> tribeIds;
+    int numOfLegacyRows = 0;
+
+    EXPECT_TRUE(database.UpdateSlotTimer(1, { 1800000000 }));
+
+    /* an older version only writes the 32 bit copy */
+    other << "UPDATE TribeSlots SET SlotsTimer = ? WHERE TribeId = 1;" << std::vector<int>({ 1800000100 });
+
+    EXPECT_EQ(ReadFound, database.ReadTribe(1, &slots));
+    EXPECT_EQ(std::vector<int64_t>({ 1800000100 }), slots);
+
+    /* the stale LastExpiry of the row must not get it deleted */
+    EXPECT_EQ(0, database.DeleteExpiredTribes(1800000050, 10, &tribeIds));
+
+    EXPECT_EQ(1, database.MigrateDataChunk(10));
+    EXPECT_EQ(0, database.MigrateDataChunk(10));
+
+    other << "SELECT COUNT(*) FROM TribeSlots WHERE SlotsExpiry IS NULL OR LastExpiry <> 1800000100;" >> numOfLegacyRows;
+    EXPECT_EQ(0, numOfLegacyRows);
+}
+
+
+TEST_F(DBHandlerTest, WorldTimeIsConvertedBeyond2038)
+{
+    DBHandler database(path, 1, 1, 5);
+    sqlite::database other(path);
+
+    Clock::InitClock(100000);
+    Clock::SetTimeSource(&GetTimeAfter2038, &GetWorldTime);
+
+    database.AddTribe(1);
+    other << "UPDATE TribeSlots SET SlotsTimer = ? WHERE TribeId = 1;" << std::vector<int>({ 700 });
+
+    EXPECT_EQ(1, database.MigrateDataChunk(10));
+    EXPECT_EQ(std::vector<int64_t>({ Clock::Now() + 600 }), database.GetTribeSlotsTimer(1));
+    EXPECT_LT((int64_t)INT32_MAX, database.GetTribeSlotsTimer(1)[0]);
+
+    Clock::RemoveClock();
+}
+
+
+TEST_F(DBHandlerTest, NewerSchemaIsNotWritten)
+{
+    std::vector<int64_t> slots;
+
+    {
+        DBHandler database(path, 1, 1, 5);
+        EXPECT_TRUE(database.UpdateSlotTimer(1, { 1800000000 }));
+    }
+
+    sqlite::database other(path);
+    other << "PRAGMA user_version = 1000;";
+
+    DBHandler database(path, 1, 1, 5);
+
+    EXPECT_FALSE(database.IsSchemaSupported());
+    EXPECT_FALSE(database.UpdateSlotTimer(1, { 1800000100 }));
+    EXPECT_FALSE(database.DeleteTribe(1));
+    EXPECT_FALSE(database.BeginTransaction());
+    EXPECT_EQ(0u, database.GetJournalSize());
+    EXPECT_FALSE(database.IsCircuitOpen());
+
+    EXPECT_EQ(ReadFound, database.ReadTribe(1, &slots));
+    EXPECT_EQ(std::vector<int64_t>({ 1800000000 }), slots);
+}
+
+
+TEST_F(DBHandlerTest, MigrationByOtherServerStopsWrites)
+{
+    DBHandler database(path, 1, 1, 5);
+    sqlite::database other(path);
+    int dataVersion = 0;
+
+    EXPECT_TRUE(database.GetDataVersion(&dataVersion));
+    EXPECT_TRUE(database.UpdateSlotTimer(1, { 1800000000 }));
+
+    other << "PRAGMA user_version = 1000;";
+
+    /* a transaction checks the schema with the write lock */
+    EXPECT_FALSE(database.BeginTransaction());
+    EXPECT_FALSE(database.IsSchemaSupported());
+    EXPECT_FALSE(database.UpdateSlotTimer(1, { 1800000100 }));
+    EXPECT_EQ(0u, database.GetJournalSize());
+}
+
+
+TEST_F(DBHandlerTest, DataVersionChecksSchema)
+{
+    DBHandler database(path, 1, 1, 5);
+    sqlite::database other(path);
+    int dataVersion = 0;
+
+    EXPECT_TRUE(database.GetDataVersion(&dataVersion));
+
+    other << "PRAGMA user_version = 1000;";
+
+    EXPECT_TRUE(database.GetDataVersion(&dataVersion));
+    EXPECT_FALSE(database.IsSchemaSupported());
+    EXPECT_FALSE(database.UpdateSlotTimer(1, { 1800000100 }));
+}
+
+
+TEST_F(DBHandlerTest, TribesOnCooldownArePaged)
+{
+    DBHandler database(path, 1, 1, 5);
+    sqlite::database other(path);
+    std::vector<int> tribeIds;
+    std::vector<int> blockedSlots;
+
+    /* tribe i has i slots on cooldown, the next expiry ascends with the tribe id */
+    ASSERT_TRUE(database.BeginTransaction());
+    for (int tribeId = 1; tribeId <= 20; tribeId++)
+    {
+        std::vector<int64_t> slots(tribeId, 1800000000 + tribeId);
+
+        slots.push_back(1700000000);
+        EXPECT_TRUE(database.UpdateSlotTimer(tribeId, slots));
+    }
+    EXPECT_TRUE(database.UpdateSlotTimer(21, { 1700000000 }));
+    ASSERT_TRUE(database.CommitTransaction());
+
+    /* a row changed by an older version is ranked as well */
+    other << "UPDATE TribeSlots SET SlotsTimer = ? WHERE TribeId = 21;" << std::vector<int>({ 1800000000, 1800000000 });
+
+    EXPECT_EQ(21, database.CountTribesOnCooldown(1750000000));
+
+    EXPECT_TRUE(database.ForEachTribeOnCooldown(1750000000, false, 0, 3, [&](int TribeId, int, int64_t)
+    {
+        tribeIds.push_back(TribeId);
+    }));
+    EXPECT_EQ(std::vector<int>({ 21, 1, 2 }), tribeIds);
+
+    tribeIds.clear();
+    EXPECT_TRUE(database.ForEachTribeOnCooldown(1750000000, true, 19, 5, [&](int TribeId, int BlockedSlots, int64_t)
+    {
+        tribeIds.push_back(TribeId);
+        blockedSlots.push_back(BlockedSlots);
+    }));
+    EXPECT_EQ(std::vector<int>({ 2, 1 }), tribeIds);
+    EXPECT_EQ(std::vector<int>({ 2, 1 }), blockedSlots);
+
+    EXPECT_EQ(0, database.CountTribesOnCooldown(1900000000));
+}
+
+
+TEST_F(DBHandlerTest, CheckpointOnSlowDiskEndsAtShutdownDeadline)
+{
+    RegisterSlowDisk();
+
+    {
+        DBHandler database(path, 1, 1, 5);
+
+        /* the frames stay in the WAL, the other connection does not checkpoint */
+        {
+            sqlite::database other(path);
+
+            other << "PRAGMA wal_autocheckpoint = 0;";
+            other << "BEGIN;";
+            for (int tribeId = 1; tribeId <= 5000; tribeId++)
+            {
+                other << "INSERT INTO TribeSlots (TribeId, SlotsTimer, SlotsExpiry, LastExpiry) VALUES (?, x'', ?, ?);"
+                    << tribeId << std::vector<int64_t>(6, 1800000000) << 1800000000;
+            }
+            other << "COMMIT;";
+        }
+
+        SlowDiskDelayMs = 20;
+        Shutdown::BeginShutdown(100);
+
+        auto start = std::chrono::steady_clock::now();
+
+        EXPECT_FALSE(database.Checkpoint());
+        EXPECT_GT(std::chrono::milliseconds(1000), std::chrono::steady_clock::now() - start);
+
+        Shutdown::EndShutdown();
+        SlowDiskDelayMs = 0;
+    }
+
+    /* the frames left in the WAL are not lost */
+    DBHandler database(path, 1, 1, 5);
+
+    EXPECT_TRUE(database.IsTribeInDatabase(5000));
+    EXPECT_TRUE(database.Checkpoint());
+
+    UnregisterSlowDisk();
+}
+
+
+#ifndef _WIN32
+
+TEST_F(DBHandlerTest, NoWriteOfConcurrentProcessesIsLost)
+{
+    const auto start = std::chrono::system_clock::now() + std::chrono::milliseconds(200);
+    std::vector<pid_t> processes;
+    std::vector<int64_t> expected;
+    uint64_t busyRetries = 0;
+    int resultPipe[2];
+
+    {
+        DBHandler database(path);
+
+        database.AddTribe(SHARED_TRIBE_ID);
+    }
+
+    ASSERT_EQ(0, pipe(resultPipe));
+
+    /* the processes start at the same time to contend for the write lock */
+    for (int index = 0; index < NUM_OF_WRITER_PROCESSES; index++)
+    {
+        pid_t process = fork();
+
+        if (0 == process)
+        {
+            _exit(RunWriterProcess(path, index, start, resultPipe[1]));
+        }
+
+        ASSERT_LT(0, process);
+        processes.push_back(process);
+    }
+    close(resultPipe[1]);
+
+    for (pid_t process : processes)
+    {
+        int status = 0;
+        uint64_t retries = 0;
+
+        ASSERT_EQ(process, waitpid(process, &status, 0));
+        EXPECT_TRUE(WIFEXITED(status));
+        EXPECT_EQ(0, WEXITSTATUS(status));
+
+        if (sizeof(retries) == read(resultPipe[0], &retries, sizeof(retries)))
+        {
+            busyRetries += retries;
+        }
+    }
+    close(resultPipe[0]);
+
+    printf("[ DBHandler ] %d processes with %d transactions each, busy retries: %llu\n", NUM_OF_WRITER_PROCESSES,
+        NUM_OF_WRITES_PER_PROCESS, (unsigned long long)busyRetries);
+    RecordProperty("BusyRetries", std::to_string(busyRetries));
+
+    /* the processes waited for each other */
+    EXPECT_LT(0u, busyRetries);
+
+    for (int write = 0; write < (NUM_OF_WRITER_PROCESSES * NUM_OF_WRITES_PER_PROCESS); write++)
+    {
+        expected.push_back(FIRST_WRITTEN_COOLDOWN + write);
+    }
+
+    DBHandler database(path);
+    std::vector<int64_t> slots = database.GetTribeSlotsTimer(SHARED_TRIBE_ID);
+
+    std::sort(slots.begin(), slots.end());
+    EXPECT_EQ(expected, slots);
+
+    for (int write = 0; write < (NUM_OF_WRITER_PROCESSES * NUM_OF_WRITES_PER_PROCESS); write++)
+    {
+        EXPECT_EQ(std::vector<int64_t>({ FIRST_WRITTEN_COOLDOWN + write }), database.GetTribeSlotsTimer(SHARED_TRIBE_ID + 1 + write));
+    }
+}
+
+#endif /* _WIN32 */
+
+/* =================================================[end of file]================================================= */
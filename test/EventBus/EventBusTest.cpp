@@ -0,0 +1,543 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file EventBusTest.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 19 October 2026
+* \brief Tests of the event bus and of the access to its named pipes
+*
+* The event bus is tested with an in-process transport that keeps the sent messages and hands messages of 
+* peers to the event bus like a pipe would. The named pipes are tested on Windows only.
+*
+*/
+
+/* =================================================[includes]================================================= */
+
+#include "EventBus.h"
+#include "EventFormat.h"
+#include "OutputCache.h"
+#include "Statistics.h"
+#include "API/ARK/Ark.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#ifdef _WIN32
+#include "EventPipe.h"
+#include <aclapi.h>
+#endif
+
+
+/* ========================================== [local defines] =============================================== */
+
+/** \brief id of the server under test */
+#define LOCAL_SERVER_ID 1
+
+/** \brief id of the peer the test sends as */
+#define PEER_SERVER_ID 2
+
+/** \brief time the test waits for the sender thread */
+#define SEND_TIMEOUT std::chrono::seconds(5)
+
+/** \brief unix time the cached outputs are rendered for */
+#define OUTPUT_TIME 1000
+
+
+/* ============================================ [type definitions] ============================================ */
+
+/**
+* \brief Messages sent through the in-process transport and the receiver of the event bus
+*/
+static struct
+{
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<std::vector<uint8_t>> sentMessages;
+    EventBus::ReceiveCallback_t onReceive;
+}Channel;
+
+
+/**
+* \brief Transport that keeps the messages in the test process
+*/
+class InProcessTransport : public EventBus::EventTransport
+{
+public:
+    bool Open(const std::string&, int, const std::vector<int>&, const EventBus::ReceiveCallback_t& OnReceive) override
+    {
+        std::lock_guard<std::mutex> lock(Channel.mutex);
+
+        Channel.sentMessages.clear();
+        Channel.onReceive = OnReceive;
+
+        return true;
+    }
+
+    void Send(const void* Message, size_t Size) override
+    {
+        const uint8_t* data = static_cast<const uint8_t*>(Message);
+
+        {
+            std::lock_guard<std::mutex> lock(Channel.mutex);
+            Channel.sentMessages.emplace_back(data, data + Size);
+        }
+        Channel.condition.notify_all();
+    }
+
+    void Close() override
+    {
+        std::lock_guard<std::mutex> lock(Channel.mutex);
+
+        Channel.onReceive = nullptr;
+    }
+};
+
+
+/**
+* \brief Fixture with a running event bus on the in-process transport
+*/
+class EventBusTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        EventBus::InitEventBus(true, "Test", LOCAL_SERVER_ID, { PEER_SERVER_ID }, std::make_unique<InProcessTransport>());
+        OutputCache::InvalidateAll();
+    }
+
+    void TearDown() override
+    {
+        EventBus::RemoveEventBus();
+        OutputCache::InvalidateAll();
+    }
+};
+
+
+/* ===================================== [definition of local functions] ====================================== */
+
+/**
+* \brief Gets the current time like the event bus does
+*
+* \return int64_t microseconds since epoch
+*/
+static int64_t GetTimeInMicroseconds(void)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+
+/**
+* \brief Waits until the sender thread sent the events
+*
+* \param[in] NumOfEvents number of expected events
+* \return std::vector<EventBus::Event_t> the sent events
+*/
+static std::vector<EventBus::Event_t> WaitForSentEvents(size_t NumOfEvents)
+{
+    std::vector<EventBus::Event_t> events;
+    std::unique_lock<std::mutex> lock(Channel.mutex);
+
+    Channel.condition.wait_for(lock, SEND_TIMEOUT, [&]
+    {
+        size_t size = 0;
+
+        for (const std::vector<uint8_t>& message : Channel.sentMessages)
+        {
+            size += message.size();
+        }
+
+        return (NumOfEvents * sizeof(EventBus::Event_t)) <= size;
+    });
+
+    for (const std::vector<uint8_t>& message : Channel.sentMessages)
+    {
+        for (size_t offset = 0; (offset + sizeof(EventBus::Event_t)) <= message.size(); offset += sizeof(EventBus::Event_t))
+        {
+            EventBus::Event_t event;
+
+            std::memcpy(&event, message.data() + offset, sizeof(EventBus::Event_t));
+            events.push_back(event);
+        }
+    }
+
+    return events;
+}
+
+
+/**
+* \brief Hands an event of the peer to the event bus like the transport does
+*
+* \param[in] Type kind of the change
+* \param[in] Sequence sequence number of the event
+* \param[in] TribeId id of the changed tribe
+* \param[in] PublishTime time the peer published the event in microseconds since epoch
+* \return void
+*/
+static void ReceiveEvent(EventBus::EventType_t Type, uint32_t Sequence, int TribeId, int64_t PublishTime)
+{
+    EventBus::Event_t event = {};
+
+    event.version = EVENT_VERSION;
+    event.type = (uint8_t)Type;
+    event.serverId = PEER_SERVER_ID;
+    event.sequence = Sequence;
+    event.tribeId = TribeId;
+    event.publishTime = PublishTime;
+
+    std::lock_guard<std::mutex> lock(Channel.mutex);
+    Channel.onReceive(&event, sizeof(event));
+}
+
+
+/**
+* \brief Checks if the output of a tribe is still cached
+*
+* \param[in] TribeId the tribe
+* \return bool true if the output is cached
+*/
+static bool IsOutputCached(int TribeId)
+{
+    FString output;
+
+    return OutputCache::GetCachedOutput(TribeId, OUTPUT_TIME, &output);
+}
+
+
+/* ============================================== [tests] ===================================================== */
+
+TEST_F(EventBusTest, PublishedEventsAreSentInSequence)
+{
+    uint64_t published = Statistics::Get(Statistics::EventBusPublished);
+    int64_t before = GetTimeInMicroseconds();
+
+    EventBus::Publish(EventBus::EventSlotAdded, 42);
+    EventBus::Publish(EventBus::EventTribesMerged, 43, 44);
+
+    std::vector<EventBus::Event_t> events = WaitForSentEvents(2);
+
+    ASSERT_EQ(2u, events.size());
+    EXPECT_EQ(EVENT_VERSION, events[0].version);
+    EXPECT_EQ(EventBus::EventSlotAdded, events[0].type);
+    EXPECT_EQ(LOCAL_SERVER_ID, events[0].serverId);
+    EXPECT_EQ(1u, events[0].sequence);
+    EXPECT_EQ(42, events[0].tribeId);
+    EXPECT_LE(before, events[0].publishTime);
+    EXPECT_EQ(EventBus::EventTribesMerged, events[1].type);
+    EXPECT_EQ(2u, events[1].sequence);
+    EXPECT_EQ(43, events[1].tribeId);
+    EXPECT_EQ(44, events[1].otherTribeId);
+    EXPECT_EQ(published + 2, Statistics::Get(Statistics::EventBusPublished));
+}
+
+
+TEST_F(EventBusTest, ReceivedEventIsAppliedOnTheNextTick)
+{
+    uint64_t received = Statistics::Get(Statistics::EventBusReceived);
+
+    OutputCache::StoreOutput(42, OUTPUT_TIME, FString("42"));
+    OutputCache::StoreOutput(43, OUTPUT_TIME, FString("43"));
+
+    ReceiveEvent(EventBus::EventSlotsRemoved, 1, 42, GetTimeInMicroseconds());
+
+    /* received events are applied on the game thread only */
+    EXPECT_TRUE(IsOutputCached(42));
+
+    ArkApiMock::Tick(0.0f);
+
+    EXPECT_FALSE(IsOutputCached(42));
+    EXPECT_TRUE(IsOutputCached(43));
+    EXPECT_EQ(received + 1, Statistics::Get(Statistics::EventBusReceived));
+}
+
+
+TEST_F(EventBusTest, PublishedEventReachesPeer)
+{
+    OutputCache::StoreOutput(42, OUTPUT_TIME, FString("42"));
+
+    EventBus::Publish(EventBus::EventSlotAdded, 42);
+
+    std::vector<EventBus::Event_t> events = WaitForSentEvents(1);
+
+    ASSERT_EQ(1u, events.size());
+
+    /* the peer applies what this server sent */
+    events[0].serverId = PEER_SERVER_ID;
+    {
+        std::lock_guard<std::mutex> lock(Channel.mutex);
+        Channel.onReceive(&events[0], sizeof(events[0]));
+    }
+    ArkApiMock::Tick(0.0f);
+
+    EXPECT_FALSE(IsOutputCached(42));
+}
+
+
+TEST_F(EventBusTest, OwnEventsAreIgnored)
+{
+    uint64_t received = Statistics::Get(Statistics::EventBusReceived);
+    EventBus::Event_t event = {};
+
+    OutputCache::StoreOutput(42, OUTPUT_TIME, FString("42"));
+
+    event.version = EVENT_VERSION;
+    event.type = EventBus::EventSlotAdded;
+    event.serverId = LOCAL_SERVER_ID;
+    event.sequence = 1;
+    event.tribeId = 42;
+    {
+        std::lock_guard<std::mutex> lock(Channel.mutex);
+        Channel.onReceive(&event, sizeof(event));
+    }
+    ArkApiMock::Tick(0.0f);
+
+    EXPECT_TRUE(IsOutputCached(42));
+    EXPECT_EQ(received, Statistics::Get(Statistics::EventBusReceived));
+}
+
+
+TEST_F(EventBusTest, SequenceGapDropsAllCaches)
+{
+    uint64_t resyncs = Statistics::Get(Statistics::EventBusResync);
+
+    ReceiveEvent(EventBus::EventSlotAdded, 1, 42, GetTimeInMicroseconds());
+    ReceiveEvent(EventBus::EventSlotAdded, 2, 42, GetTimeInMicroseconds());
+    ArkApiMock::Tick(0.0f);
+
+    EXPECT_EQ(resyncs, Statistics::Get(Statistics::EventBusResync));
+
+    OutputCache::StoreOutput(43, OUTPUT_TIME, FString("43"));
+
+    /* the event with sequence number 3 got lost */
+    ReceiveEvent(EventBus::EventSlotAdded, 4, 44, GetTimeInMicroseconds());
+    ArkApiMock::Tick(0.0f);
+
+    EXPECT_FALSE(IsOutputCached(43));
+    EXPECT_EQ(resyncs + 1, Statistics::Get(Statistics::EventBusResync));
+
+    /* the sequence continues from the event after the gap */
+    OutputCache::StoreOutput(43, OUTPUT_TIME, FString("43"));
+    ReceiveEvent(EventBus::EventSlotAdded, 5, 44, GetTimeInMicroseconds());
+    ArkApiMock::Tick(0.0f);
+
+    EXPECT_TRUE(IsOutputCached(43));
+    EXPECT_EQ(resyncs + 1, Statistics::Get(Statistics::EventBusResync));
+}
+
+
+TEST_F(EventBusTest, LatencyIsMeasuredFromPublishToApply)
+{
+    const int64_t delay = 50000;
+    uint64_t latencySum = Statistics::Get(Statistics::EventBusLatencySum);
+    int64_t before = GetTimeInMicroseconds();
+
+    ReceiveEvent(EventBus::EventSlotAdded, 1, 42, before - delay);
+    ArkApiMock::Tick(0.0f);
+
+    int64_t after = GetTimeInMicroseconds();
+    uint64_t latency = Statistics::Get(Statistics::EventBusLatencySum) - latencySum;
+
+    EXPECT_LE((uint64_t)delay, latency);
+    EXPECT_GE((uint64_t)(after - before + delay), latency);
+
+    printf("[ EventBus ] latency of an event applied %lld us after its publish: %llu us\n", (long long)delay, 
+        (unsigned long long)latency);
+}
+
+
+#ifdef _WIN32
+
+/** \brief size of the input buffer of the test pipes */
+#define TEST_PIPE_BUFFER_SIZE 64
+
+
+/**
+* \brief Gets a pipe name that is unique for the test process
+*
+* \return std::wstring name of the pipe
+*/
+static std::wstring GetTestPipeName(void)
+{
+    return L"\\\\.\\pipe\\TribeSlotCooldownTest." + std::to_wstring(GetCurrentProcessId());
+}
+
+
+/**
+* \brief Transfers data through a pipe and waits until it is done
+*
+* \param[in] Pipe the pipe, opened for overlapped I/O
+* \param[in] IsWrite true to write, false to read
+* \param[in,out] Buffer the data
+* \param[in] Size size of the data in bytes
+* \return bool true if the whole data was transferred
+*/
+static bool TransferAndWait(HANDLE Pipe, bool IsWrite, void* Buffer, DWORD Size)
+{
+    OVERLAPPED overlapped = { 0 };
+    DWORD transferred = 0;
+    BOOL result;
+
+    overlapped.hEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+
+    result = (true == IsWrite) ? WriteFile(Pipe, Buffer, Size, NULL, &overlapped) : ReadFile(Pipe, Buffer, Size, NULL, &overlapped);
+
+    if ((TRUE == result) || (ERROR_IO_PENDING == GetLastError()))
+    {
+        result = GetOverlappedResult(Pipe, &overlapped, &transferred, TRUE);
+    }
+
+    CloseHandle(overlapped.hEvent);
+
+    return (TRUE == result) && (Size == transferred);
+}
+
+
+TEST(EventBus, PipeGrantsAccessToTheServerAccountOnly)
+{
+    HANDLE pipe = EventPipe::CreateServerPipe(GetTestPipeName(), TEST_PIPE_BUFFER_SIZE, true);
+    HANDLE token;
+    std::vector<uint8_t> user;
+    DWORD size = 0;
+    PACL dacl = NULL;
+    PSECURITY_DESCRIPTOR descriptor = NULL;
+    ACCESS_ALLOWED_ACE* ace = NULL;
+
+    ASSERT_NE(INVALID_HANDLE_VALUE, pipe);
+
+    ASSERT_TRUE(OpenProcessToken(GetCurrentProcess(), TOKEN_QUERY, &token));
+    GetTokenInformation(token, TokenUser, NULL, 0, &size);
+    user.resize(size);
+    ASSERT_TRUE(GetTokenInformation(token, TokenUser, user.data(), size, &size));
+    CloseHandle(token);
+
+    ASSERT_EQ(ERROR_SUCCESS, GetSecurityInfo(pipe, SE_KERNEL_OBJECT, DACL_SECURITY_INFORMATION, NULL, NULL, &dacl, NULL, &descriptor));
+    ASSERT_NE(nullptr, dacl);
+    EXPECT_EQ(1, dacl->AceCount);
+    ASSERT_TRUE(GetAce(dacl, 0, reinterpret_cast<LPVOID*>(&ace)));
+    EXPECT_EQ(ACCESS_ALLOWED_ACE_TYPE, ace->Header.AceType);
+    EXPECT_TRUE(EqualSid(&ace->SidStart, reinterpret_cast<TOKEN_USER*>(user.data())->User.Sid));
+
+    LocalFree(descriptor);
+    CloseHandle(pipe);
+}
+
+
+TEST(EventBus, LocalClientOfTheServerAccountConnects)
+{
+    HANDLE pipe = EventPipe::CreateServerPipe(GetTestPipeName(), TEST_PIPE_BUFFER_SIZE, true);
+    HANDLE client;
+
+    ASSERT_NE(INVALID_HANDLE_VALUE, pipe);
+
+    client = EventPipe::OpenClientPipe(GetTestPipeName());
+
+    EXPECT_NE(INVALID_HANDLE_VALUE, client);
+
+    if (INVALID_HANDLE_VALUE != client)
+    {
+        CloseHandle(client);
+    }
+    CloseHandle(pipe);
+}
+
+
+TEST(EventBus, RemoteClientIsRejected)
+{
+    HANDLE pipe = EventPipe::CreateServerPipe(GetTestPipeName(), TEST_PIPE_BUFFER_SIZE, true);
+    HANDLE client;
+
+    ASSERT_NE(INVALID_HANDLE_VALUE, pipe);
+
+    /* a client that comes over the network redirector is remote, even on the same machine */
+    client = EventPipe::OpenClientPipe(L"\\\\localhost\\pipe\\TribeSlotCooldownTest." + std::to_wstring(GetCurrentProcessId()));
+
+    EXPECT_EQ(INVALID_HANDLE_VALUE, client);
+
+    if (INVALID_HANDLE_VALUE != client)
+    {
+        CloseHandle(client);
+    }
+    CloseHandle(pipe);
+}
+
+
+TEST(EventBus, PipeOfOtherOwnerIsNotJoined)
+{
+    HANDLE pipe = EventPipe::CreateServerPipe(GetTestPipeName(), TEST_PIPE_BUFFER_SIZE, true);
+    HANDLE other;
+
+    ASSERT_NE(INVALID_HANDLE_VALUE, pipe);
+
+    /* the name is taken, as if an other process had created the pipe before the server */
+    other = EventPipe::CreateServerPipe(GetTestPipeName(), TEST_PIPE_BUFFER_SIZE, true);
+
+    EXPECT_EQ(INVALID_HANDLE_VALUE, other);
+    EXPECT_EQ((DWORD)ERROR_ACCESS_DENIED, GetLastError());
+
+    /* further instances of the own pipe are created */
+    other = EventPipe::CreateServerPipe(GetTestPipeName(), TEST_PIPE_BUFFER_SIZE, false);
+
+    EXPECT_NE(INVALID_HANDLE_VALUE, other);
+
+    if (INVALID_HANDLE_VALUE != other)
+    {
+        CloseHandle(other);
+    }
+    CloseHandle(pipe);
+}
+
+
+TEST(EventBus, ServerCanNotImpersonateClient)
+{
+    HANDLE pipe = EventPipe::CreateServerPipe(GetTestPipeName(), TEST_PIPE_BUFFER_SIZE, true);
+    HANDLE client;
+    HANDLE token = NULL;
+    SECURITY_IMPERSONATION_LEVEL level = SecurityImpersonation;
+    DWORD size = 0;
+    uint32_t data = 1;
+
+    ASSERT_NE(INVALID_HANDLE_VALUE, pipe);
+
+    client = EventPipe::OpenClientPipe(GetTestPipeName());
+    ASSERT_NE(INVALID_HANDLE_VALUE, client);
+
+    /* the client is impersonated after the server read from the pipe */
+    ASSERT_TRUE(TransferAndWait(client, true, &data, sizeof(data)));
+    ASSERT_TRUE(TransferAndWait(pipe, false, &data, sizeof(data)));
+    ASSERT_TRUE(ImpersonateNamedPipeClient(pipe));
+
+    EXPECT_TRUE(OpenThreadToken(GetCurrentThread(), TOKEN_QUERY, TRUE, &token));
+    EXPECT_TRUE(GetTokenInformation(token, TokenImpersonationLevel, &level, sizeof(level), &size));
+    EXPECT_EQ(SecurityIdentification, level);
+
+    CloseHandle(token);
+    RevertToSelf();
+    CloseHandle(client);
+    CloseHandle(pipe);
+}
+
+#endif /* _WIN32 */
+
+/* =================================================[end of file]================================================= */
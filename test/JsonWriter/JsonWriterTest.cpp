@@ -0,0 +1,356 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file JsonWriterTest.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Tests and benchmark of the json writer, the documents are checked with the json parser used for the 
+* configuration
+*
+* The benchmark encodes the slot cooldowns of 10k tribes like the json rcon commands and compares the writer 
+* with the json library of the configuration.
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "JsonWriter.h"
+#include "json.hpp"
+#include <gtest/gtest.h>
+#include <cfloat>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+
+
+/* ========================================== [local defines] =============================================== */
+
+/** \brief number of tribes of the benchmark */
+#define BENCHMARK_NUM_OF_TRIBES 10000
+
+/** \brief number of documents encoded by the benchmark */
+#define BENCHMARK_NUM_OF_DOCUMENTS 100
+
+/** \brief maximum length of a part of the split tests */
+#define PART_LENGTH 8
+
+
+/* ============================================ [type definitions] ============================================ */
+
+/**
+*  \brief slot cooldowns of a tribe of the benchmark
+*/
+typedef struct
+{
+    int tribeId;                    /**< \brief id of the tribe */
+    std::vector<int64_t> slots;     /**< \brief expiries of the slots */
+
+}BenchmarkTribe_t;
+
+
+/* ===================================== [definition of local functions] ====================================== */
+
+/**
+* \brief Checks if a part of a document is complete utf-8
+*
+* \param[in] Part the part
+* \return bool true if every character of the part is complete
+*/
+static bool IsCompleteUtf8(const std::string& Part)
+{
+    size_t position = 0;
+
+    while (position < Part.size())
+    {
+        unsigned char lead = (unsigned char)Part[position];
+        size_t length = (lead < 0x80) ? 1 : (lead < 0xE0) ? 2 : (lead < 0xF0) ? 3 : 4;
+
+        if ((0x80 == (lead & 0xC0)) || ((position + length) > Part.size()))
+        {
+            return false;
+        }
+
+        for (size_t i = 1; i < length; i++)
+        {
+            if (0x80 != ((unsigned char)Part[position + i] & 0xC0))
+            {
+                return false;
+            }
+        }
+
+        position += length;
+    }
+
+    return true;
+}
+
+
+/**
+* \brief Encodes the tribes like the json rcon commands
+*
+* \param[in/out] Writer the json writer
+* \param[in] Tribes the tribes
+* \param[in] Now the current time
+* \return void
+*/
+static void WriteTribes(JsonWriter* Writer, const std::vector<BenchmarkTribe_t>& Tribes, int64_t Now)
+{
+    Writer->Clear();
+    Writer->BeginObject();
+    Writer->Key("tribes");
+    Writer->BeginArray();
+    for (const BenchmarkTribe_t& tribe : Tribes)
+    {
+        Writer->BeginObject();
+        Writer->Key("tribeId");
+        Writer->Int(tribe.tribeId);
+        Writer->Key("now");
+        Writer->Int(Now);
+        Writer->Key("slots");
+        Writer->BeginArray();
+        for (int64_t slot : tribe.slots)
+        {
+            Writer->Int(slot);
+        }
+        Writer->EndArray();
+        Writer->EndObject();
+    }
+    Writer->EndArray();
+    Writer->EndObject();
+}
+
+
+/* ============================================== [tests] ===================================================== */
+
+TEST(JsonWriter, DocumentIsCompact)
+{
+    JsonWriter writer;
+
+    writer.BeginObject();
+    writer.Key("tribeId");
+    writer.Int(1234);
+    writer.Key("now");
+    writer.Int(1700000000);
+    writer.Key("slots");
+    writer.BeginArray();
+    writer.Int(1700000100);
+    writer.Int(1700000200);
+    writer.EndArray();
+    writer.Key("empty");
+    writer.BeginArray();
+    writer.EndArray();
+    writer.EndObject();
+
+    EXPECT_EQ("{\"tribeId\":1234,\"now\":1700000000,\"slots\":[1700000100,1700000200],\"empty\":[]}", writer.GetBuffer());
+}
+
+
+TEST(JsonWriter, ValuesAreParsedBack)
+{
+    JsonWriter writer;
+
+    writer.BeginArray();
+    writer.Int((std::numeric_limits<int64_t>::min)());
+    writer.Int((std::numeric_limits<int64_t>::max)());
+    writer.UInt((std::numeric_limits<uint64_t>::max)());
+    writer.Double(12.5);
+    writer.Double(-0.25);
+    writer.Double(DBL_MAX);
+    writer.Double(std::numeric_limits<double>::infinity());
+    writer.Double(std::numeric_limits<double>::quiet_NaN());
+    writer.Bool(true);
+    writer.Bool(false);
+    writer.String("quote \" backslash \\ tab \t newline \n bell \x07 umlaut \xC3\xA4");
+    writer.String(nullptr);
+    writer.EndArray();
+
+    nlohmann::json document = nlohmann::json::parse(writer.GetBuffer());
+
+    ASSERT_TRUE(document.is_array());
+    ASSERT_EQ(12u, document.size());
+    EXPECT_EQ((std::numeric_limits<int64_t>::min)(), document[0].get<int64_t>());
+    EXPECT_EQ((std::numeric_limits<int64_t>::max)(), document[1].get<int64_t>());
+    EXPECT_EQ((std::numeric_limits<uint64_t>::max)(), document[2].get<uint64_t>());
+    EXPECT_DOUBLE_EQ(12.5, document[3].get<double>());
+    EXPECT_DOUBLE_EQ(-0.25, document[4].get<double>());
+    EXPECT_DOUBLE_EQ(DBL_MAX, document[5].get<double>());
+    EXPECT_TRUE(document[6].is_null());
+    EXPECT_TRUE(document[7].is_null());
+    EXPECT_TRUE(document[8].get<bool>());
+    EXPECT_FALSE(document[9].get<bool>());
+    EXPECT_EQ("quote \" backslash \\ tab \t newline \n bell \x07 umlaut \xC3\xA4", document[10].get<std::string>());
+    EXPECT_EQ("", document[11].get<std::string>());
+}
+
+
+TEST(JsonWriter, NestedDocumentsAreValid)
+{
+    JsonWriter writer;
+
+    writer.BeginObject();
+    writer.Key("tasks");
+    writer.BeginArray();
+    for (int i = 0; i < 3; i++)
+    {
+        writer.BeginObject();
+        writer.Key("name");
+        writer.String("Task");
+        writer.Key("runs");
+        writer.UInt((uint64_t)i);
+        writer.Key("nested");
+        writer.BeginObject();
+        writer.Key("array");
+        writer.BeginArray();
+        writer.BeginArray();
+        writer.EndArray();
+        writer.BeginObject();
+        writer.EndObject();
+        writer.EndArray();
+        writer.EndObject();
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.Key("count");
+    writer.Int(3);
+    writer.EndObject();
+
+    nlohmann::json document = nlohmann::json::parse(writer.GetBuffer());
+
+    ASSERT_EQ(3u, document["tasks"].size());
+    EXPECT_EQ(2u, document["tasks"][2]["runs"].get<uint64_t>());
+    EXPECT_TRUE(document["tasks"][1]["nested"]["array"][0].is_array());
+    EXPECT_TRUE(document["tasks"][1]["nested"]["array"][1].is_object());
+    EXPECT_EQ(3, document["count"].get<int>());
+}
+
+
+TEST(JsonWriter, ClearStartsANewDocument)
+{
+    JsonWriter writer;
+
+    writer.BeginObject();
+    writer.Key("a");
+    writer.Int(1);
+    writer.EndObject();
+    writer.Clear();
+    writer.BeginArray();
+    writer.EndArray();
+
+    EXPECT_EQ("[]", writer.GetBuffer());
+}
+
+TEST(JsonWriter, PartsEndAtCharacterBoundaries)
+{
+    JsonWriter writer;
+    std::string document;
+    size_t position = 0;
+    size_t length;
+
+    /* characters of two, three and four bytes at every offset of the parts */
+    writer.BeginArray();
+    writer.String("a\xC3\xA4" "bb\xE2\x82\xAC" "ccc\xF0\x9F\x98\x80" "dddd\xC3\xA4\xE2\x82\xAC\xF0\x9F\x98\x80");
+    writer.EndArray();
+
+    length = writer.GetPartLength(position, PART_LENGTH);
+    while (0 < length)
+    {
+        std::string part = writer.GetBuffer().substr(position, length);
+
+        EXPECT_LE(length, (size_t)PART_LENGTH);
+        EXPECT_TRUE(IsCompleteUtf8(part)) << "part at " << position;
+
+        document += part;
+        position += length;
+        length = writer.GetPartLength(position, PART_LENGTH);
+    }
+
+    EXPECT_EQ(writer.GetBuffer(), document);
+    EXPECT_EQ(0u, writer.GetPartLength(writer.GetBuffer().size() + 1, PART_LENGTH));
+}
+
+
+TEST(JsonWriter, InvalidUtf8IsStillSplit)
+{
+    JsonWriter writer;
+
+    /* continuation bytes without a lead byte cannot be kept together */
+    writer.String("\x80\x80\x80\x80\x80\x80\x80\x80\x80\x80");
+
+    EXPECT_EQ(4u, writer.GetPartLength(0, 4));
+    EXPECT_EQ(writer.GetBuffer().size(), writer.GetPartLength(0, 1000));
+}
+
+
+TEST(JsonWriter, BenchmarkEncodingTenThousandTribes)
+{
+    std::mt19937 random(0x4A534F4E);
+    std::vector<BenchmarkTribe_t> tribes(BENCHMARK_NUM_OF_TRIBES);
+    const int64_t now = 1700000000;
+    JsonWriter writer;
+    std::string libraryDocument;
+
+    for (BenchmarkTribe_t& tribe : tribes)
+    {
+        tribe.tribeId = (int)(random() & 0x7FFFFFFF);
+        for (size_t i = random() % 8; 0 < i; i--)
+        {
+            tribe.slots.push_back(now + (int64_t)(random() % 86400));
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCHMARK_NUM_OF_DOCUMENTS; i++)
+    {
+        WriteTribes(&writer, tribes, now);
+    }
+    double writerSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCHMARK_NUM_OF_DOCUMENTS; i++)
+    {
+        nlohmann::json document;
+        nlohmann::json& tribesArray = document["tribes"] = nlohmann::json::array();
+
+        for (const BenchmarkTribe_t& tribe : tribes)
+        {
+            tribesArray.push_back({ { "tribeId", tribe.tribeId }, { "now", now }, { "slots", tribe.slots } });
+        }
+
+        libraryDocument = document.dump();
+    }
+    double librarySeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double writerMegabytes = (double)writer.GetBuffer().size() * BENCHMARK_NUM_OF_DOCUMENTS / 1e6;
+
+    std::printf("JsonWriter:     %.2f ms per %d tribes, %.0f MB/s\n", writerSeconds * 1000.0 / BENCHMARK_NUM_OF_DOCUMENTS, BENCHMARK_NUM_OF_TRIBES, writerMegabytes / writerSeconds);
+    std::printf("nlohmann::json: %.2f ms per %d tribes, %.0f MB/s\n", librarySeconds * 1000.0 / BENCHMARK_NUM_OF_DOCUMENTS, BENCHMARK_NUM_OF_TRIBES, writerMegabytes / librarySeconds);
+
+    RecordProperty("WriterMicrosecondsPerDocument", (int)(writerSeconds * 1e6 / BENCHMARK_NUM_OF_DOCUMENTS));
+    RecordProperty("LibraryMicrosecondsPerDocument", (int)(librarySeconds * 1e6 / BENCHMARK_NUM_OF_DOCUMENTS));
+
+    /* both encoded the same document */
+    EXPECT_EQ(nlohmann::json::parse(libraryDocument), nlohmann::json::parse(writer.GetBuffer()));
+}
+
+/* =================================================[end of file]================================================= */
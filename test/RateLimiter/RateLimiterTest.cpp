@@ -0,0 +1,218 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file RateLimiterTest.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Tests and benchmark of the token buckets of the rate limiter
+*
+* The benchmark offers 10k calls per second spread over many players, most of them get rejected. It measures
+* the time spent in the limiter for the allowed and for the rejected calls.
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "RateLimiter.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+
+/* ========================================== [local defines] =============================================== */
+
+/** \brief steam id of the first test player */
+#define FIRST_STEAM_ID 76561198000000000ULL
+
+/** \brief offered calls per second of the benchmark */
+#define BENCHMARK_CALLS_PER_SECOND 10000
+
+/** \brief duration of the benchmark in seconds */
+#define BENCHMARK_SECONDS 2
+
+/** \brief number of players of the benchmark */
+#define BENCHMARK_NUM_OF_PLAYERS 1000
+
+/** \brief bucket size of the benchmark */
+#define BENCHMARK_BUCKET_SIZE 3.0f
+
+/** \brief refill rate of the benchmark */
+#define BENCHMARK_TOKENS_PER_SECOND 1.0f
+
+/** \brief number of rejected calls timed in one batch */
+#define BENCHMARK_NUM_OF_REJECTED_CALLS 10000000
+
+
+/* ============================================== [tests] ===================================================== */
+
+TEST(RateLimiter, BurstIsLimitedToTheBucketSize)
+{
+    RateLimiter::InitRateLimiter(true, 3.0f, 0.0f);
+
+    EXPECT_TRUE(RateLimiter::ConsumeToken(FIRST_STEAM_ID));
+    EXPECT_TRUE(RateLimiter::ConsumeToken(FIRST_STEAM_ID));
+    EXPECT_TRUE(RateLimiter::ConsumeToken(FIRST_STEAM_ID));
+    EXPECT_FALSE(RateLimiter::ConsumeToken(FIRST_STEAM_ID));
+    EXPECT_FALSE(RateLimiter::ConsumeToken(FIRST_STEAM_ID));
+
+    /* other players have their own bucket */
+    EXPECT_TRUE(RateLimiter::ConsumeToken(FIRST_STEAM_ID + 1));
+}
+
+
+TEST(RateLimiter, BucketIsRefilled)
+{
+    RateLimiter::InitRateLimiter(true, 1.0f, 100.0f);
+
+    EXPECT_TRUE(RateLimiter::ConsumeToken(FIRST_STEAM_ID));
+    EXPECT_FALSE(RateLimiter::ConsumeToken(FIRST_STEAM_ID));
+
+    /* one token needs 10 ms */
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    EXPECT_TRUE(RateLimiter::ConsumeToken(FIRST_STEAM_ID));
+    EXPECT_FALSE(RateLimiter::ConsumeToken(FIRST_STEAM_ID));
+}
+
+
+TEST(RateLimiter, BucketsSurviveTheGrowthOfTheTable)
+{
+    const uint64_t numOfPlayers = 10000;
+
+    RateLimiter::InitRateLimiter(true, 2.0f, 0.0f);
+
+    for (uint64_t i = 0; i < numOfPlayers; i++)
+    {
+        EXPECT_TRUE(RateLimiter::ConsumeToken(FIRST_STEAM_ID + i));
+    }
+
+    for (uint64_t i = 0; i < numOfPlayers; i++)
+    {
+        EXPECT_TRUE(RateLimiter::ConsumeToken(FIRST_STEAM_ID + i));
+        EXPECT_FALSE(RateLimiter::ConsumeToken(FIRST_STEAM_ID + i));
+    }
+}
+
+
+TEST(RateLimiter, ClearRefillsAllBuckets)
+{
+    RateLimiter::InitRateLimiter(true, 1.0f, 0.0f);
+
+    EXPECT_TRUE(RateLimiter::ConsumeToken(FIRST_STEAM_ID));
+    EXPECT_FALSE(RateLimiter::ConsumeToken(FIRST_STEAM_ID));
+
+    RateLimiter::ClearRateLimiter();
+
+    EXPECT_TRUE(RateLimiter::ConsumeToken(FIRST_STEAM_ID));
+}
+
+
+TEST(RateLimiter, DisabledLimiterAllowsEverything)
+{
+    RateLimiter::InitRateLimiter(false, 1.0f, 0.0f);
+
+    for (int i = 0; i < 100; i++)
+    {
+        EXPECT_TRUE(RateLimiter::ConsumeToken(FIRST_STEAM_ID));
+    }
+
+    /* players without a steam id are never limited */
+    RateLimiter::InitRateLimiter(true, 1.0f, 0.0f);
+
+    EXPECT_TRUE(RateLimiter::ConsumeToken(0));
+    EXPECT_TRUE(RateLimiter::ConsumeToken(0));
+}
+
+TEST(RateLimiter, BenchmarkTenThousandCallsPerSecond)
+{
+    const auto period = std::chrono::microseconds(1000000 / BENCHMARK_CALLS_PER_SECOND);
+    const uint64_t numOfCalls = (uint64_t)BENCHMARK_CALLS_PER_SECOND * BENCHMARK_SECONDS;
+    std::chrono::nanoseconds allowedTime(0);
+    std::chrono::nanoseconds rejectedTime(0);
+    uint64_t numOfAllowed = 0;
+    uint64_t numOfRejected = 0;
+    uint64_t numOfBatchAllowed = 0;
+
+    RateLimiter::InitRateLimiter(true, BENCHMARK_BUCKET_SIZE, BENCHMARK_TOKENS_PER_SECOND);
+
+    auto start = std::chrono::steady_clock::now();
+    auto nextCall = start;
+
+    /* every player sends 10 commands per second, only the burst and the refill get through */
+    for (uint64_t i = 0; i < numOfCalls; i++)
+    {
+        while (std::chrono::steady_clock::now() < nextCall)
+        {
+        }
+        nextCall += period;
+
+        auto callStart = std::chrono::steady_clock::now();
+        bool allowed = RateLimiter::ConsumeToken(FIRST_STEAM_ID + (i % BENCHMARK_NUM_OF_PLAYERS));
+        auto callTime = std::chrono::steady_clock::now() - callStart;
+
+        if (true == allowed)
+        {
+            allowedTime += callTime;
+            numOfAllowed++;
+        }
+        else
+        {
+            rejectedTime += callTime;
+            numOfRejected++;
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    /* the per call times above include reading the clock twice, the rejected path is also timed in one batch */
+    auto batchStart = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < BENCHMARK_NUM_OF_REJECTED_CALLS; i++)
+    {
+        numOfBatchAllowed += (true == RateLimiter::ConsumeToken(FIRST_STEAM_ID + (i % BENCHMARK_NUM_OF_PLAYERS))) ? 1 : 0;
+    }
+    double batchNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - batchStart).count() / BENCHMARK_NUM_OF_REJECTED_CALLS;
+
+    double callsPerSecond = (double)numOfCalls / seconds;
+    double allowedNs = (0 < numOfAllowed) ? ((double)allowedTime.count() / (double)numOfAllowed) : 0.0;
+    double rejectedNs = (0 < numOfRejected) ? ((double)rejectedTime.count() / (double)numOfRejected) : 0.0;
+
+    std::printf("RateLimiter: %.0f calls/s over %d players\n", callsPerSecond, BENCHMARK_NUM_OF_PLAYERS);
+    std::printf("  allowed:  %8llu calls, %.0f ns per call\n", (unsigned long long)numOfAllowed, allowedNs);
+    std::printf("  rejected: %8llu calls, %.0f ns per call\n", (unsigned long long)numOfRejected, rejectedNs);
+    std::printf("  rejected in one batch: %.1f ns per call\n", batchNs);
+
+    RecordProperty("CallsPerSecond", (int)callsPerSecond);
+    RecordProperty("AllowedNsPerCall", (int)allowedNs);
+    RecordProperty("RejectedNsPerCall", (int)rejectedNs);
+    RecordProperty("RejectedBatchNsPerCall", (int)batchNs);
+
+    /* the limiter keeps up with the offered load */
+    EXPECT_GE(callsPerSecond, BENCHMARK_CALLS_PER_SECOND * 0.9);
+
+    /* no player gets more than the burst and the refill of the run */
+    double runSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_LE(numOfAllowed + numOfBatchAllowed, (uint64_t)(BENCHMARK_NUM_OF_PLAYERS * (BENCHMARK_BUCKET_SIZE + (BENCHMARK_TOKENS_PER_SECOND * runSeconds) + 1.0)));
+    EXPECT_GT(numOfRejected, numOfAllowed);
+}
+
+/* =================================================[end of file]================================================= */
@@ -0,0 +1,100 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file RejectionCacheTest.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 19 October 2026
+* \brief Tests of the memoization of rejected tribe joins
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "RejectionCache.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+
+
+/* ============================================== [tests] ===================================================== */
+
+TEST(RejectionCache, RejectionIsRemembered)
+{
+    RejectionCache::InitRejectionCache(5.0f);
+    RejectionCache::StoreJoinRejection(1, 10, 3, 0);
+
+    EXPECT_TRUE(RejectionCache::IsJoinRejected(1, 10, 3));
+    EXPECT_FALSE(RejectionCache::IsJoinRejected(1, 11, 3));
+    EXPECT_FALSE(RejectionCache::IsJoinRejected(2, 10, 3));
+
+    RejectionCache::InitRejectionCache(0.0f);
+    RejectionCache::StoreJoinRejection(1, 10, 3, 0);
+
+    EXPECT_FALSE(RejectionCache::IsJoinRejected(1, 10, 3));
+}
+
+
+TEST(RejectionCache, RejectionHoldsForTheMemberCountOnly)
+{
+    RejectionCache::InitRejectionCache(5.0f);
+    RejectionCache::StoreJoinRejection(1, 10, 3, 0);
+
+    /* a member left or joined, the join has to be evaluated again */
+    EXPECT_FALSE(RejectionCache::IsJoinRejected(1, 10, 2));
+    EXPECT_FALSE(RejectionCache::IsJoinRejected(1, 10, 4));
+    EXPECT_TRUE(RejectionCache::IsJoinRejected(1, 10, 3));
+}
+
+
+TEST(RejectionCache, RejectionEndsWithTheFirstSlotCooldown)
+{
+    RejectionCache::InitRejectionCache(5.0f);
+    RejectionCache::StoreJoinRejection(1, 10, 3, 1);
+    RejectionCache::StoreJoinRejection(2, 10, 3, 60);
+
+    EXPECT_TRUE(RejectionCache::IsJoinRejected(1, 10, 3));
+    EXPECT_TRUE(RejectionCache::IsJoinRejected(2, 10, 3));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+
+    EXPECT_FALSE(RejectionCache::IsJoinRejected(1, 10, 3));
+    EXPECT_TRUE(RejectionCache::IsJoinRejected(2, 10, 3));
+}
+
+
+TEST(RejectionCache, ChangedSlotsForgetTheRejections)
+{
+    RejectionCache::InitRejectionCache(5.0f);
+    RejectionCache::StoreJoinRejection(1, 10, 3, 0);
+    RejectionCache::StoreJoinRejection(2, 11, 3, 0);
+
+    RejectionCache::InvalidateTribe(10);
+
+    EXPECT_FALSE(RejectionCache::IsJoinRejected(1, 10, 3));
+    EXPECT_TRUE(RejectionCache::IsJoinRejected(2, 11, 3));
+
+    RejectionCache::InvalidateAll();
+
+    EXPECT_FALSE(RejectionCache::IsJoinRejected(2, 11, 3));
+}
+
+/* =================================================[end of file]================================================= */
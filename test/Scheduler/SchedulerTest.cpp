@@ -0,0 +1,128 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file SchedulerTest.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Tests of the scheduler
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "Scheduler.h"
+#include "API/ARK/Ark.h"
+#include <gtest/gtest.h>
+
+
+/* ===================================== [definition of local functions] ====================================== */
+
+/**
+* \brief Adds a task that never completes its run and counts its steps
+*
+* \param[in] Name name of the task
+* \param[in] Steps counter of the steps
+* \param[in] UseSlice true if the step uses up the whole time slice
+* \return void
+*/
+static void AddPendingTask(const std::string& Name, int* Steps, bool UseSlice)
+{
+    Scheduler::AddTask(Name, 0, [Steps, UseSlice](std::chrono::steady_clock::time_point Deadline)
+    {
+        (*Steps)++;
+
+        while ((true == UseSlice) && (std::chrono::steady_clock::now() <= Deadline))
+        {
+        }
+
+        return Scheduler::StepPending;
+    });
+}
+
+
+/* ============================================== [tests] ===================================================== */
+
+TEST(Scheduler, EveryTaskGetsOneStepPerTick)
+{
+    int steps[3] = { 0, 0, 0 };
+
+    Scheduler::InitScheduler(1000000);
+    AddPendingTask("Task0", &steps[0], false);
+    AddPendingTask("Task1", &steps[1], false);
+    AddPendingTask("Task2", &steps[2], false);
+
+    for (int tick = 1; tick <= 4; tick++)
+    {
+        ArkApiMock::Tick(0.0f);
+
+        EXPECT_EQ(tick, steps[0]);
+        EXPECT_EQ(tick, steps[1]);
+        EXPECT_EQ(tick, steps[2]);
+    }
+
+    Scheduler::RemoveScheduler();
+}
+
+
+TEST(Scheduler, TasksTakeTurnsWhenTheSliceIsUsedUp)
+{
+    int steps[3] = { 0, 0, 0 };
+
+    Scheduler::InitScheduler(100);
+    AddPendingTask("Task0", &steps[0], true);
+    AddPendingTask("Task1", &steps[1], true);
+    AddPendingTask("Task2", &steps[2], true);
+
+    for (int tick = 0; tick < 6; tick++)
+    {
+        ArkApiMock::Tick(0.0f);
+    }
+
+    EXPECT_EQ(2, steps[0]);
+    EXPECT_EQ(2, steps[1]);
+    EXPECT_EQ(2, steps[2]);
+
+    Scheduler::RemoveScheduler();
+}
+
+
+TEST(Scheduler, CompletedRunWaitsForTheInterval)
+{
+    int runs = 0;
+
+    Scheduler::InitScheduler(1000000);
+    Scheduler::AddTask("Task", 3600, [&runs](std::chrono::steady_clock::time_point)
+    {
+        runs++;
+        return Scheduler::StepDone;
+    });
+
+    ArkApiMock::Tick(0.0f);
+    ArkApiMock::Tick(0.0f);
+
+    EXPECT_EQ(1, runs);
+
+    Scheduler::RemoveScheduler();
+    EXPECT_EQ(0u, ArkApiMock::GetNumOfTickCallbacks());
+}
+
+/* =================================================[end of file]================================================= */
@@ -0,0 +1,244 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file ShardedTribeMapTest.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Tests and benchmark of the sharded tribe map
+*
+* The benchmark runs the same mix of lookups and changes on the sharded map and on a map behind a global 
+* mutex with 1 to 16 threads. The result depends on the number of cores, so it is only printed.
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "ShardedTribeMap.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+
+/* ========================================== [local defines] =============================================== */
+
+/** \brief number of different tribes of the benchmark */
+#define BENCHMARK_NUM_OF_TRIBES 65536
+
+/** \brief number of operations per thread of the benchmark */
+#define BENCHMARK_OPERATIONS_PER_THREAD 200000
+
+
+/* ============================================ [type definitions] ============================================ */
+
+/*!
+* Map behind one global mutex, the design the sharded map replaces
+*/
+class GlobalMutexTribeMap
+{
+private:
+    /*! lock of all tribes */
+    mutable std::mutex mutex;
+
+    /*! the tribes */
+    std::unordered_map<int, std::vector<int64_t>> tribes;
+
+public:
+    bool Find(int TribeId, std::vector<int64_t>* Value) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto entry = tribes.find(TribeId);
+
+        if (tribes.end() == entry)
+        {
+            return false;
+        }
+
+        *Value = entry->second;
+        return true;
+    }
+
+    void Insert(int TribeId, const std::vector<int64_t>& Value)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tribes[TribeId] = Value;
+    }
+
+    bool Erase(int TribeId)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return (0 < tribes.erase(TribeId));
+    }
+};
+
+
+/* ===================================== [definition of local functions] ====================================== */
+
+/**
+* \brief Runs the operations of the benchmark on a map
+*
+* 90% of the operations are lookups, the rest inserts and erases
+*
+* \param[in] Map the map
+* \param[in] NumOfThreads number of threads
+* \return double million operations per second of all threads
+*/
+template <typename Map_t>
+static double RunBenchmark(Map_t* Map, int NumOfThreads)
+{
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < NumOfThreads; i++)
+    {
+        threads.emplace_back([Map, i]()
+        {
+            std::mt19937 random((uint32_t)i + 1);
+            std::vector<int64_t> value;
+            const std::vector<int64_t> slots = { 1700000000, 1700000100 };
+
+            for (int operation = 0; operation < BENCHMARK_OPERATIONS_PER_THREAD; operation++)
+            {
+                int tribeId = (int)(random() % BENCHMARK_NUM_OF_TRIBES);
+                uint32_t kind = random() % 20;
+
+                if (0 == kind)
+                {
+                    Map->Insert(tribeId, slots);
+                }
+                else if (1 == kind)
+                {
+                    Map->Erase(tribeId);
+                }
+                else
+                {
+                    Map->Find(tribeId, &value);
+                }
+            }
+        });
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return (double)NumOfThreads * BENCHMARK_OPERATIONS_PER_THREAD / seconds / 1e6;
+}
+
+
+/* ============================================== [tests] ===================================================== */
+
+TEST(ShardedTribeMap, StoresTribes)
+{
+    ShardedTribeMap<std::vector<int64_t>> map(5);
+    std::vector<int64_t> slots;
+    size_t numOfTribes = 0;
+
+    for (int tribeId = -100; tribeId < 100; tribeId++)
+    {
+        map.Insert(tribeId, { tribeId });
+    }
+    map.Insert(7, { 7, 8 });
+
+    EXPECT_EQ(200u, map.Size());
+    ASSERT_TRUE(map.Find(7, &slots));
+    EXPECT_EQ(std::vector<int64_t>({ 7, 8 }), slots);
+    EXPECT_TRUE(map.Contains(-100));
+    EXPECT_FALSE(map.Contains(100));
+    EXPECT_TRUE(map.Erase(-100));
+    EXPECT_FALSE(map.Erase(-100));
+    EXPECT_EQ(199u, map.Size());
+
+    map.ForEach([&numOfTribes](int TribeId, const std::vector<int64_t>& Slots)
+    {
+        EXPECT_EQ(TribeId, Slots[0]);
+        numOfTribes++;
+    });
+    EXPECT_EQ(199u, numOfTribes);
+
+    map.Clear();
+    EXPECT_EQ(0u, map.Size());
+    EXPECT_FALSE(map.Find(7, &slots));
+}
+
+
+TEST(ShardedTribeMap, ThreadsChangeTheirOwnTribes)
+{
+    ShardedTribeMap<int> map;
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < 8; i++)
+    {
+        threads.emplace_back([&map, i]()
+        {
+            for (int round = 0; round < 1000; round++)
+            {
+                for (int tribeId = i * 100; tribeId < (i + 1) * 100; tribeId++)
+                {
+                    int value = -1;
+
+                    map.Insert(tribeId, round);
+                    EXPECT_TRUE(map.Find(tribeId, &value));
+                    EXPECT_EQ(round, value);
+
+                    if (0 == (round % 2))
+                    {
+                        EXPECT_TRUE(map.Erase(tribeId));
+                    }
+                }
+            }
+        });
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(800u, map.Size());
+}
+
+
+TEST(ShardedTribeMap, BenchmarkAgainstGlobalMutex)
+{
+    std::printf("threads  sharded [M ops/s]  global mutex [M ops/s]\n");
+
+    for (int numOfThreads = 1; numOfThreads <= 16; numOfThreads *= 2)
+    {
+        ShardedTribeMap<std::vector<int64_t>> shardedMap;
+        GlobalMutexTribeMap globalMap;
+
+        double sharded = RunBenchmark(&shardedMap, numOfThreads);
+        double global = RunBenchmark(&globalMap, numOfThreads);
+
+        std::printf("%7d  %17.2f  %22.2f\n", numOfThreads, sharded, global);
+        RecordProperty("ShardedThreads" + std::to_string(numOfThreads), (int)(sharded * 1000));
+        RecordProperty("GlobalMutexThreads" + std::to_string(numOfThreads), (int)(global * 1000));
+    }
+}
+
+/* =================================================[end of file]================================================= */
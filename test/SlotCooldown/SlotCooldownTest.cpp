@@ -0,0 +1,270 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file SlotCooldownTest.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 19 October 2026
+* \brief Tests of the slot cooldowns of removed tribe members
+*
+* The plugin runs on a virtual clock with its config and database in a temporary directory. The accesses to 
+* the database are counted with the fault hook of the database handler.
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "SlotCooldown.h"
+#include "DBHandler.h"
+#include "OutputCache.h"
+#include "TribeCache.h"
+#include "Prefetch.h"
+#include "Statistics.h"
+#include "Clock.h"
+#include "json.hpp"
+#include "API/ARK/Ark.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+/* ========================================== [local defines] =============================================== */
+
+/** \brief unix time of the virtual clock */
+#define TEST_TIME 1700000000
+
+/** \brief slot cooldown of the test config in hours */
+#define TEST_SLOT_COOLDOWN_HOURS 24
+
+/** \brief time the test waits for the prefetch thread */
+#define PREFETCH_TIMEOUT std::chrono::seconds(5)
+
+
+/* ============================================ [type definitions] ============================================ */
+
+/**
+* \brief Fixture with the plugin running on an empty database in a temporary directory
+*/
+class SlotCooldownTest : public ::testing::Test
+{
+protected:
+    std::filesystem::path directory;
+    std::filesystem::path previousDirectory;
+
+    void SetUp() override
+    {
+        directory = std::filesystem::temp_directory_path() / "SlotCooldownTest";
+        previousDirectory = std::filesystem::current_path();
+
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory / "ArkApi/Plugins/TribeSlotCooldown");
+        WriteConfig();
+        std::filesystem::current_path(directory);
+
+        Clock::SetTimeSource(&GetTestTime, nullptr);
+        SlotCooldown::InitSlotCooldown();
+        OutputCache::InvalidateAll();
+        DatabaseAccesses.clear();
+        DBHandler::SetFaultHook(&CountAccess);
+    }
+
+    void TearDown() override
+    {
+        DBHandler::SetFaultHook(nullptr);
+        Prefetch::RemovePrefetch();
+        SlotCooldown::RemoveSlotCooldown();
+        OutputCache::InvalidateAll();
+        Clock::SetTimeSource(nullptr, nullptr);
+        std::filesystem::current_path(previousDirectory);
+
+        std::error_code error;
+        std::filesystem::remove_all(directory, error);
+    }
+
+    void WriteConfig()
+    {
+        nlohmann::json config;
+
+        config["General"]["DbPathOverride"] = "";
+        config["General"]["SlotCooldown"] = TEST_SLOT_COOLDOWN_HOURS;
+        config["General"]["JoinLatencyBudgetUs"] = 0;
+        config["General"]["ExpiredCooldownsIntervalMinutes"] = 0;
+        config["Messages"]["SuppressPlayerJoinTribeMessage"] = "join";
+        config["Messages"]["SuppressMergeTribeMessage"] = "merge";
+        config["Messages"]["CommandDisplaySlotsMessage"] = "{} slots";
+        config["Messages"]["CommandDisplaySlotsMessageSlotCooldown"] = "slot {} {} {} {}";
+        config["Commands"]["CommandPrefix"] = "/";
+        config["Commands"]["CommandDisplaySlots"] = "SlotsCooldown";
+        config["RateLimit"] = nlohmann::json::object();
+        config["EventBus"] = nlohmann::json::object();
+        config["Backup"] = nlohmann::json::object();
+        config["AuditLog"] = nlohmann::json::object();
+        config["Archive"] = nlohmann::json::object();
+
+        std::ofstream(directory / "ArkApi/Plugins/TribeSlotCooldown/config.json") << config;
+    }
+
+    static int64_t GetTestTime(void)
+    {
+        return TEST_TIME;
+    }
+
+    static int CountAccess(const char* Access)
+    {
+        DatabaseAccesses.push_back(Access);
+
+        return 0;
+    }
+
+    static std::vector<std::string> DatabaseAccesses;
+};
+
+std::vector<std::string> SlotCooldownTest::DatabaseAccesses;
+
+
+/* ===================================== [definition of local functions] ====================================== */
+
+/**
+* \brief Counts the accesses of a kind
+*
+* \param[in] Accesses the accesses to the database
+* \param[in] Access name of the access
+* \return size_t number of the accesses
+*/
+static size_t CountAccesses(const std::vector<std::string>& Accesses, const std::string& Access)
+{
+    return (size_t)std::count(Accesses.begin(), Accesses.end(), Access);
+}
+
+
+/* ============================================== [tests] ===================================================== */
+
+TEST_F(SlotCooldownTest, RemovedMemberIsDisplayedInTheSameTick)
+{
+    const int64_t expiry = TEST_TIME + TEST_SLOT_COOLDOWN_HOURS * 3600;
+    FString output;
+    std::vector<int64_t> slots;
+
+    /* the display of the tribe got rendered before the removal */
+    OutputCache::StoreOutput(42, TEST_TIME, FString("0 slots"));
+
+    SlotCooldown::SetTribeSlotToCooldown(42);
+
+    /* the display misses the cache and renders again from the flushed slots */
+    EXPECT_FALSE(OutputCache::GetCachedOutput(42, TEST_TIME, &output));
+
+    SlotCooldown::FlushPendingCooldowns();
+
+    EXPECT_TRUE(TribeCache::GetTribeSlots(42, &slots));
+    EXPECT_EQ(std::vector<int64_t>({ expiry }), slots);
+}
+
+
+TEST_F(SlotCooldownTest, RemovedMemberIsCheckedBeforeTheFlush)
+{
+    int slotsOnCooldown = 0;
+    int tribeLimit = ArkApi::GetApiUtils().GetShooterGameMode()->MaxNumberOfPlayersInTribeField();
+
+    SlotCooldown::SetTribeSlotToCooldown(42);
+
+    EXPECT_TRUE(SlotCooldown::SuppressPlayerJoinTribe(42, tribeLimit - 1, &slotsOnCooldown));
+    EXPECT_EQ(1, slotsOnCooldown);
+    EXPECT_EQ(0u, CountAccesses(DatabaseAccesses, "UpdateSlotTimer"));
+}
+
+
+TEST_F(SlotCooldownTest, RemovedMembersAreWrittenOncePerTickAndTribe)
+{
+    std::vector<int64_t> slots;
+
+    /* a disbanded tribe and one member that left an other tribe */
+    SlotCooldown::SetTribeSlotToCooldown(42);
+    SlotCooldown::SetTribeSlotToCooldown(42);
+    SlotCooldown::SetTribeSlotToCooldown(42);
+    SlotCooldown::SetTribeSlotToCooldown(43);
+
+    EXPECT_TRUE(DatabaseAccesses.empty());
+
+    ArkApiMock::Tick(0.0f);
+
+    EXPECT_EQ(1u, CountAccesses(DatabaseAccesses, "BeginTransaction"));
+    EXPECT_EQ(2u, CountAccesses(DatabaseAccesses, "UpdateSlotTimer"));
+
+    /* nothing is pending on the next tick */
+    DatabaseAccesses.clear();
+    ArkApiMock::Tick(0.0f);
+
+    EXPECT_TRUE(DatabaseAccesses.empty());
+
+    DBHandler::SetFaultHook(nullptr);
+    DBHandler database((directory / "ArkApi/Plugins/TribeSlotCooldown/Slots.db").string());
+
+    EXPECT_EQ(3u, database.GetTribeSlotsTimer(42).size());
+    EXPECT_EQ(1u, database.GetTribeSlotsTimer(43).size());
+}
+
+
+TEST_F(SlotCooldownTest, PrefetchedTribeIsCountedOnceAsPrefetchHit)
+{
+    const auto timeout = std::chrono::steady_clock::now() + PREFETCH_TIMEOUT;
+    int slotsOnCooldown = 0;
+
+    SlotCooldown::SetTribeSlotToCooldown(42);
+    SlotCooldown::FlushPendingCooldowns();
+    SlotCooldown::InvalidateTribeCaches(42);
+
+    /* the tribe is read in the background like on a login or invitation */
+    Prefetch::InitPrefetch(SlotCooldown::database->GetPath(), 10);
+    Prefetch::RequestTribe(42);
+
+    while ((false == TribeCache::IsTribeResident(42)) && (std::chrono::steady_clock::now() < timeout))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        Prefetch::ApplyResults();
+    }
+
+    ASSERT_TRUE(TribeCache::IsTribeResident(42));
+
+    uint64_t prefetchHits = Statistics::Get(Statistics::PrefetchHit);
+    uint64_t prefetchMisses = Statistics::Get(Statistics::PrefetchMiss);
+    uint64_t cacheHits = Statistics::Get(Statistics::TribeCacheHit);
+
+    /* the first join is served by the prefetch */
+    EXPECT_FALSE(SlotCooldown::SuppressPlayerJoinTribe(42, 1, &slotsOnCooldown));
+    EXPECT_EQ(1, slotsOnCooldown);
+    EXPECT_EQ(prefetchHits + 1, Statistics::Get(Statistics::PrefetchHit));
+    EXPECT_EQ(cacheHits + 1, Statistics::Get(Statistics::TribeCacheHit));
+
+    /* the later joins are plain hits of the tribe cache */
+    EXPECT_FALSE(SlotCooldown::SuppressPlayerJoinTribe(42, 1, &slotsOnCooldown));
+    EXPECT_FALSE(SlotCooldown::SuppressPlayerJoinTribe(42, 1, &slotsOnCooldown));
+    EXPECT_EQ(prefetchHits + 1, Statistics::Get(Statistics::PrefetchHit));
+    EXPECT_EQ(prefetchMisses, Statistics::Get(Statistics::PrefetchMiss));
+    EXPECT_EQ(cacheHits + 3, Statistics::Get(Statistics::TribeCacheHit));
+}
+
+
+/* =================================================[end of file]================================================= */
@@ -0,0 +1,367 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file SnapshotTest.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 19 October 2026
+* \brief Tests and benchmark of the tribe snapshots
+*
+* The snapshots are written and validated like the plugin does it. The benchmarks compare the startup with 
+* a snapshot, where only the ids of the tribes changed afterwards are read from the database, with a full 
+* scan of the database, and the restore of the tribe cache from the handoff file with reading every tribe 
+* again.
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "SnapshotFormat.h"
+#include "DBHandler.h"
+#include "TribeTable.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+
+/* ========================================== [local defines] =============================================== */
+
+/** \brief number of tribes of the benchmark */
+#define BENCHMARK_NUM_OF_TRIBES 100000
+
+/** \brief number of tribes of the benchmark changed after the snapshot */
+#define BENCHMARK_NUM_OF_CHANGED_TRIBES 1000
+
+
+/* ============================================ [type definitions] ============================================ */
+
+using namespace Snapshot;
+
+
+/**
+* \brief Fixture with an empty database and snapshot file
+*/
+class SnapshotTest : public ::testing::Test
+{
+protected:
+    std::string path;
+    std::filesystem::path snapshotFile;
+
+    void SetUp() override
+    {
+        path = (std::filesystem::temp_directory_path() / "SnapshotTest.db").string();
+        snapshotFile = std::filesystem::temp_directory_path() / "SnapshotTest.snapshot";
+        RemoveFiles();
+    }
+
+    void TearDown() override
+    {
+        RemoveFiles();
+    }
+
+    void RemoveFiles()
+    {
+        std::error_code error;
+
+        std::filesystem::remove(path, error);
+        std::filesystem::remove(path + "-wal", error);
+        std::filesystem::remove(path + "-shm", error);
+        std::filesystem::remove(snapshotFile, error);
+    }
+};
+
+
+/* ===================================== [definition of local functions] ====================================== */
+
+/**
+* \brief Creates a snapshot like the plugin writes it
+*
+* \param[in] Sequence the change sequence of the tribes
+* \param[in] Tribes the tribes sorted by id
+* \param[in] Pool the slot cooldowns the tribes point into
+* \return std::vector<char> the snapshot
+*/
+static std::vector<char> CreateSnapshot(const ChangeSequence_t& Sequence, const std::vector<SnapshotTribe_t>& Tribes, 
+    const std::vector<int64_t>& Pool)
+{
+    SnapshotHeader_t header = {};
+    std::vector<char> snapshot;
+
+    header.magic = SNAPSHOT_MAGIC;
+    header.version = SNAPSHOT_VERSION;
+    header.numOfTribes = (uint32_t)Tribes.size();
+    header.databaseId = Sequence.databaseId;
+    header.sequence = Sequence.sequence;
+    header.poolSize = (uint32_t)Pool.size();
+    header.checksum = UpdateChecksum(GetHeaderChecksum(header), Tribes.data(), Tribes.size() * sizeof(SnapshotTribe_t));
+    header.checksum = UpdateChecksum(header.checksum, Pool.data(), Pool.size() * sizeof(int64_t));
+
+    snapshot.resize(GetSnapshotSize(header));
+    std::memcpy(snapshot.data(), &header, sizeof(header));
+    std::memcpy(snapshot.data() + sizeof(header), Tribes.data(), Tribes.size() * sizeof(SnapshotTribe_t));
+    std::memcpy(snapshot.data() + sizeof(header) + (Tribes.size() * sizeof(SnapshotTribe_t)), Pool.data(), Pool.size() * sizeof(int64_t));
+
+    return snapshot;
+}
+
+
+/**
+* \brief Validates a snapshot like the plugin does it
+*
+* \param[in] Snapshot the snapshot
+* \return bool true if the snapshot is complete and the checksum matches
+*/
+static bool IsSnapshotValid(const std::vector<char>& Snapshot)
+{
+    SnapshotHeader_t header;
+
+    if (sizeof(header) > Snapshot.size())
+    {
+        return false;
+    }
+
+    std::memcpy(&header, Snapshot.data(), sizeof(header));
+
+    return (SNAPSHOT_MAGIC == header.magic) && (SNAPSHOT_VERSION == header.version) && (GetSnapshotSize(header) == Snapshot.size()) &&
+        (header.checksum == UpdateChecksum(GetHeaderChecksum(header), Snapshot.data() + sizeof(header), Snapshot.size() - sizeof(header)));
+}
+
+
+/**
+* \brief Fills the database with tribes on cooldown
+*
+* \param[in] Path path of the database
+* \param[in] NumOfTribes number of tribes, the ids start with 1
+* \return void
+*/
+static void FillDatabase(const std::string& Path, int NumOfTribes)
+{
+    sqlite::database database(Path);
+
+    database << "BEGIN;";
+    for (int tribeId = 1; tribeId <= NumOfTribes; tribeId++)
+    {
+        database << "INSERT INTO TribeSlots (TribeId, SlotsTimer, SlotsExpiry, LastExpiry) VALUES (?, x'', ?, ?);"
+            << tribeId << std::vector<int64_t>(3, 1800000000 + tribeId) << 1800000000 + tribeId;
+    }
+    database << "COMMIT;";
+}
+
+
+/* ============================================== [tests] ===================================================== */
+
+TEST_F(SnapshotTest, ChecksumCoversHeaderEntriesAndPool)
+{
+    const std::vector<SnapshotTribe_t> tribes = { { 1, 0, 2, SNAPSHOT_TRIBE_IN_DATABASE, 0 }, { 5, 2, 1, SNAPSHOT_TRIBE_IN_DATABASE, 0 } };
+    const std::vector<int64_t> pool = { 1800000000, 1800000100, 1800000200 };
+    const std::vector<char> snapshot = CreateSnapshot({ 7, 42, 0 }, tribes, pool);
+    std::vector<char> corrupted;
+
+    EXPECT_TRUE(IsSnapshotValid(snapshot));
+
+    /* a snapshot of an other database or sequence must not be taken for the current one */
+    corrupted = snapshot;
+    corrupted[offsetof(SnapshotHeader_t, databaseId)] ^= 1;
+    EXPECT_FALSE(IsSnapshotValid(corrupted));
+
+    corrupted = snapshot;
+    corrupted[offsetof(SnapshotHeader_t, sequence)] ^= 1;
+    EXPECT_FALSE(IsSnapshotValid(corrupted));
+
+    corrupted = snapshot;
+    corrupted[sizeof(SnapshotHeader_t) + offsetof(SnapshotTribe_t, tribeId)] ^= 1;
+    EXPECT_FALSE(IsSnapshotValid(corrupted));
+
+    corrupted = snapshot;
+    corrupted.back() ^= 1;
+    EXPECT_FALSE(IsSnapshotValid(corrupted));
+}
+
+
+TEST_F(SnapshotTest, BenchmarkStartupAgainstFullScan)
+{
+    DBHandler database(path);
+    ChangeSequence_t sequence;
+    std::vector<SnapshotTribe_t> tribes;
+    std::vector<int64_t> pool;
+
+    FillDatabase(path, BENCHMARK_NUM_OF_TRIBES);
+
+    /* the snapshot is taken from all tribes, afterwards some of them change */
+    ASSERT_TRUE(database.GetChangeSequence(&sequence));
+    ASSERT_TRUE(database.ForEachTribe([&](int TribeId, const std::vector<int64_t>& Slots)
+    {
+        tribes.push_back({ TribeId, (uint32_t)pool.size(), (uint16_t)Slots.size(), SNAPSHOT_TRIBE_IN_DATABASE, 0 });
+        pool.insert(pool.end(), Slots.begin(), Slots.end());
+    }));
+
+    {
+        const std::vector<char> snapshot = CreateSnapshot(sequence, tribes, pool);
+        std::ofstream stream(snapshotFile, std::ios::binary | std::ios::trunc);
+
+        stream.write(snapshot.data(), snapshot.size());
+    }
+
+    for (int tribeId = 1; tribeId <= BENCHMARK_NUM_OF_CHANGED_TRIBES; tribeId++)
+    {
+        ASSERT_TRUE(database.UpdateSlotTimer(tribeId * 7, { 1900000000 }));
+    }
+
+    /* startup with a full scan of the database */
+    auto start = std::chrono::steady_clock::now();
+    std::unordered_map<int, std::vector<int64_t>> scannedTribes;
+
+    ASSERT_TRUE(database.ForEachTribe([&](int TribeId, const std::vector<int64_t>& Slots) { scannedTribes.emplace(TribeId, Slots); }));
+
+    double scanMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    /* startup with the snapshot, only the ids of the changed tribes are read */
+    start = std::chrono::steady_clock::now();
+    std::vector<char> snapshot((size_t)std::filesystem::file_size(snapshotFile));
+    std::unordered_set<int> changedTribes;
+    SnapshotHeader_t header;
+
+    std::ifstream(snapshotFile, std::ios::binary).read(snapshot.data(), snapshot.size());
+    ASSERT_TRUE(IsSnapshotValid(snapshot));
+    std::memcpy(&header, snapshot.data(), sizeof(header));
+    ASSERT_TRUE(database.ForEachChangedTribe(header.sequence, [&](int TribeId) { changedTribes.insert(TribeId); }));
+
+    double snapshotMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    EXPECT_EQ((size_t)BENCHMARK_NUM_OF_TRIBES, scannedTribes.size());
+    EXPECT_EQ((uint32_t)BENCHMARK_NUM_OF_TRIBES, header.numOfTribes);
+    EXPECT_EQ((size_t)BENCHMARK_NUM_OF_CHANGED_TRIBES, changedTribes.size());
+    EXPECT_EQ(1u, changedTribes.count(7));
+
+    std::printf("tribes  full scan [ms]  snapshot [ms]\n");
+    std::printf("%6d  %14.1f  %13.1f\n", BENCHMARK_NUM_OF_TRIBES, scanMs, snapshotMs);
+    RecordProperty("FullScanMicroseconds", (int)(scanMs * 1000));
+    RecordProperty("SnapshotMicroseconds", (int)(snapshotMs * 1000));
+}
+
+
+TEST_F(SnapshotTest, BenchmarkHandoffAgainstColdCache)
+{
+    DBHandler database(path);
+    ChangeSequence_t sequence;
+    TribeTable cache;
+    TribeTable restoredCache;
+    TribeTable coldCache;
+    std::vector<int64_t> slots;
+
+    FillDatabase(path, BENCHMARK_NUM_OF_TRIBES);
+
+    cache.Init(BENCHMARK_NUM_OF_TRIBES);
+    restoredCache.Init(BENCHMARK_NUM_OF_TRIBES);
+    coldCache.Init(BENCHMARK_NUM_OF_TRIBES);
+
+    ASSERT_TRUE(database.GetChangeSequence(&sequence));
+    ASSERT_TRUE(database.ForEachTribe([&](int TribeId, const std::vector<int64_t>& Slots) { cache.Insert(TribeId, true, Slots, false); }));
+
+    /* unload, the cache is written to the handoff file */
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::vector<SnapshotTribe_t> tribes;
+        std::vector<int64_t> pool;
+
+        for (size_t i = 0; i < cache.Capacity(); i++)
+        {
+            int tribeId = 0;
+            bool isInDatabase = false;
+
+            if (true == cache.GetAt(i, &tribeId, &isInDatabase, &slots))
+            {
+                tribes.push_back({ tribeId, (uint32_t)pool.size(), (uint16_t)slots.size(), 
+                    (uint16_t)((true == isInDatabase) ? SNAPSHOT_TRIBE_IN_DATABASE : 0), 0 });
+                pool.insert(pool.end(), slots.begin(), slots.end());
+            }
+        }
+
+        std::sort(tribes.begin(), tribes.end(), [](const SnapshotTribe_t& a, const SnapshotTribe_t& b) { return a.tribeId < b.tribeId; });
+
+        const std::vector<char> snapshot = CreateSnapshot(sequence, tribes, pool);
+        std::ofstream stream(snapshotFile, std::ios::binary | std::ios::trunc);
+
+        stream.write(snapshot.data(), snapshot.size());
+    }
+    double saveMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    /* an other server changes some tribes while the plugin is unloaded */
+    for (int tribeId = 1; tribeId <= BENCHMARK_NUM_OF_CHANGED_TRIBES; tribeId++)
+    {
+        ASSERT_TRUE(database.UpdateSlotTimer(tribeId * 7, { 1900000000 }));
+    }
+
+    /* load, the cache is restored without the changed tribes */
+    start = std::chrono::steady_clock::now();
+    {
+        std::vector<char> snapshot((size_t)std::filesystem::file_size(snapshotFile));
+        std::vector<int> changedTribes;
+        SnapshotHeader_t header;
+
+        std::ifstream(snapshotFile, std::ios::binary).read(snapshot.data(), snapshot.size());
+        ASSERT_TRUE(IsSnapshotValid(snapshot));
+        std::memcpy(&header, snapshot.data(), sizeof(header));
+        ASSERT_TRUE(database.ForEachChangedTribe(header.sequence, [&](int TribeId) { changedTribes.push_back(TribeId); }));
+        std::sort(changedTribes.begin(), changedTribes.end());
+
+        const SnapshotTribe_t* tribes = reinterpret_cast<const SnapshotTribe_t*>(snapshot.data() + sizeof(header));
+        const int64_t* pool = reinterpret_cast<const int64_t*>(tribes + header.numOfTribes);
+
+        for (uint32_t i = 0; i < header.numOfTribes; i++)
+        {
+            if (false == std::binary_search(changedTribes.begin(), changedTribes.end(), tribes[i].tribeId))
+            {
+                restoredCache.Insert(tribes[i].tribeId, (0 != (tribes[i].flags & SNAPSHOT_TRIBE_IN_DATABASE)),
+                    std::vector<int64_t>(pool + tribes[i].offset, pool + tribes[i].offset + tribes[i].numOfSlots), false);
+            }
+        }
+    }
+    double loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    /* without the handoff every tribe is read again on its first lookup */
+    start = std::chrono::steady_clock::now();
+    for (int tribeId = 1; tribeId <= BENCHMARK_NUM_OF_TRIBES; tribeId++)
+    {
+        ASSERT_EQ(ReadFound, database.ReadTribe(tribeId, &slots));
+        coldCache.Insert(tribeId, true, slots, false);
+    }
+    double coldMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    EXPECT_EQ((size_t)(BENCHMARK_NUM_OF_TRIBES - BENCHMARK_NUM_OF_CHANGED_TRIBES), restoredCache.Size());
+    EXPECT_FALSE(restoredCache.Contains(7));
+    EXPECT_TRUE(restoredCache.Contains(8));
+    EXPECT_EQ((size_t)BENCHMARK_NUM_OF_TRIBES, coldCache.Size());
+
+    std::printf("tribes  save handoff [ms]  load handoff [ms]  cold cache [ms]\n");
+    std::printf("%6d  %17.1f  %17.1f  %15.1f\n", BENCHMARK_NUM_OF_TRIBES, saveMs, loadMs, coldMs);
+    RecordProperty("SaveHandoffMicroseconds", (int)(saveMs * 1000));
+    RecordProperty("LoadHandoffMicroseconds", (int)(loadMs * 1000));
+    RecordProperty("ColdCacheMicroseconds", (int)(coldMs * 1000));
+}
+
+/* =================================================[end of file]================================================= */
@@ -0,0 +1,310 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file TribeTableTest.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Tests and benchmark of the flat hash table of the tribe cache
+*
+* The benchmark compares the table with the std::unordered_map it replaced, the memory of the map is counted 
+* by its allocator.
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "TribeTable.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <unordered_map>
+
+
+/* ========================================== [local defines] =============================================== */
+
+/** \brief number of tribes of the benchmark */
+#define BENCHMARK_NUM_OF_TRIBES 1000000
+
+/** \brief number of lookups of the benchmark */
+#define BENCHMARK_NUM_OF_LOOKUPS 10000000
+
+
+/* ============================================ [type definitions] ============================================ */
+
+/** \brief allocated bytes of the counting allocator */
+static size_t AllocatedBytes = 0;
+
+
+/**
+*  \brief allocator that counts the allocated bytes
+*/
+template<typename T>
+struct CountingAllocator
+{
+    typedef T value_type;
+
+    CountingAllocator() = default;
+    template<typename U> CountingAllocator(const CountingAllocator<U>&) {}
+
+    T* allocate(size_t Count)
+    {
+        AllocatedBytes += Count * sizeof(T);
+        return std::allocator<T>().allocate(Count);
+    }
+
+    void deallocate(T* Pointer, size_t Count)
+    {
+        AllocatedBytes -= Count * sizeof(T);
+        std::allocator<T>().deallocate(Pointer, Count);
+    }
+
+    template<typename U> bool operator==(const CountingAllocator<U>&) const { return true; }
+    template<typename U> bool operator!=(const CountingAllocator<U>&) const { return false; }
+};
+
+
+/**
+*  \brief entry of the map the table replaced
+*/
+typedef struct
+{
+    bool isInDatabase;
+    std::vector<int64_t, CountingAllocator<int64_t>> slots;
+
+}MapEntry_t;
+
+
+typedef std::unordered_map<int, MapEntry_t, std::hash<int>, std::equal_to<int>, CountingAllocator<std::pair<const int, MapEntry_t>>> Map_t;
+
+
+/* ===================================== [definition of local functions] ====================================== */
+
+/**
+* \brief Creates the slots of a tribe, most tribes have no or few slots on cooldown
+*
+* Some cooldowns are beyond 2038 or beyond the unsigned 32 bit unix time
+*
+* \param[in] Random the random generator
+* \return std::vector<int64_t> the slots
+*/
+static std::vector<int64_t> CreateSlots(std::mt19937& Random)
+{
+    std::vector<int64_t> slots((Random() % 8 == 0) ? (Random() % 12) : (Random() % 3));
+
+    for (int64_t& slot : slots)
+    {
+        int64_t base = (0 != Random() % 16) ? 1700000000LL : ((0 == Random() % 2) ? 2200000000LL : 5000000000LL);
+
+        slot = base + (int64_t)(Random() % 100000);
+    }
+
+    return slots;
+}
+
+
+/* ============================================== [tests] ===================================================== */
+
+TEST(TribeTable, BehavesLikeAMap)
+{
+    std::mt19937 random(0x54524942);
+    std::unordered_map<int, std::pair<bool, std::vector<int64_t>>> reference;
+    TribeTable table;
+    bool isInDatabase;
+    std::vector<int64_t> slots;
+
+    table.Init(1000);
+
+    for (int i = 0; i < 200000; i++)
+    {
+        int tribeId = (int)(random() % 1000);
+
+        switch (random() % 4)
+        {
+        case 0:
+        case 1:
+        {
+            std::vector<int64_t> newSlots = CreateSlots(random);
+            bool newIsInDatabase = (0 == random() % 2);
+
+            ASSERT_TRUE(table.Insert(tribeId, newIsInDatabase, newSlots, false));
+            reference[tribeId] = { newIsInDatabase, newSlots };
+            break;
+        }
+        case 2:
+            ASSERT_EQ(0 < reference.erase(tribeId), table.Erase(tribeId));
+            break;
+        default:
+            ASSERT_EQ(0 < reference.count(tribeId), table.Find(tribeId, &isInDatabase, &slots));
+            if (0 < reference.count(tribeId))
+            {
+                ASSERT_EQ(reference[tribeId].first, isInDatabase);
+                ASSERT_EQ(reference[tribeId].second, slots);
+            }
+            break;
+        }
+
+        ASSERT_EQ(reference.size(), table.Size());
+    }
+
+    size_t numOfTribes = 0;
+    int tribeId;
+
+    for (size_t i = 0; i < table.Capacity(); i++)
+    {
+        if (true == table.GetAt(i, &tribeId, &isInDatabase, &slots))
+        {
+            ASSERT_EQ(reference[tribeId].second, slots);
+            numOfTribes++;
+        }
+    }
+
+    EXPECT_EQ(reference.size(), numOfTribes);
+
+    table.Clear();
+    EXPECT_EQ(0u, table.Size());
+    EXPECT_FALSE(table.Contains(tribeId));
+}
+
+
+TEST(TribeTable, FullTableRejectsNewTribes)
+{
+    TribeTable table;
+    int tribeId = 1;
+
+    table.Init(100);
+
+    while (true == table.Insert(tribeId, false, {}, false))
+    {
+        tribeId++;
+    }
+
+    EXPECT_LE(100u, table.Size());
+    EXPECT_GT(table.Capacity(), table.Size());
+
+    /* known tribes can still be replaced */
+    EXPECT_TRUE(table.Insert(1, true, { 1700000000 }, false));
+    EXPECT_TRUE(table.Erase(2));
+    EXPECT_TRUE(table.Insert(tribeId, false, {}, false));
+}
+
+
+TEST(TribeTable, PrefetchMarkIsClearedOnce)
+{
+    TribeTable table;
+    bool isInDatabase = false;
+    bool isPrefetched = false;
+    std::vector<int64_t> slots;
+
+    table.Init(100);
+    table.Insert(1, true, { 1700000000 }, true);
+    table.Insert(2, true, { 1700000000 }, false);
+
+    ASSERT_TRUE(table.Find(1, &isInDatabase, &slots, &isPrefetched));
+    EXPECT_TRUE(isPrefetched);
+
+    EXPECT_TRUE(table.ClearPrefetched(1));
+    EXPECT_FALSE(table.ClearPrefetched(1));
+    EXPECT_FALSE(table.ClearPrefetched(2));
+    EXPECT_FALSE(table.ClearPrefetched(3));
+
+    /* the record itself is kept */
+    ASSERT_TRUE(table.Find(1, &isInDatabase, &slots, &isPrefetched));
+    EXPECT_FALSE(isPrefetched);
+    EXPECT_TRUE(isInDatabase);
+    EXPECT_EQ(std::vector<int64_t>({ 1700000000 }), slots);
+}
+
+
+TEST(TribeTable, BenchmarkAgainstUnorderedMap)
+{
+    std::mt19937 random(0x42454E43);
+    std::vector<int> tribeIds(BENCHMARK_NUM_OF_TRIBES);
+    std::vector<int> lookupIds(BENCHMARK_NUM_OF_LOOKUPS);
+    TribeTable table;
+    Map_t map;
+    size_t hits = 0;
+    bool isInDatabase;
+    std::vector<int64_t> slots;
+
+    for (int& tribeId : tribeIds)
+    {
+        tribeId = (int)(random() & 0x7FFFFFFF);
+    }
+
+    /* half of the lookups miss, like the lookups of tribes without cooldowns */
+    for (int& lookupId : lookupIds)
+    {
+        lookupId = (0 == random() % 2) ? tribeIds[random() % tribeIds.size()] : (int)(random() & 0x7FFFFFFF);
+    }
+
+    table.Init(BENCHMARK_NUM_OF_TRIBES);
+    map.reserve(BENCHMARK_NUM_OF_TRIBES);
+
+    for (int tribeId : tribeIds)
+    {
+        std::vector<int64_t> tribeSlots = CreateSlots(random);
+
+        table.Insert(tribeId, true, tribeSlots, false);
+        map[tribeId] = { true, std::vector<int64_t, CountingAllocator<int64_t>>(tribeSlots.begin(), tribeSlots.end()) };
+    }
+
+    ASSERT_EQ(map.size(), table.Size());
+
+    auto start = std::chrono::steady_clock::now();
+    for (int lookupId : lookupIds)
+    {
+        hits += (true == table.Find(lookupId, &isInDatabase, &slots)) ? 1 : 0;
+    }
+    double tableSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (int lookupId : lookupIds)
+    {
+        auto entry = map.find(lookupId);
+
+        if (map.end() != entry)
+        {
+            slots.assign(entry->second.slots.begin(), entry->second.slots.end());
+            hits--;
+        }
+    }
+    double mapSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    /* both found the same tribes */
+    EXPECT_EQ(0u, hits);
+
+    double tableBytesPerTribe = (double)table.GetMemoryUsage() / (double)table.Size();
+    double mapBytesPerTribe = (double)AllocatedBytes / (double)map.size();
+
+    std::printf("TribeTable:         %.1f M lookups/s, %.1f bytes per tribe\n", BENCHMARK_NUM_OF_LOOKUPS / tableSeconds / 1e6, tableBytesPerTribe);
+    std::printf("std::unordered_map: %.1f M lookups/s, %.1f bytes per tribe\n", BENCHMARK_NUM_OF_LOOKUPS / mapSeconds / 1e6, mapBytesPerTribe);
+
+    RecordProperty("TableLookupsPerSecond", (int)(BENCHMARK_NUM_OF_LOOKUPS / tableSeconds));
+    RecordProperty("TableBytesPerTribe", (int)tableBytesPerTribe);
+    RecordProperty("MapLookupsPerSecond", (int)(BENCHMARK_NUM_OF_LOOKUPS / mapSeconds));
+    RecordProperty("MapBytesPerTribe", (int)mapBytesPerTribe);
+
+    EXPECT_LT(tableBytesPerTribe, mapBytesPerTribe);
+}
+
+/* =================================================[end of file]================================================= */
@@ -0,0 +1,172 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file TribeViewTest.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Tests of the lock free view of the cached tribes
+*
+* The stress test runs readers against a writer that keeps replacing and removing the records. Build the 
+* tests with -DTSAN=ON to run it under the thread sanitizer.
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "TribeView.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <random>
+#include <thread>
+
+
+/* ========================================== [local defines] =============================================== */
+
+/** \brief number of tribes of the stress test */
+#define STRESS_NUM_OF_TRIBES 256
+
+/** \brief number of reading threads of the stress test */
+#define STRESS_NUM_OF_READERS 8
+
+/** \brief number of changes of the writer of the stress test */
+#define STRESS_NUM_OF_CHANGES 200000
+
+
+/* ============================================== [tests] ===================================================== */
+
+TEST(TribeView, PublishedTribesAreRead)
+{
+    bool isInDatabase = false;
+    std::vector<int64_t> slots;
+
+    TribeView::InitTribeView(16);
+
+    TribeView::Publish(1, true, { 1700000000, 1700000100 });
+    TribeView::Publish(2, false, {});
+
+    ASSERT_TRUE(TribeView::ReadTribe(1, &isInDatabase, &slots));
+    EXPECT_TRUE(isInDatabase);
+    EXPECT_EQ(std::vector<int64_t>({ 1700000000, 1700000100 }), slots);
+    ASSERT_TRUE(TribeView::ReadTribe(2, &isInDatabase, &slots));
+    EXPECT_FALSE(isInDatabase);
+    EXPECT_TRUE(slots.empty());
+    EXPECT_FALSE(TribeView::ContainsTribe(3));
+
+    TribeView::Publish(1, true, { 1700000200 });
+    ASSERT_TRUE(TribeView::ReadTribe(1, &isInDatabase, &slots));
+    EXPECT_EQ(std::vector<int64_t>({ 1700000200 }), slots);
+
+    TribeView::Retract(1);
+    EXPECT_FALSE(TribeView::ContainsTribe(1));
+    EXPECT_TRUE(TribeView::ContainsTribe(2));
+
+    TribeView::RetractAll();
+    EXPECT_FALSE(TribeView::ContainsTribe(2));
+
+    TribeView::RemoveTribeView();
+
+    /* a removed view is empty, changes are ignored */
+    TribeView::Publish(1, true, { 1700000000 });
+    EXPECT_FALSE(TribeView::ReadTribe(1, &isInDatabase, &slots));
+}
+
+
+TEST(TribeView, ReadersSeeConsistentRecordsWhileTheWriterChangesThem)
+{
+    std::atomic<bool> isWriting(true);
+    std::atomic<uint64_t> numOfReads(0);
+    std::vector<std::thread> readers;
+
+    TribeView::InitTribeView(STRESS_NUM_OF_TRIBES);
+
+    for (int i = 0; i < STRESS_NUM_OF_READERS; i++)
+    {
+        readers.emplace_back([&isWriting, &numOfReads, i]()
+        {
+            std::mt19937 random((uint32_t)i + 1);
+            std::vector<int64_t> lastVersion(STRESS_NUM_OF_TRIBES, 0);
+            std::vector<int64_t> slots;
+            bool isInDatabase;
+            uint64_t reads = 0;
+
+            while (true == isWriting)
+            {
+                int tribeId = (int)(random() % STRESS_NUM_OF_TRIBES);
+
+                if (true == TribeView::ReadTribe(tribeId, &isInDatabase, &slots))
+                {
+                    /* every slot holds the version of the record, the number of slots and the flag follow from it */
+                    ASSERT_FALSE(slots.empty());
+                    ASSERT_EQ((size_t)(slots[0] % 5) + 1, slots.size());
+                    ASSERT_EQ(0 == (slots[0] % 2), isInDatabase);
+                    for (int64_t slot : slots)
+                    {
+                        ASSERT_EQ(slots[0], slot);
+                    }
+
+                    /* the records of a tribe are published with ascending versions */
+                    ASSERT_LE(lastVersion[tribeId], slots[0]);
+                    lastVersion[tribeId] = slots[0];
+                }
+
+                reads++;
+            }
+
+            numOfReads += reads;
+        });
+    }
+
+    std::mt19937 random(0x57524954);
+
+    for (int version = 1; version <= STRESS_NUM_OF_CHANGES; version++)
+    {
+        int tribeId = (int)(random() % STRESS_NUM_OF_TRIBES);
+
+        switch (random() % 64)
+        {
+        case 0:
+            TribeView::RetractAll();
+            break;
+        case 1:
+        case 2:
+        case 3:
+            TribeView::Retract(tribeId);
+            break;
+        default:
+            TribeView::Publish(tribeId, (0 == (version % 2)), std::vector<int64_t>((size_t)(version % 5) + 1, version));
+            break;
+        }
+    }
+
+    isWriting = false;
+
+    for (std::thread& reader : readers)
+    {
+        reader.join();
+    }
+
+    EXPECT_LT(0u, numOfReads.load());
+
+    TribeView::RemoveTribeView();
+}
+
+/* =================================================[end of file]================================================= */
@@ -0,0 +1,323 @@
+/*****************************************************************************************************************
+* Copyright (C) 2019 by Matthias Birnthaler                                                                      *
+*                                                                                                                *
+* This file is part of the TribeSlotCooldown Plugin for Ark Server API                                           *
+*                                                                                                                *
+*    This program is free software : you can redistribute it and/or modify                                       *
+*    it under the terms of the GNU General Public License as published by                                        *
+*    the Free Software Foundation, either version 3 of the License, or                                           *
+*    (at your option) any later version.                                                                         *
+*                                                                                                                *
+*    This program is distributed in the hope that it will be useful,                                             *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                                              *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the                                                 *
+*    GNU General Public License for more details.                                                                *
+*                                                                                                                *
+*    You should have received a copy of the GNU General Public License                                           *
+*    along with this program.If not, see <https://www.gnu.org/licenses/>.                                        *
+*                                                                                                                *
+*****************************************************************************************************************/
+
+/**
+* \file AuditReader.cpp
+* \author Matthias Birnthaler Matthias-Birnthaler@outlook.com
+* \date 18 October 2026
+* \brief Offline reader of the audit log
+*
+* Usage: AuditReader <directory> [-tribe <tribeId>] [-player <steamId>] [-from <unixTime>] [-to <unixTime>]
+*
+* The segments and the records within a segment are in ascending time order. The first relevant record
+* is found by a binary search over the segment names and then over the records of the first segment.
+*
+*/
+
+
+/* =================================================[includes]================================================= */
+
+#include "AuditRecord.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <limits>
+#include <vector>
+
+
+/* ============================================ [type definitions] ============================================ */
+
+/**
+*  \brief filter of the records
+*/
+typedef struct
+{
+    bool filterTribe;       /**< \brief true if only records of tribeId are shown */
+    int32_t tribeId;        /**< \brief shown tribe */
+    bool filterPlayer;      /**< \brief true if only records of steamId are shown */
+    uint64_t steamId;       /**< \brief shown player */
+    int64_t from;           /**< \brief first shown time in milliseconds since epoch */
+    int64_t to;             /**< \brief last shown time in milliseconds since epoch */
+
+}Filter_t;
+
+
+/**
+*  \brief segment file
+*/
+typedef struct
+{
+    int64_t firstRecordTime;        /**< \brief time of the first record */
+    std::filesystem::path path;     /**< \brief path of the segment */
+
+}Segment_t;
+
+
+/* ===================================== [prototype of local functions] ======================================= */
+
+static bool ParseArguments(int argc, char* argv[], std::filesystem::path* Directory, Filter_t* Filter);
+static std::vector<Segment_t> GetSegments(const std::filesystem::path& Directory);
+static void PrintRecord(const AuditLog::AuditRecord_t& Record);
+static bool IsRecordShown(const AuditLog::AuditRecord_t& Record, const Filter_t& Filter);
+static bool ReadSegment(const Segment_t& Segment, const Filter_t& Filter, bool SearchFirst);
+
+
+/* ===================================== [definition of local functions] ====================================== */
+
+/**
+* \brief Parses the command line arguments
+*
+* \param[in] argc number of arguments
+* \param[in] argv the arguments
+* \param[out] Directory directory of the audit log
+* \param[out] Filter the filter
+* \return bool true if the arguments are valid
+*/
+static bool ParseArguments(int argc, char* argv[], std::filesystem::path* Directory, Filter_t* Filter)
+{
+    Filter->filterTribe = false;
+    Filter->tribeId = 0;
+    Filter->filterPlayer = false;
+    Filter->steamId = 0;
+    Filter->from = (std::numeric_limits<int64_t>::min)();
+    Filter->to = (std::numeric_limits<int64_t>::max)();
+
+    if (2 > argc)
+    {
+        return false;
+    }
+
+    *Directory = std::filesystem::u8path(argv[1]);
+
+    for (int i = 2; i < argc; i += 2)
+    {
+        if (i + 1 >= argc)
+        {
+            return false;
+        }
+
+        if (0 == std::strcmp(argv[i], "-tribe"))
+        {
+            Filter->filterTribe = true;
+            Filter->tribeId = (int32_t)std::strtol(argv[i + 1], nullptr, 10);
+        }
+        else if (0 == std::strcmp(argv[i], "-player"))
+        {
+            Filter->filterPlayer = true;
+            Filter->steamId = std::strtoull(argv[i + 1], nullptr, 10);
+        }
+        else if (0 == std::strcmp(argv[i], "-from"))
+        {
+            Filter->from = std::strtoll(argv[i + 1], nullptr, 10) * 1000;
+        }
+        else if (0 == std::strcmp(argv[i], "-to"))
+        {
+            Filter->to = (std::strtoll(argv[i + 1], nullptr, 10) * 1000) + 999;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/**
+* \brief Gets the segments of the audit log
+*
+* \param[in] Directory directory of the audit log
+* \return std::vector<Segment_t> the segments in ascending time order
+*/
+static std::vector<Segment_t> GetSegments(const std::filesystem::path& Directory)
+{
+    std::vector<Segment_t> segments;
+    std::error_code error;
+    int64_t firstRecordTime;
+
+    for (const auto& entry : std::filesystem::directory_iterator(Directory, error))
+    {
+        if (true == AuditLog::ParseSegmentName(entry.path().filename().u8string(), &firstRecordTime))
+        {
+            segments.push_back({ firstRecordTime, entry.path() });
+        }
+    }
+
+    std::sort(segments.begin(), segments.end(), [](const Segment_t& a, const Segment_t& b)
+    {
+        return a.firstRecordTime < b.firstRecordTime;
+    });
+
+    return segments;
+}
+
+
+/**
+* \brief Prints a record
+*
+* \param[in] Record the record
+* \return void
+*/
+static void PrintRecord(const AuditLog::AuditRecord_t& Record)
+{
+    char timeString[32] = { 0 };
+    std::time_t seconds = (std::time_t)(Record.time / 1000);
+
+    std::strftime(timeString, sizeof(timeString), "%Y-%m-%dT%H:%M:%S", std::gmtime(&seconds));
+
+    std::printf("%s.%03dZ %-6s %-18s player=%" PRIu64 " tribe=%d otherTribe=%d players=%u slotsOnCooldown=%u\n",
+        timeString, (int)(Record.time % 1000), AuditLog::GetTypeName(Record.type), AuditLog::GetDecisionName(Record.decision), 
+        Record.steamId, Record.tribeId, Record.otherTribeId, (unsigned)Record.playersInTribe, (unsigned)Record.slotsOnCooldown);
+}
+
+
+/**
+* \brief Checks if a record matches the filter
+*
+* \param[in] Record the record
+* \param[in] Filter the filter
+* \return bool true if the record is shown
+*/
+static bool IsRecordShown(const AuditLog::AuditRecord_t& Record, const Filter_t& Filter)
+{
+    if ((true == Filter.filterTribe) && (Filter.tribeId != Record.tribeId) && (Filter.tribeId != Record.otherTribeId))
+    {
+        return false;
+    }
+
+    if ((true == Filter.filterPlayer) && (Filter.steamId != Record.steamId))
+    {
+        return false;
+    }
+
+    return true;
+}
+
+
+/**
+* \brief Prints the matching records of a segment
+*
+* \param[in] Segment the segment
+* \param[in] Filter the filter
+* \param[in] SearchFirst true if the first record is searched, otherwise the segment is read from the start
+* \return bool false if a record newer than the filter was found and no further segment has to be read
+*/
+static bool ReadSegment(const Segment_t& Segment, const Filter_t& Filter, bool SearchFirst)
+{
+    bool result = true;
+    AuditLog::AuditSegmentHeader_t header;
+    AuditLog::AuditRecord_t record;
+    std::error_code error;
+    long long numOfRecords;
+    long long index = 0;
+    std::FILE* file = std::fopen(Segment.path.u8string().c_str(), "rb");
+
+    if (nullptr == file)
+    {
+        std::fprintf(stderr, "could not open %s\n", Segment.path.u8string().c_str());
+        return result;
+    }
+
+    if ((1 != std::fread(&header, sizeof(header), 1, file)) || (AUDIT_SEGMENT_MAGIC != header.magic) || 
+        (AUDIT_SEGMENT_VERSION != header.version) || (sizeof(AuditLog::AuditRecord_t) != header.recordSize))
+    {
+        std::fprintf(stderr, "skipped %s, unknown format\n", Segment.path.u8string().c_str());
+        std::fclose(file);
+        return result;
+    }
+
+    numOfRecords = (long long)((std::filesystem::file_size(Segment.path, error) - sizeof(header)) / sizeof(AuditLog::AuditRecord_t));
+
+    if (true == SearchFirst)
+    {
+        index = AuditLog::FindFirstRecord(file, numOfRecords, Filter.from);
+    }
+
+    for (; (index < numOfRecords) && (true == AuditLog::ReadRecord(file, index, &record)); index++)
+    {
+        if (record.time > Filter.to)
+        {
+            result = false;
+            break;
+        }
+
+        if ((record.time >= Filter.from) && (true == IsRecordShown(record, Filter)))
+        {
+            PrintRecord(record);
+        }
+    }
+
+    std::fclose(file);
+
+    return result;
+}
+
+
+/* ===================================== [definition of global functions] ===================================== */
+
+/**
+* \brief Entry point of the audit log reader
+*
+* \param[in] argc number of arguments
+* \param[in] argv the arguments
+* \return int 0 on success
+*/
+int main(int argc, char* argv[])
+{
+    std::filesystem::path directory;
+    Filter_t filter;
+    std::vector<Segment_t> segments;
+    size_t first;
+
+    if (false == ParseArguments(argc, argv, &directory, &filter))
+    {
+        std::fprintf(stderr, "usage: AuditReader <directory> [-tribe <tribeId>] [-player <steamId>] [-from <unixTime>] [-to <unixTime>]\n");
+        return 1;
+    }
+
+    segments = GetSegments(directory);
+
+    /* records of the time filter.from can be at the end of the segment before the first one starting at that time */
+    first = (size_t)(std::lower_bound(segments.begin(), segments.end(), filter.from, [](const Segment_t& Segment, int64_t From)
+    {
+        return Segment.firstRecordTime < From;
+    }) - segments.begin());
+
+    if (0 < first)
+    {
+        first--;
+    }
+
+    for (size_t i = first; i < segments.size(); i++)
+    {
+        if (false == ReadSegment(segments[i], filter, (i == first)))
+        {
+            break;
+        }
+    }
+
+    return 0;
+}
+
+/* =================================================[end of file]================================================= */